@@ -0,0 +1,814 @@
+#include "stdafx.h"
+#include "Benchmarks.h"
+#include "YshMath.h"
+#include "PhysicsScene.h"
+#include "PhysicsInstrumentation.h"
+#include "RigidBody.h"
+#include "Box.h"
+#include "GeometryLibrary.h"
+#include "Mesh.h"
+#include "QuickHull.h"
+#include "TriangleMesh.h"
+#include "HeightField.h"
+#include "Compound.h"
+#include "ConvexDecomposition.h"
+#include "ThreadPool.h"
+#include "Ray.h"
+#include "ContactSolver.h"
+
+namespace
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+#define BENCHMARK_N_ELEMENTS 1024
+#define BENCHMARK_N_REPEATS 4096
+
+#define BENCHMARK_PHYSICS_DT (1.0 / 60.0)
+#define BENCHMARK_PHYSICS_N_STEPS 300
+
+	// Prevent the optimizer from discarding the results of a benchmark loop
+	volatile double g_sink;
+
+	template <class T>
+	double Consume(const Vec3_t<T>& v) { return (double)(v.x + v.y + v.z); }
+	template <class T>
+	double Consume(const Vec3A_t<T>& v) { return (double)(v.x + v.y + v.z); }
+	template <class T>
+	double Consume(const Vec4_t<T>& v) { return (double)(v.x + v.y + v.z + v.w); }
+	template <class T>
+	double Consume(const Quat_t<T>& q) { return (double)(q.x + q.y + q.z + q.w); }
+	template <class T>
+	double Consume(const Mat33_t<T>& M) { return (double)(M(0, 0) + M(1, 1) + M(2, 2)); }
+	template <class T>
+	double Consume(const Mat44_t<T>& M) { return (double)(M(0, 0) + M(1, 1) + M(2, 2) + M(3, 3)); }
+	double Consume(double x) { return x; }
+	double Consume(float x) { return (double)x; }
+
+	template <class T>
+	T RandomScalar()
+	{
+		return T(std::rand()) / T(RAND_MAX) * T(2.0) - T(1.0);
+	}
+
+	template <class T>
+	Vec3_t<T> RandomVec3()
+	{
+		return Vec3_t<T>(RandomScalar<T>(), RandomScalar<T>(), RandomScalar<T>());
+	}
+
+	template <class T>
+	Quat_t<T> RandomQuat()
+	{
+		Vec3_t<T> axis = RandomVec3<T>();
+		axis = axis.Scale(T(1.0) / sqrt(axis.Dot(axis) + T(1e-6)));
+		return Quat_t<T>(axis, RandomScalar<T>() * T(3.0));
+	}
+
+	template <class T>
+	Mat44_t<T> RandomMat44()
+	{
+		Mat44_t<T> M;
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int j = 0; j < 4; ++j)
+			{
+				M(i, j) = RandomScalar<T>();
+			}
+		}
+		return M;
+	}
+
+	// Times op(a[i], b[i]) over the input arrays and reports the average cost of a single call
+	template <class A, class B, class Op>
+	void Run(const char* name, const A* a, const B* b, Op op)
+	{
+		double acc = 0.0;
+		const Clock::time_point t0 = Clock::now();
+		for (int r = 0; r < BENCHMARK_N_REPEATS; ++r)
+		{
+			for (int i = 0; i < BENCHMARK_N_ELEMENTS; ++i)
+			{
+				acc += Consume(op(a[i], b[i]));
+			}
+		}
+		const Clock::time_point t1 = Clock::now();
+		g_sink = acc;
+
+		const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+		printf("  %-28s %8.3f ns/op\n", name, ns / double(BENCHMARK_N_ELEMENTS * BENCHMARK_N_REPEATS));
+	}
+
+	template <class T>
+	void RunSuite(const char* label)
+	{
+		std::vector<Vec3_t<T>> u(BENCHMARK_N_ELEMENTS), v(BENCHMARK_N_ELEMENTS);
+		std::vector<Quat_t<T>> p(BENCHMARK_N_ELEMENTS), q(BENCHMARK_N_ELEMENTS);
+		std::vector<Mat33_t<T>> A(BENCHMARK_N_ELEMENTS), B(BENCHMARK_N_ELEMENTS);
+		std::vector<Mat44_t<T>> C(BENCHMARK_N_ELEMENTS), D(BENCHMARK_N_ELEMENTS);
+		std::vector<Vec4_t<T>> w(BENCHMARK_N_ELEMENTS);
+		std::vector<Vec3A_t<T>> ua(BENCHMARK_N_ELEMENTS), va(BENCHMARK_N_ELEMENTS);
+
+		for (int i = 0; i < BENCHMARK_N_ELEMENTS; ++i)
+		{
+			u[i] = RandomVec3<T>();
+			v[i] = RandomVec3<T>();
+			p[i] = RandomQuat<T>();
+			q[i] = RandomQuat<T>();
+			A[i] = Mat33_t<T>(p[i]);
+			B[i] = Mat33_t<T>(q[i]);
+			C[i] = RandomMat44<T>();
+			D[i] = RandomMat44<T>();
+			w[i] = Vec4_t<T>(u[i]);
+			ua[i] = Vec3A_t<T>(u[i]);
+			va[i] = Vec3A_t<T>(v[i]);
+		}
+
+		printf("%s (sizeof Vec3 %d, Quat %d, Mat33 %d, Mat44 %d)\n", label,
+			(int)sizeof(Vec3_t<T>), (int)sizeof(Quat_t<T>), (int)sizeof(Mat33_t<T>), (int)sizeof(Mat44_t<T>));
+
+		Run("Vec3 +", u.data(), v.data(), [](const Vec3_t<T>& a, const Vec3_t<T>& b) { return a + b; });
+		Run("Vec3 Dot", u.data(), v.data(), [](const Vec3_t<T>& a, const Vec3_t<T>& b) { return a.Dot(b); });
+		Run("Vec3 Cross", u.data(), v.data(), [](const Vec3_t<T>& a, const Vec3_t<T>& b) { return a.Cross(b); });
+		Run("Vec3 copy (array)", u.data(), v.data(), [](const Vec3_t<T>& a, const Vec3_t<T>&) { Vec3_t<T> c[4] = { a, a, a, a }; return c[3]; });
+		Run("Vec3A +", ua.data(), va.data(), [](const Vec3A_t<T>& a, const Vec3A_t<T>& b) { return a + b; });
+		Run("Vec3A Dot", ua.data(), va.data(), [](const Vec3A_t<T>& a, const Vec3A_t<T>& b) { return a.Dot(b); });
+		Run("Vec3A Cross", ua.data(), va.data(), [](const Vec3A_t<T>& a, const Vec3A_t<T>& b) { return a.Cross(b); });
+		Run("Vec4 Dot", w.data(), w.data(), [](const Vec4_t<T>& a, const Vec4_t<T>& b) { return a.Dot(b); });
+		Run("Quat *", p.data(), q.data(), [](const Quat_t<T>& a, const Quat_t<T>& b) { return a * b; });
+		Run("Quat Transform", p.data(), v.data(), [](const Quat_t<T>& a, const Vec3_t<T>& b) { return a.Transform(b); });
+		Run("Quat -> Mat33", p.data(), v.data(), [](const Quat_t<T>& a, const Vec3_t<T>&) { return Mat33_t<T>(a); });
+		Run("Mat33 *", A.data(), B.data(), [](const Mat33_t<T>& a, const Mat33_t<T>& b) { return a * b; });
+		Run("Mat33 Transform", A.data(), v.data(), [](const Mat33_t<T>& a, const Vec3_t<T>& b) { return a.Transform(b); });
+		Run("Mat33 Inverse", A.data(), v.data(), [](const Mat33_t<T>& a, const Vec3_t<T>&) { return a.Inverse(); });
+		Run("Mat44 *", C.data(), D.data(), [](const Mat44_t<T>& a, const Mat44_t<T>& b) { return a * b; });
+		Run("Rigid transform (T*R)", p.data(), u.data(), [](const Quat_t<T>& a, const Vec3_t<T>& b)
+		{
+			return HomogeneousTransformation_t<T>::CreateTranslation(b) * HomogeneousTransformation_t<T>::CreateRotation(a);
+		});
+		Run("Rigid transform (direct)", p.data(), u.data(), [](const Quat_t<T>& a, const Vec3_t<T>& b)
+		{
+			return HomogeneousTransformation_t<T>::CreateRigidTransform(a, b);
+		});
+		Run("Mat44 Transform", C.data(), w.data(), [](const Mat44_t<T>& a, const Vec4_t<T>& b) { return a.Transform(b); });
+	}
+}
+
+namespace
+{
+	class SolverTimer : public PhysicsInstrumentation
+	{
+	public:
+		SolverTimer() : solveTime(0.0), nIslands(0), nIterations(0), maxContacts(0) {}
+
+		void OnIslandSolved(int nContacts, const MathUtils::GaussSeidelStats& stats, double time) override
+		{
+			solveTime += time;
+			nIslands++;
+			nIterations += stats.iterations;
+			maxContacts = std::max(maxContacts, nContacts);
+		}
+
+		double solveTime;
+		int nIslands;
+		int nIterations;
+		int maxContacts;
+	};
+
+	dMat33 BoxInertia(const dVec3& halfDim, double m)
+	{
+		dMat33 I = dMat33::Identity();
+		I(0, 0) = m*(halfDim.y*halfDim.y + halfDim.z*halfDim.z) / 3.0;
+		I(1, 1) = m*(halfDim.z*halfDim.z + halfDim.x*halfDim.x) / 3.0;
+		I(2, 2) = m*(halfDim.x*halfDim.x + halfDim.y*halfDim.y) / 3.0;
+		return I;
+	}
+
+	// A scene of boxes that owns its bodies and geometries. The bodies are freed along with the scene,
+	// which doesn't touch them when it's destroyed. Boxes of the same size share their geometry.
+	class BoxScene
+	{
+	public:
+		~BoxScene()
+		{
+			for (int i = 0; i < (int)m_bodies.size(); ++i)
+			{
+				delete m_bodies[i];
+			}
+			// The compounds reference the library's boxes, so they go first
+			for (int i = 0; i < (int)m_compounds.size(); ++i)
+			{
+				delete m_compounds[i];
+			}
+		}
+
+		void AddBox(const dVec3& halfDim, double m, const dVec3& pos)
+		{
+			AddBody(m_geometries.GetBox(halfDim.x, halfDim.y, halfDim.z), m, BoxInertia(halfDim, m), pos);
+		}
+
+		// A slab of nX x nY boxes side by side (each of mass m), either as a single Compound body or as separate boxes
+		void AddSlab(const dVec3& halfDim, int nX, int nY, double m, const dVec3& pos, bool compound)
+		{
+			std::vector<Compound::Child> children;
+			for (int i = 0; i < nX; ++i)
+			{
+				for (int j = 0; j < nY; ++j)
+				{
+					Compound::Child child;
+					child.geom = m_geometries.GetBox(halfDim.x, halfDim.y, halfDim.z);
+					child.pos = dVec3(halfDim.x*(double)(2 * i - nX + 1), halfDim.y*(double)(2 * j - nY + 1), 0.0);
+					child.rot = dQuat::Identity();
+					children.push_back(child);
+				}
+			}
+
+			if (!compound)
+			{
+				// Leave a gap between the boxes, so they don't start out in contact
+				for (const Compound::Child& child : children)
+				{
+					AddBox(halfDim, m, pos + child.pos.Scale(1.005));
+				}
+				return;
+			}
+
+			Compound* geom = new Compound;
+			geom->Create(children.data(), (int)children.size());
+			m_compounds.push_back(geom);
+
+			// The inertia of the boxes about the center of the slab (parallel axis theorem)
+			dMat33 I = BoxInertia(halfDim, m).Scale((double)children.size());
+			for (const Compound::Child& child : children)
+			{
+				const dVec3& r = child.pos;
+				for (int a = 0; a < 3; ++a)
+				{
+					for (int b = 0; b < 3; ++b)
+					{
+						I(a, b) += m*((a == b ? r.Dot(r) : 0.0) - r[a] * r[b]);
+					}
+				}
+			}
+			AddBody(geom, m*(double)children.size(), I, pos);
+		}
+
+		void SetIntegratorConfig(const IntegratorConfig& config)
+		{
+			m_scene.SetIntegratorConfig(config);
+		}
+
+		void Run(const char* name)
+		{
+			SolverTimer timer;
+			m_scene.SetInstrumentation(&timer);
+
+			const Clock::time_point t0 = Clock::now();
+			for (int i = 0; i < BENCHMARK_PHYSICS_N_STEPS; ++i)
+			{
+				m_scene.Step(BENCHMARK_PHYSICS_DT);
+			}
+			const Clock::time_point t1 = Clock::now();
+			m_scene.SetInstrumentation(nullptr);
+
+			const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+			printf("  %-14s %4d bodies, %5d contacts: step %8.3f ms, contact solve %8.3f ms, %5.2f iterations\n", name,
+				(int)m_bodies.size(), timer.maxContacts,
+				ms / double(BENCHMARK_PHYSICS_N_STEPS),
+				timer.solveTime * 1000.0 / double(BENCHMARK_PHYSICS_N_STEPS),
+				timer.nIslands > 0 ? (double)timer.nIterations / (double)timer.nIslands : 0.0);
+		}
+
+	private:
+		void AddBody(const Geometry* geom, double m, const dMat33& I, const dVec3& pos)
+		{
+			RigidBody* body = new RigidBody;
+			body->SetGeometry(geom, dVec3(0.0, 0.0, 0.0), dQuat::Identity());
+			body->SetMass(m);
+			body->SetInertia(I);
+			body->SetPosition(pos);
+
+			m_scene.AddPhysicsObject(body);
+			m_bodies.push_back(body);
+		}
+
+		PhysicsScene m_scene;
+		std::vector<RigidBody*> m_bodies;
+		GeometryLibrary m_geometries;
+		std::vector<Compound*> m_compounds;
+	};
+
+	// Steps boxes in free flight (no gravity, no contacts), tumbling about an axis near their intermediate principal axis.
+	// Reports the cost of stepping a body and the drift of the kinetic energy and angular momentum magnitude over the run,
+	// which both should only decay at the rate set by RigidBody::Damp.
+	void RunIntegrator(const char* name, const IntegratorConfig& config)
+	{
+		const dVec3 halfDim(0.25, 0.5, 1.0);
+		const double m = 1.0;
+
+		Box geom;
+		geom.SetDimensions(halfDim.x, halfDim.y, halfDim.z);
+
+		dMat33 Ib = dMat33::Identity();
+		Ib(0, 0) = m*(halfDim.y*halfDim.y + halfDim.z*halfDim.z) / 3.0;
+		Ib(1, 1) = m*(halfDim.z*halfDim.z + halfDim.x*halfDim.x) / 3.0;
+		Ib(2, 2) = m*(halfDim.x*halfDim.x + halfDim.y*halfDim.y) / 3.0;
+
+		std::vector<RigidBody> bodies(BENCHMARK_N_ELEMENTS);
+		for (RigidBody& body : bodies)
+		{
+			body.SetGeometry(&geom, dVec3(0.0, 0.0, 0.0), dQuat::Identity());
+			body.SetMass(m);
+			body.SetInertia(Ib);
+			body.ApplyAngImpulse(Ib.Transform(dVec3(0.1, 4.0, 0.1)));
+		}
+
+		auto Measure = [&Ib](const RigidBody& body, double& energy, double& momentum)
+		{
+			const dVec3 wb = (-body.GetRotation()).Transform(body.GetAngularVelocity());
+			const dVec3 Lb = Ib.Transform(wb);
+			energy = 0.5*wb.Dot(Lb);
+			momentum = sqrt(Lb.Dot(Lb));
+		};
+
+		// An empty step applies the initial impulse
+		for (RigidBody& body : bodies)
+		{
+			body.Step(0.0);
+		}
+		double energy0, momentum0;
+		Measure(bodies[0], energy0, momentum0);
+
+		const Clock::time_point t0 = Clock::now();
+		for (int s = 0; s < BENCHMARK_PHYSICS_N_STEPS; ++s)
+		{
+			for (RigidBody& body : bodies)
+			{
+				if (config.integrator == INTEGRATOR_SEMI_IMPLICIT_EULER)
+				{
+					body.StepSemiImplicitEuler(BENCHMARK_PHYSICS_DT, config.gyroscopic);
+				}
+				else
+				{
+					body.Step(BENCHMARK_PHYSICS_DT);
+				}
+			}
+		}
+		const Clock::time_point t1 = Clock::now();
+
+		double energy1, momentum1;
+		Measure(bodies[0], energy1, momentum1);
+
+		// Damp scales both momenta by this factor over the run
+		const double damping = pow(0.8, BENCHMARK_PHYSICS_DT*(double)BENCHMARK_PHYSICS_N_STEPS);
+
+		const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+		printf("  %-22s %8.1f ns/body step, energy drift %+9.5f%%, momentum drift %+9.5f%%\n", name,
+			ns / double(BENCHMARK_N_ELEMENTS * BENCHMARK_PHYSICS_N_STEPS),
+			100.0*(energy1 / (energy0*damping*damping) - 1.0),
+			100.0*(momentum1 / (momentum0*damping) - 1.0));
+	}
+
+	// Times the support function of the hull of nPoints random points on an ellipsoid
+	void RunSupport(int nPoints)
+	{
+		std::vector<fVec3> points(nPoints);
+		for (int i = 0; i < nPoints; ++i)
+		{
+			fVec3 p = RandomVec3<float>();
+			p = p.Scale(1.0f / sqrt(p.Dot(p) + 1e-6f));
+			points[i] = fVec3(2.0f*p.x, p.y, 0.5f*p.z);
+		}
+		const Mesh mesh(points.data(), nPoints);
+
+		std::vector<dVec3> v(BENCHMARK_N_ELEMENTS);
+		for (int i = 0; i < BENCHMARK_N_ELEMENTS; ++i)
+		{
+			v[i] = RandomVec3<double>();
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "Mesh support (%d points)", nPoints);
+		Run(name, v.data(), v.data(), [&mesh](const dVec3& a, const dVec3&) { return mesh.SupportLocal(a); });
+	}
+
+	// Times the phases of building the hull of the points, and exporting it to a Mesh
+	void RunQuickHull(const char* name, const std::vector<fVec3>& points, double slack)
+	{
+		const int nRepeats = 4;
+		QuickHull::Stats stats = {};
+		double export_ = 0.0;
+		int nFaces = 0;
+		for (int r = 0; r < nRepeats; ++r)
+		{
+			QuickHull qh(points.data(), (int)points.size(), slack);
+			qh.BuildHull();
+			const Clock::time_point t0 = Clock::now();
+			Mesh mesh;
+			qh.ExportConvexMesh(mesh);
+			const Clock::time_point t1 = Clock::now();
+
+			stats.iterations += qh.GetStats().iterations;
+			stats.droppedPoints += qh.GetStats().droppedPoints;
+			stats.initMilliseconds += qh.GetStats().initMilliseconds;
+			stats.carveMilliseconds += qh.GetStats().carveMilliseconds;
+			stats.patchMilliseconds += qh.GetStats().patchMilliseconds;
+			export_ += 1e-6*(double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+			nFaces = mesh.GetFaces().GetNumFaces();
+		}
+		g_sink = (double)nFaces;
+
+		const double scale = 1.0 / (double)nRepeats;
+		printf("  %-28s %8.3f ms init, %8.3f ms carve, %8.3f ms patch, %8.3f ms export (%d iterations, %d dropped, %d faces)\n", name,
+			stats.initMilliseconds*scale, stats.carveMilliseconds*scale, stats.patchMilliseconds*scale, export_*scale,
+			stats.iterations / nRepeats, stats.droppedPoints / nRepeats, nFaces);
+	}
+
+	// nPoints random points in a ball (or on its surface)
+	void RunQuickHull(int nPoints, bool surface)
+	{
+		std::vector<fVec3> points;
+		points.reserve(nPoints);
+		while ((int)points.size() < nPoints)
+		{
+			fVec3 p = RandomVec3<float>();
+			const float r2 = p.Dot(p);
+			if (r2 <= 1.0f && r2 > 0.0001f)
+			{
+				points.push_back(surface ? p.Scale(1.0f / sqrt(r2)) : p);
+			}
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "%d points %s", nPoints, surface ? "on a sphere" : "in a ball");
+		RunQuickHull(name, points, 0.0001);
+	}
+
+	// Rings of points around a cylinder. Every ring is coplanar, and so is every column of points along its side.
+	void RunQuickHullCylinder(int nSegments, int nRings, double slack)
+	{
+		std::vector<fVec3> points;
+		for (int i = 0; i < nRings; ++i)
+		{
+			for (int j = 0; j < nSegments; ++j)
+			{
+				const float theta = 2.0f*fPI*(float)j / (float)nSegments;
+				points.push_back(fVec3(std::cos(theta), std::sin(theta), -1.0f + 2.0f*(float)i / (float)(nRings - 1)));
+			}
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "%dx%d cylinder, slack %g", nSegments, nRings, slack);
+		RunQuickHull(name, points, slack);
+	}
+
+	// A cubic lattice: the points on each of its sides are coplanar, and the ones along each of its edges collinear
+	void RunQuickHullLattice(int n)
+	{
+		std::vector<fVec3> points;
+		for (int i = 0; i < n*n*n; ++i)
+		{
+			points.push_back(fVec3((float)(i % n), (float)((i / n) % n), (float)(i / (n*n))).Scale(1.0f / (float)n));
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "%d^3 lattice", n);
+		RunQuickHull(name, points, 0.0);
+	}
+
+	// Compares building a Mesh (with its mass properties) from nPoints random points in a ball, to loading it cooked
+	void RunCooking(int nPoints)
+	{
+		std::vector<fVec3> points;
+		points.reserve(nPoints);
+		while ((int)points.size() < nPoints)
+		{
+			const fVec3 p = RandomVec3<float>();
+			if (p.Dot(p) <= 1.0f)
+			{
+				points.push_back(p);
+			}
+		}
+
+		const char* fileName = "yshphys_benchmark.hull";
+
+		const Clock::time_point t0 = Clock::now();
+		Mesh built(points.data(), nPoints);
+		built.ShiftToCenterOfMass_Solid();
+		const Clock::time_point t1 = Clock::now();
+		if (!built.WriteCooked(fileName))
+		{
+			printf("  could not write %s\n", fileName);
+			return;
+		}
+		const Clock::time_point t2 = Clock::now();
+		Mesh loaded;
+		const bool ok = loaded.LoadCooked(fileName);
+		double mass;
+		loaded.InertiaLocal_Solid(1.0, mass);
+		const Clock::time_point t3 = Clock::now();
+		g_sink = mass;
+		std::remove(fileName);
+
+		char name[64];
+		snprintf(name, sizeof(name), "%d points", nPoints);
+		printf("  %-28s %8.3f ms build, %8.3f ms load%s\n", name,
+			1e-6*(double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count(),
+			1e-6*(double)std::chrono::duration_cast<std::chrono::nanoseconds>(t3 - t2).count(),
+			ok ? "" : " (failed)");
+	}
+
+	// Decomposes a torus (48 x 24 quads, R = 1, r = 0.35) with the given resolution and concavity tolerance, on all cores.
+	// Reports the cost of each stage, the size of the hulls, how far their total volume is off the mesh's, and the
+	// cost of a support query against all of them.
+	void RunConvexDecomposition(int resolution, double maxConcavity)
+	{
+		const int nU = 48;
+		const int nV = 24;
+		std::vector<fVec3> verts;
+		std::vector<int> indices;
+		for (int i = 0; i < nU; ++i)
+		{
+			const float u = 2.0f*fPI*(float)i / (float)nU;
+			for (int j = 0; j < nV; ++j)
+			{
+				const float v = 2.0f*fPI*(float)j / (float)nV;
+				const float r = 1.0f + 0.35f*std::cos(v);
+				verts.push_back(fVec3(r*std::cos(u), r*std::sin(u), 0.35f*std::sin(v)));
+
+				const int a = i*nV + j;
+				const int b = ((i + 1) % nU)*nV + j;
+				const int c = ((i + 1) % nU)*nV + (j + 1) % nV;
+				const int d = i*nV + (j + 1) % nV;
+				const int quad[6] = { a, b, c, a, c, d };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+		const int nTriangles = (int)indices.size() / 3;
+
+		double meshVolume = 0.0;
+		for (int i = 0; i < nTriangles; ++i)
+		{
+			const dVec3 a(verts[indices[3 * i]]);
+			const dVec3 b(verts[indices[3 * i + 1]]);
+			const dVec3 c(verts[indices[3 * i + 2]]);
+			meshVolume += a.Dot(b.Cross(c)) / 6.0;
+		}
+
+		ThreadPool threadPool(std::max(0, (int)std::thread::hardware_concurrency() - 1));
+		ConvexDecomposition decomposition;
+		ConvexDecomposition::Config config = ConvexDecomposition::DefaultConfig();
+		config.resolution = resolution;
+		config.maxConcavity = maxConcavity;
+		decomposition.Decompose(verts.data(), (int)verts.size(), indices.data(), nTriangles, config, &threadPool);
+
+		const ConvexDecomposition::Report& report = decomposition.GetReport();
+		char name[64];
+		snprintf(name, sizeof(name), "%d voxels, %.0f%% concavity", resolution, 100.0*maxConcavity);
+		printf("  %-28s %8.3f ms voxelize, %8.3f ms split, %8.3f ms hulls: %2d hulls, %4d verts, %6.1f KB, volume %+6.1f%%, %7.1f ns/support\n", name,
+			report.voxelizeMilliseconds, report.splitMilliseconds, report.hullMilliseconds,
+			report.nHulls, report.nHullVerts, (double)report.hullBytes / 1024.0,
+			100.0*(report.hullVolume / std::abs(meshVolume) - 1.0), report.supportNanoseconds);
+	}
+
+	// Builds a TriangleMesh of rolling terrain over an nCells x nCells grid (2 triangles per cell, 1 unit apart),
+	// then times box queries (a unit cube at random) and rays cast straight down at random
+	void RunTriangleMesh(int nCells)
+	{
+		std::vector<fVec3> verts;
+		std::vector<int> indices;
+		verts.reserve((nCells + 1)*(nCells + 1));
+		indices.reserve(6 * nCells*nCells);
+		for (int i = 0; i <= nCells; ++i)
+		{
+			for (int j = 0; j <= nCells; ++j)
+			{
+				verts.push_back(fVec3((float)i, (float)j, std::sin(0.3f*(float)i)*std::cos(0.2f*(float)j)));
+			}
+		}
+		for (int i = 0; i < nCells; ++i)
+		{
+			for (int j = 0; j < nCells; ++j)
+			{
+				const int a = i*(nCells + 1) + j;
+				const int b = a + nCells + 1;
+				const int cell[6] = { a, b, b + 1, a, b + 1, a + 1 };
+				indices.insert(indices.end(), cell, cell + 6);
+			}
+		}
+
+		const Clock::time_point t0 = Clock::now();
+		TriangleMesh mesh;
+		mesh.Create(verts.data(), (int)verts.size(), indices.data(), nCells*nCells * 2);
+		const Clock::time_point t1 = Clock::now();
+
+		std::vector<dVec3> samples(BENCHMARK_N_ELEMENTS);
+		for (dVec3& x : samples)
+		{
+			x = (RandomVec3<double>() + dVec3(1.0, 1.0, 1.0)).Scale(0.5*(double)nCells);
+			x.z = 0.0;
+		}
+
+		std::vector<int> triangles;
+		size_t nFound = 0;
+		const Clock::time_point t2 = Clock::now();
+		for (const dVec3& x : samples)
+		{
+			BoundingBox box;
+			box.min = x - dVec3(0.5, 0.5, 0.5);
+			box.max = x + dVec3(0.5, 0.5, 0.5);
+			triangles.clear();
+			mesh.QueryTriangles(box, triangles);
+			nFound += triangles.size();
+		}
+		const Clock::time_point t3 = Clock::now();
+
+		int nHits = 0;
+		Ray ray;
+		ray.SetDirection(dVec3(0.0, 0.0, -1.0));
+		for (const dVec3& x : samples)
+		{
+			ray.SetOrigin(dVec3(x.x, x.y, 2.0));
+			dVec3 hit;
+			if (mesh.RayIntersect(dVec3(0.0, 0.0, 0.0), dQuat::Identity(), ray, hit))
+			{
+				nHits++;
+				g_sink = hit.z;
+			}
+		}
+		const Clock::time_point t4 = Clock::now();
+
+		const double n = (double)samples.size();
+		char name[64];
+		snprintf(name, sizeof(name), "%d triangles", mesh.GetNTriangles());
+		printf("  %-28s %8.3f ms build, %8.1f ns/query (%.1f triangles), %8.1f ns/ray (%d hits)\n", name,
+			1e-6*(double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count(),
+			(double)std::chrono::duration_cast<std::chrono::nanoseconds>(t3 - t2).count() / n, (double)nFound / n,
+			(double)std::chrono::duration_cast<std::chrono::nanoseconds>(t4 - t3).count() / n, nHits);
+	}
+
+	// The same rolling terrain as RunTriangleMesh as a HeightField of nSamples x nSamples, with the triangles under a unit
+	// cube found at random, and rays cast at random across it at a shallow angle (so that they walk many cells)
+	void RunHeightField(int nSamples)
+	{
+		std::vector<float> heights(nSamples*nSamples);
+		for (int j = 0; j < nSamples; ++j)
+		{
+			for (int i = 0; i < nSamples; ++i)
+			{
+				heights[j*nSamples + i] = std::sin(0.3f*(float)i)*std::cos(0.2f*(float)j);
+			}
+		}
+
+		const Clock::time_point t0 = Clock::now();
+		HeightField terrain;
+		terrain.Create(heights.data(), nSamples, nSamples, 1.0, 1.0);
+		const Clock::time_point t1 = Clock::now();
+
+		const double halfSize = 0.5*(double)(nSamples - 1);
+		std::vector<dVec3> samples(BENCHMARK_N_ELEMENTS);
+		for (dVec3& x : samples)
+		{
+			x = RandomVec3<double>().Scale(halfSize);
+			x.z = 0.0;
+		}
+
+		int nFound = 0;
+		const Clock::time_point t2 = Clock::now();
+		for (const dVec3& x : samples)
+		{
+			BoundingBox box;
+			box.min = x - dVec3(0.5, 0.5, 0.5);
+			box.max = x + dVec3(0.5, 0.5, 0.5);
+			terrain.ForEachPart(box, [&](int iPart, const Geometry* part, const dVec3& pos, const dQuat& rot) { nFound++; });
+		}
+		const Clock::time_point t3 = Clock::now();
+
+		int nHits = 0;
+		Ray ray;
+		for (const dVec3& x : samples)
+		{
+			ray.SetOrigin(dVec3(x.x, x.y, 2.0));
+			ray.SetDirection(dVec3(-x.y, x.x, -0.05*halfSize));
+			dVec3 hit;
+			if (terrain.RayIntersect(dVec3(0.0, 0.0, 0.0), dQuat::Identity(), ray, hit))
+			{
+				nHits++;
+				g_sink = hit.z;
+			}
+		}
+		const Clock::time_point t4 = Clock::now();
+
+		const double n = (double)samples.size();
+		char name[64];
+		snprintf(name, sizeof(name), "%d x %d (%.1f MB)", nSamples, nSamples, (double)(nSamples*nSamples * sizeof(unsigned short)) / (1024.0*1024.0));
+		printf("  %-28s %8.3f ms build, %8.1f ns/query (%.1f triangles), %8.1f ns/ray (%d hits)\n", name,
+			1e-6*(double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count(),
+			(double)std::chrono::duration_cast<std::chrono::nanoseconds>(t3 - t2).count() / n, (double)nFound / n,
+			(double)std::chrono::duration_cast<std::chrono::nanoseconds>(t4 - t3).count() / n, nHits);
+	}
+}
+
+void Benchmarks::RunMathBenchmarks()
+{
+	std::srand(1);
+	printf("SIMD: SSE %d, AVX %d\n", YSH_SIMD_SSE, YSH_SIMD_AVX);
+	RunSuite<float>("float");
+	RunSuite<double>("double");
+}
+
+void Benchmarks::RunPhysicsBenchmarks()
+{
+	printf("Physics (%d steps, lanes %d)\n", BENCHMARK_PHYSICS_N_STEPS, CONTACTSOLVER_LANES);
+
+	// A single column of boxes resting on the ground
+	{
+		BoxScene stack;
+		stack.AddBox(dVec3(16.0, 16.0, 1.0), 0.0, dVec3(0.0, 0.0, -1.0));
+		for (int i = 0; i < 16; ++i)
+		{
+			stack.AddBox(dVec3(0.5, 0.5, 0.5), 1.0, dVec3(0.0, 0.0, 0.5 + (double)i));
+		}
+		stack.Run("stack");
+	}
+
+	// Three layers of boxes packed side by side, which form a single large island
+	for (int e = 0; e < 2; ++e)
+	{
+		BoxScene pile;
+		IntegratorConfig config;
+		config.integrator = e == 0 ? INTEGRATOR_RK4 : INTEGRATOR_SEMI_IMPLICIT_EULER;
+		config.gyroscopic = true;
+		pile.SetIntegratorConfig(config);
+
+		pile.AddBox(dVec3(16.0, 16.0, 1.0), 0.0, dVec3(0.0, 0.0, -1.0));
+		for (int k = 0; k < 3; ++k)
+		{
+			for (int i = 0; i < 8; ++i)
+			{
+				for (int j = 0; j < 8; ++j)
+				{
+					pile.AddBox(dVec3(0.5, 0.5, 0.5), 1.0, dVec3(0.995*(double)i - 3.5, 0.995*(double)j - 3.5, 0.5 + (double)k));
+				}
+			}
+		}
+		pile.Run(e == 0 ? "pile (RK4)" : "pile (Euler)");
+	}
+
+	// Slabs of 5 x 4 boxes resting on the ground, each slab one Compound body, and then the same boxes as separate bodies
+	for (int c = 0; c < 2; ++c)
+	{
+		BoxScene slabs;
+		slabs.AddBox(dVec3(16.0, 16.0, 1.0), 0.0, dVec3(0.0, 0.0, -1.0));
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int j = 0; j < 4; ++j)
+			{
+				slabs.AddSlab(dVec3(0.25, 0.25, 0.25), 5, 4, 1.0, dVec3(3.0*(double)i - 4.5, 2.5*(double)j - 3.75, 0.25), c == 0);
+			}
+		}
+		slabs.Run(c == 0 ? "compounds" : "compound parts");
+	}
+
+	printf("Integrators (%d bodies in free flight, %d steps)\n", BENCHMARK_N_ELEMENTS, BENCHMARK_PHYSICS_N_STEPS);
+	IntegratorConfig config;
+	config.integrator = INTEGRATOR_RK4;
+	config.gyroscopic = true;
+	RunIntegrator("RK4", config);
+	config.integrator = INTEGRATOR_SEMI_IMPLICIT_EULER;
+	RunIntegrator("Euler (gyroscopic)", config);
+	config.gyroscopic = false;
+	RunIntegrator("Euler (no gyroscopic)", config);
+
+	printf("Mesh support (brute force up to %d vertices)\n", MESH_BRUTE_FORCE_MAX_VERTS);
+	RunSupport(8);
+	RunSupport(32);
+	RunSupport(128);
+	RunSupport(1024);
+
+	printf("QuickHull\n");
+	RunQuickHull(1000, false);
+	RunQuickHull(100000, false);
+	RunQuickHull(1000, true);
+	RunQuickHull(100000, true);
+	RunQuickHullCylinder(64, 10, 0.001);
+	RunQuickHullCylinder(256, 33, 0.0);
+	RunQuickHullLattice(32);
+
+	printf("Cooked meshes\n");
+	RunCooking(1000);
+	RunCooking(100000);
+
+	printf("Triangle meshes\n");
+	RunTriangleMesh(32);
+	RunTriangleMesh(256);
+
+	printf("Height fields\n");
+	RunHeightField(257);
+	RunHeightField(4096);
+
+	printf("Convex decomposition (torus, %u threads)\n", std::max(1u, std::thread::hardware_concurrency()));
+	RunConvexDecomposition(32, 0.05);
+	RunConvexDecomposition(32, 0.01);
+	RunConvexDecomposition(64, 0.05);
+	RunConvexDecomposition(64, 0.01);
+}
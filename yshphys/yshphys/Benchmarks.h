@@ -0,0 +1,11 @@
+#pragma once
+
+namespace Benchmarks
+{
+	// Micro-benchmarks for the core math types. Results are printed to stdout as nanoseconds per operation.
+	void RunMathBenchmarks();
+	// Steps the stack, pile, and compound scenes and reports the cost of a step and of the contact solver,
+	// then compares the cost and energy drift of the integrators, and times the Mesh support function, QuickHull, cooking, TriangleMesh and HeightField
+	// queries, and convex decomposition
+	void RunPhysicsBenchmarks();
+};
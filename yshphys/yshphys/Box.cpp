@@ -37,6 +37,40 @@ dVec3 Box::SupportLocal(const dVec3& v) const
 		m_halfDim.z * MathUtils::sgn(v.z));
 }
 
+int Box::SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const
+{
+	if (maxVerts < 4)
+	{
+		return Geometry::SupportFeatureLocal(v, verts, maxVerts);
+	}
+
+	// The face whose normal is most aligned with v. Edges and vertices are never returned;
+	// the contact clipping decides whether a face is aligned well enough to be used.
+
+	const dVec3 v_v = v.Times(v);
+	int i = 0;
+	if (v_v.y > v_v[i]) { i = 1; }
+	if (v_v.z > v_v[i]) { i = 2; }
+	const int j = (i + 1) % 3;
+	const int k = (i + 2) % 3;
+
+	const double s = v[i] < 0.0 ? -1.0 : 1.0;
+
+	// counter-clockwise about the face normal s*e_i
+	const double uj[4] = { -1.0, 1.0, 1.0, -1.0 };
+	const double uk[4] = { -1.0, -1.0, 1.0, 1.0 };
+
+	for (int n = 0; n < 4; ++n)
+	{
+		const int m = s > 0.0 ? n : 3 - n;
+		dVec3& vert = verts[n];
+		vert[i] = s*m_halfDim[i];
+		vert[j] = uj[m] * m_halfDim[j];
+		vert[k] = uk[m] * m_halfDim[k];
+	}
+	return 4;
+}
+
 bool Box::RayIntersect(const dVec3& pos, const dQuat& rot, const Ray& ray, dVec3& hit) const
 {
 	Ray r;
@@ -11,6 +11,7 @@ public:
 	void SetDimensions(double halfDimX, double halDimY, double halfDimZ);
 
 	virtual dVec3 SupportLocal(const dVec3& v) const;
+	virtual int SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const;
 
 	virtual bool RayIntersect(const dVec3& pos, const dQuat& rot, const Ray& ray, dVec3& hitPt) const;
 
@@ -37,6 +37,22 @@ dVec3 Capsule::SupportLocal(const dVec3& v) const
 	return support;
 }
 
+int Capsule::SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const
+{
+	const double vv = v.Dot(v);
+	if (maxVerts < 2 || v.z*v.z >= SUPPORTFEATURE_PARALLEL_TOL*SUPPORTFEATURE_PARALLEL_TOL*vv)
+	{
+		return Geometry::SupportFeatureLocal(v, verts, maxVerts);
+	}
+
+	// v is perpendicular to the axis, so the whole side segment is extremal
+
+	const double k = m_radius / sqrt(v.x*v.x + v.y*v.y);
+	verts[0] = dVec3(v.x*k, v.y*k, -m_halfHeight);
+	verts[1] = dVec3(v.x*k, v.y*k, m_halfHeight);
+	return 2;
+}
+
 Polygon Capsule::IntersectPlaneLocal(const dVec3& planeOrigin, const dVec3& planeNormal, const dVec3& x, const dVec3& y) const
 {
 	Polygon poly;
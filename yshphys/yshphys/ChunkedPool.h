@@ -0,0 +1,44 @@
+#pragma once
+
+// A growable array whose elements never move. Storage is allocated in fixed-size chunks that are kept across Clear(),
+// so a pool that is reused every frame stops allocating once it has grown to its high-water mark.
+
+template <class T, int ChunkSize = 256>
+class ChunkedPool
+{
+public:
+	ChunkedPool() : m_size(0) {}
+	~ChunkedPool()
+	{
+		for (T* chunk : m_chunks)
+		{
+			delete[] chunk;
+		}
+	}
+	ChunkedPool(const ChunkedPool&) = delete;
+	ChunkedPool& operator = (const ChunkedPool&) = delete;
+
+	// Forget all elements, but keep the memory around for reuse
+	void Clear() { m_size = 0; }
+
+	T* Allocate()
+	{
+		if (m_size == Capacity())
+		{
+			m_chunks.push_back(new T[ChunkSize]);
+		}
+		T* element = &(*this)[m_size];
+		m_size++;
+		return element;
+	}
+
+	int Size() const { return m_size; }
+	int Capacity() const { return (int)m_chunks.size() * ChunkSize; }
+
+	T& operator [] (int i) { return m_chunks[i / ChunkSize][i % ChunkSize]; }
+	const T& operator [] (int i) const { return m_chunks[i / ChunkSize][i % ChunkSize]; }
+
+private:
+	std::vector<T*> m_chunks;
+	int m_size;
+};
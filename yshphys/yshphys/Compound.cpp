@@ -0,0 +1,281 @@
+#include "stdafx.h"
+#include "Compound.h"
+#include "Ray.h"
+
+namespace
+{
+	bool Overlaps(const BoundingBox& a, const BoundingBox& b)
+	{
+		return
+			a.min.x <= b.max.x && a.max.x >= b.min.x &&
+			a.min.y <= b.max.y && a.max.y >= b.min.y &&
+			a.min.z <= b.max.z && a.max.z >= b.min.z;
+	}
+
+	BoundingBox Aggregate(const BoundingBox& a, const BoundingBox& b)
+	{
+		BoundingBox box;
+		for (int dim = 0; dim < 3; ++dim)
+		{
+			box.min[dim] = std::min(a.min[dim], b.min[dim]);
+			box.max[dim] = std::max(a.max[dim], b.max[dim]);
+		}
+		return box;
+	}
+
+	// The bounds of box (in the frame of a child at pos and rot) in the compound's frame
+	BoundingBox ChildBounds(const BoundingBox& box, const dVec3& pos, const dQuat& rot)
+	{
+		const dVec3 center = pos + rot.Transform((box.min + box.max).Scale(0.5));
+		const dVec3 span = dMat33(rot).Abs().Transform((box.max - box.min).Scale(0.5));
+		BoundingBox bounds;
+		bounds.min = center - span;
+		bounds.max = center + span;
+		return bounds;
+	}
+}
+
+Compound::Compound()
+{
+	m_localOOBB.min = dVec3(0.0, 0.0, 0.0);
+	m_localOOBB.max = dVec3(0.0, 0.0, 0.0);
+}
+
+Compound::~Compound()
+{
+	ReleaseChildren();
+}
+
+void Compound::ReleaseChildren()
+{
+	for (const Child& child : m_children)
+	{
+		child.geom->Release();
+	}
+	m_children.clear();
+	m_nodes.clear();
+}
+
+void Compound::Create(const Child* children, int nChildren)
+{
+	// Reference the new children before releasing the old ones, in case they're the same
+	for (int i = 0; i < nChildren; ++i)
+	{
+		assert(children[i].geom != nullptr && !children[i].geom->IsConcave());
+		children[i].geom->AddRef();
+	}
+	ReleaseChildren();
+	m_children.assign(children, children + nChildren);
+
+	if (m_children.empty())
+	{
+		m_localOOBB.min = dVec3(0.0, 0.0, 0.0);
+		m_localOOBB.max = dVec3(0.0, 0.0, 0.0);
+		return;
+	}
+
+	std::vector<BoundingBox> bounds(nChildren);
+	std::vector<int> order(nChildren);
+	for (int i = 0; i < nChildren; ++i)
+	{
+		bounds[i] = ChildBounds(m_children[i].geom->GetLocalOOBB(), m_children[i].pos, m_children[i].rot);
+		order[i] = i;
+	}
+
+	m_nodes.reserve(2 * nChildren - 1);
+	BuildNode(0, nChildren, order, bounds);
+
+	m_localOOBB = m_nodes[0].bounds;
+}
+
+int Compound::BuildNode(int iFirst, int n, std::vector<int>& order, const std::vector<BoundingBox>& bounds)
+{
+	const int iNode = (int)m_nodes.size();
+	m_nodes.push_back(BVHNode());
+
+	BVHNode node;
+	node.bounds = bounds[order[iFirst]];
+	for (int i = iFirst + 1; i < iFirst + n; ++i)
+	{
+		node.bounds = Aggregate(node.bounds, bounds[order[i]]);
+	}
+
+	if (n == 1)
+	{
+		node.index = order[iFirst];
+		node.leaf = true;
+		m_nodes[iNode] = node;
+		return iNode;
+	}
+
+	// Split in half along the longest axis of the node, by the centers of the children's bounds
+	const dVec3 span = node.bounds.max - node.bounds.min;
+	int axis = 0;
+	if (span.y > span[axis]) { axis = 1; }
+	if (span.z > span[axis]) { axis = 2; }
+
+	const int half = n / 2;
+	std::nth_element(order.begin() + iFirst, order.begin() + iFirst + half, order.begin() + iFirst + n,
+		[&](int a, int b) { return bounds[a].min[axis] + bounds[a].max[axis] < bounds[b].min[axis] + bounds[b].max[axis]; });
+
+	BuildNode(iFirst, half, order, bounds);
+	node.index = BuildNode(iFirst + half, n - half, order, bounds);
+	node.leaf = false;
+	m_nodes[iNode] = node;
+	return iNode;
+}
+
+int Compound::GetNChildren() const
+{
+	return (int)m_children.size();
+}
+
+const Compound::Child& Compound::GetChild(int i) const
+{
+	return m_children[i];
+}
+
+template <class Visitor>
+void Compound::VisitChildren(const BoundingBox& box, const Visitor& visit) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	int stack[COMPOUND_BVH_MAX_DEPTH];
+	int nStack = 0;
+	int iNode = 0;
+	while (true)
+	{
+		const BVHNode& node = m_nodes[iNode];
+		if (Overlaps(node.bounds, box))
+		{
+			if (!node.leaf)
+			{
+				assert(nStack < COMPOUND_BVH_MAX_DEPTH);
+				stack[nStack++] = node.index;
+				iNode++;
+				continue;
+			}
+			visit(node.index);
+		}
+		if (nStack == 0)
+		{
+			break;
+		}
+		iNode = stack[--nStack];
+	}
+}
+
+void Compound::ForEachPart(const BoundingBox& localBounds, const PartCallback& f) const
+{
+	VisitChildren(localBounds, [&](int i)
+	{
+		const Child& child = m_children[i];
+		f(i, child.geom, child.pos, child.rot);
+	});
+}
+
+dVec3 Compound::SupportLocal(const dVec3& v) const
+{
+	assert(!m_children.empty());
+	dVec3 best;
+	double dBest = -DBL_MAX;
+	for (const Child& child : m_children)
+	{
+		const dVec3 x = child.geom->Support(child.pos, child.rot, v);
+		const double d = x.Dot(v);
+		if (d > dBest)
+		{
+			best = x;
+			dBest = d;
+		}
+	}
+	return best;
+}
+
+bool Compound::RayIntersect(const dVec3& pos, const dQuat& rot, const Ray& ray, dVec3& hit) const
+{
+	if (m_nodes.empty())
+	{
+		return false;
+	}
+
+	Ray r;
+	r.SetOrigin((-rot).Transform(ray.GetOrigin() - pos));
+	r.SetDirection((-rot).Transform(ray.GetDirection()));
+	r.SetLength(ray.GetLength());
+
+	const dVec3 o = ray.GetOrigin();
+	const dVec3 dir = ray.GetDirection();
+	double tBest = DBL_MAX;
+
+	int stack[COMPOUND_BVH_MAX_DEPTH];
+	int nStack = 0;
+	int iNode = 0;
+	while (true)
+	{
+		const BVHNode& node = m_nodes[iNode];
+		AABB aabb;
+		aabb.min = node.bounds.min;
+		aabb.max = node.bounds.max;
+		double tIn, tOut;
+		if (r.IntersectAABB(aabb, tIn, tOut) && tOut >= 0.0 && tIn < tBest)
+		{
+			if (!node.leaf)
+			{
+				assert(nStack < COMPOUND_BVH_MAX_DEPTH);
+				stack[nStack++] = node.index;
+				iNode++;
+				continue;
+			}
+			const Child& child = m_children[node.index];
+			dVec3 x;
+			if (child.geom->RayIntersect(pos + rot.Transform(child.pos), rot*child.rot, ray, x))
+			{
+				tBest = std::min(tBest, (x - o).Dot(dir) / dir.Dot(dir));
+			}
+		}
+		if (nStack == 0)
+		{
+			break;
+		}
+		iNode = stack[--nStack];
+	}
+
+	if (tBest == DBL_MAX)
+	{
+		return false;
+	}
+	hit = o + dir.Scale(tBest);
+	return true;
+}
+
+Material::Type Compound::GetMaterialLocal(const dVec3& x) const
+{
+	if (m_children.empty())
+	{
+		return m_material;
+	}
+
+	int iBest = 0;
+	double dBest = DBL_MAX;
+	for (int i = 0; i < (int)m_children.size(); ++i)
+	{
+		const BoundingBox bounds = ChildBounds(m_children[i].geom->GetLocalOOBB(), m_children[i].pos, m_children[i].rot);
+		double d = 0.0;
+		for (int dim = 0; dim < 3; ++dim)
+		{
+			const double e = std::max(0.0, std::max(bounds.min[dim] - x[dim], x[dim] - bounds.max[dim]));
+			d += e*e;
+		}
+		if (d < dBest)
+		{
+			iBest = i;
+			dBest = d;
+		}
+	}
+	const Child& child = m_children[iBest];
+	return child.geom->GetMaterialLocal((-child.rot).Transform(x - child.pos));
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Geometry.h"
+
+#define COMPOUND_BVH_MAX_DEPTH 64
+
+// A rigid assembly of convex child geometries, each placed with its own transform, e.g. a vehicle built out of boxes and
+// cylinders. The whole assembly is a single broadphase leaf and a single body, and the narrowphase collides it child by
+// child (see Geometry::ForEachPart), with a contact manifold per child. Part i is child i.
+//
+// The children are sorted into a small BVH over their bounds (in the compound's frame), so that only the children near the
+// other geometry are visited. It's laid out like the BVH of a TriangleMesh, with a single child per leaf.
+//
+// The children are referenced (see Geometry::AddRef) rather than copied, so they can come from a GeometryLibrary and must
+// outlive the compound. The compound has no mass properties of its own: the body's mass and inertia are set as usual.
+
+class Compound :
+	public Geometry
+{
+public:
+	struct Child
+	{
+		const Geometry* geom; // convex
+		dVec3 pos;
+		dQuat rot;
+	};
+
+	Compound();
+	virtual ~Compound();
+
+	Compound(const Compound&) = delete;
+	Compound& operator = (const Compound&) = delete;
+
+	// References the children (releasing the previous ones), and builds the BVH over them
+	void Create(const Child* children, int nChildren);
+
+	int GetNChildren() const;
+	const Child& GetChild(int i) const;
+
+	// The support of the union of the children, which is exact since each of them is convex
+	virtual dVec3 SupportLocal(const dVec3& v) const;
+
+	virtual bool RayIntersect(const dVec3& pos, const dQuat& rot, const Ray& ray, dVec3& hitPt) const;
+
+	// The material of the child whose bounds are nearest x
+	virtual Material::Type GetMaterialLocal(const dVec3& x) const;
+
+	virtual bool IsConcave() const { return true; }
+	virtual void ForEachPart(const BoundingBox& localBounds, const PartCallback& f) const;
+
+	virtual EGeomType GetType() const { return EGeomType::COMPOUND; }
+
+private:
+	struct BVHNode
+	{
+		BoundingBox bounds;
+		int index; // a leaf's child, or an internal node's second child
+		bool leaf;
+	};
+
+	// Builds the subtree over the children order[iFirst, iFirst + n) and returns the index of its root
+	int BuildNode(int iFirst, int n, std::vector<int>& order, const std::vector<BoundingBox>& bounds);
+
+	template <class Visitor>
+	void VisitChildren(const BoundingBox& box, const Visitor& visit) const;
+
+	void ReleaseChildren();
+
+	std::vector<Child> m_children;
+	std::vector<BVHNode> m_nodes;
+};
@@ -39,6 +39,26 @@ dVec3 Cone::SupportLocal(const dVec3& v) const
 	}
 }
 
+int Cone::SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const
+{
+	const double vv = v.Dot(v);
+	const double rr = v.x*v.x + v.y*v.y;
+
+	if (maxVerts >= 3 && v.z < 0.0 && rr < SUPPORTFEATURE_PARALLEL_TOL*SUPPORTFEATURE_PARALLEL_TOL*vv)
+	{
+		// v points out of the base: the base disk, counter-clockwise about -z
+
+		const int n = maxVerts < SUPPORTFEATURE_RING_VERTS ? maxVerts : SUPPORTFEATURE_RING_VERTS;
+		for (int i = 0; i < n; ++i)
+		{
+			const double phi = -2.0*dPI*(double)i / (double)n;
+			verts[i] = dVec3(m_radius*cos(phi), m_radius*sin(phi), 0.0);
+		}
+		return n;
+	}
+	return Geometry::SupportFeatureLocal(v, verts, maxVerts);
+}
+
 Polygon Cone::IntersectPlaneLocal(const dVec3& planeOrigin, const dVec3& planeNormal, const dVec3& x, const dVec3& y) const
 {
 	Polygon poly;
@@ -2,11 +2,7 @@
 #include "Contact.h"
 
 
-Contact::Contact()
+Contact::Contact() : depth(0.0), impulse(nullptr)
 {
 }
 
-
-Contact::~Contact()
-{
-}
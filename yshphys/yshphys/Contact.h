@@ -3,14 +3,25 @@
 
 class RigidBody;
 
+// The impulses the contact solver accumulated for a contact point. They are persisted across steps
+// (by the contact manifolds) so that the next solve can start from them (warm starting).
+struct ContactImpulse
+{
+	ContactImpulse() : n(0.0) { t[0] = 0.0; t[1] = 0.0; }
+
+	double n; // along the normal
+	double t[2]; // along the tangents given by MathUtils::OrthonormalBasis of the normal n[0]
+};
+
 struct Contact
 {
 public:
 	Contact();
-	virtual ~Contact();
 
 	RigidBody* body[2];
 	dVec3 x[2]; // contact point postions
 	dVec3 n[2]; // contact point normals (typical usage has n[1] == -n[0]). The normal force of body[0] points along n[0].
+	double depth; // penetration along the normal (positive if penetrating, negative for a speculative contact)
+	ContactImpulse* impulse; // warm starting values on input, the accumulated impulses on output
 };
 
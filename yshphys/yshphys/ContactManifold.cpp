@@ -0,0 +1,445 @@
+#include "stdafx.h"
+#include "ContactManifold.h"
+#include "Geometry.h"
+#include "DebugRenderer.h"
+
+// Every clip plane adds at most one vertex to the incident polygon
+#define CONTACTMANIFOLD_MAX_CLIP_VERTS (2*CONTACTMANIFOLD_MAX_FEATURE_VERTS)
+
+// Point ids: an unclipped incident vertex i has id i. A vertex created by clipping incident edge (i, i+1)
+// against the side plane j of the reference feature has id CLIPPED_ID | (j << 5) | i.
+// REFERENCE1_ID is set when geom1 (rather than geom0) provides the reference feature.
+#define CLIPPED_ID 0x400
+#define REFERENCE1_ID 0x800
+
+namespace
+{
+	// Clips the convex polygon "in" to the halfspace (x - o).Dot(planeN) <= 0. Two vertices are treated as a segment.
+	int ClipToPlane(
+		const dVec3* in, const int* idIn, int nIn,
+		const dVec3& o, const dVec3& planeN, int iPlane,
+		dVec3* out, int* idOut)
+	{
+		auto Intersect = [&](int i, int j, double di, double dj, int k)
+		{
+			out[k] = in[i] + (in[j] - in[i]).Scale(di / (di - dj));
+			idOut[k] = CLIPPED_ID | (iPlane << 5) | (idIn[i] & 0x1f);
+		};
+
+		if (nIn == 2)
+		{
+			const double d0 = (in[0] - o).Dot(planeN);
+			const double d1 = (in[1] - o).Dot(planeN);
+			if (d0 > 0.0 && d1 > 0.0)
+			{
+				return 0;
+			}
+			out[0] = in[0]; idOut[0] = idIn[0];
+			out[1] = in[1]; idOut[1] = idIn[1];
+			if (d0 > 0.0)
+			{
+				Intersect(0, 1, d0, d1, 0);
+			}
+			else if (d1 > 0.0)
+			{
+				Intersect(0, 1, d0, d1, 1);
+			}
+			return 2;
+		}
+
+		int nOut = 0;
+		int iPrev = nIn - 1;
+		double dPrev = (in[iPrev] - o).Dot(planeN);
+		for (int i = 0; i < nIn; ++i)
+		{
+			const double d = (in[i] - o).Dot(planeN);
+			if ((dPrev > 0.0) != (d > 0.0))
+			{
+				Intersect(iPrev, i, dPrev, d, nOut++);
+			}
+			if (d <= 0.0)
+			{
+				out[nOut] = in[i];
+				idOut[nOut] = idIn[i];
+				nOut++;
+			}
+			iPrev = i;
+			dPrev = d;
+		}
+		return nOut;
+	}
+
+	// Newell's method; the result is not normalized.
+	dVec3 PolygonNormal(const dVec3* verts, int n)
+	{
+		dVec3 normal(0.0, 0.0, 0.0);
+		for (int i = n - 1, j = 0; j < n; i = j, ++j)
+		{
+			normal = normal + verts[i].Cross(verts[j]);
+		}
+		return normal;
+	}
+}
+
+ContactManifold::ContactManifold() :
+	n(0.0, 0.0, 1.0), nPoints(0),
+	m_localN(0.0, 0.0, 1.0), m_relPos(0.0, 0.0, 0.0), m_relRot(dQuat::Identity())
+{
+}
+
+void ContactManifold::SetSinglePoint(const dVec3& pt0, const dVec3& pt1)
+{
+	points[0].x[0] = pt0;
+	points[0].x[1] = pt1;
+	points[0].depth = (pt0 - pt1).Dot(n);
+	points[0].id = 0;
+	points[0].lifetime = 0;
+	points[0].impulse = ContactImpulse();
+	nPoints = 1;
+}
+
+void ContactManifold::Build(
+	const Geometry* geom0, const dVec3& pos0, const dQuat& rot0, const dVec3& pt0,
+	const Geometry* geom1, const dVec3& pos1, const dQuat& rot1, const dVec3& pt1,
+	const dVec3& n0, double maxSeparation)
+{
+	n = n0.Scale(1.0 / sqrt(n0.Dot(n0)));
+	nPoints = 0;
+
+	GeneratePoints(geom0, pos0, rot0, pt0, geom1, pos1, rot1, pt1, maxSeparation);
+
+	for (int i = 0; i < nPoints; ++i)
+	{
+		points[i].local[0] = (-rot0).Transform(points[i].x[0] - pos0);
+		points[i].local[1] = (-rot1).Transform(points[i].x[1] - pos1);
+	}
+	m_localN = (-rot0).Transform(n);
+	m_relPos = (-rot0).Transform(pos1 - pos0);
+	m_relRot = (-rot0)*rot1;
+}
+
+bool ContactManifold::IsReusable(const dVec3& pos0, const dQuat& rot0, const dVec3& pos1, const dQuat& rot1) const
+{
+	const dVec3 dPos = (-rot0).Transform(pos1 - pos0) - m_relPos;
+	const dQuat relRot = (-rot0)*rot1;
+	const double cosHalfAngle = relRot.x*m_relRot.x + relRot.y*m_relRot.y + relRot.z*m_relRot.z + relRot.w*m_relRot.w;
+
+	return
+		dPos.Dot(dPos) < CONTACTMANIFOLD_REUSE_DIST*CONTACTMANIFOLD_REUSE_DIST &&
+		abs(cosHalfAngle) > CONTACTMANIFOLD_REUSE_COS;
+}
+
+bool ContactManifold::Refresh(const dVec3& pos0, const dQuat& rot0, const dVec3& pos1, const dQuat& rot1)
+{
+	n = rot0.Transform(m_localN);
+
+	int nKept = 0;
+	for (int i = 0; i < nPoints; ++i)
+	{
+		Point p = points[i];
+		p.x[0] = pos0 + rot0.Transform(p.local[0]);
+		p.x[1] = pos1 + rot1.Transform(p.local[1]);
+
+		const dVec3 d = p.x[0] - p.x[1];
+		p.depth = d.Dot(n);
+		const dVec3 tangential = d - n.Scale(p.depth);
+
+		if (p.depth > -CONTACTMANIFOLD_BREAKING_DIST &&
+			tangential.Dot(tangential) < CONTACTMANIFOLD_BREAKING_DIST*CONTACTMANIFOLD_BREAKING_DIST)
+		{
+			p.lifetime++;
+			points[nKept++] = p;
+		}
+	}
+	nPoints = nKept;
+	return nPoints > 0;
+}
+
+void ContactManifold::Merge(const ContactManifold& previous)
+{
+	bool matched[CONTACTMANIFOLD_MAX_POINTS] = { false };
+
+	for (int i = 0; i < nPoints; ++i)
+	{
+		Point& p = points[i];
+
+		int iMatch = -1;
+		for (int j = 0; j < previous.nPoints; ++j)
+		{
+			if (!matched[j] && previous.points[j].id == p.id)
+			{
+				iMatch = j;
+				break;
+			}
+		}
+		if (iMatch < 0)
+		{
+			// The features may have been relabeled (e.g. the reference face changed), so fall back to proximity
+			double dSqrBest = CONTACTMANIFOLD_MATCH_DIST*CONTACTMANIFOLD_MATCH_DIST;
+			for (int j = 0; j < previous.nPoints; ++j)
+			{
+				const dVec3 d = previous.points[j].local[0] - p.local[0];
+				if (!matched[j] && d.Dot(d) < dSqrBest)
+				{
+					iMatch = j;
+					dSqrBest = d.Dot(d);
+				}
+			}
+		}
+		if (iMatch >= 0)
+		{
+			matched[iMatch] = true;
+			p.lifetime = previous.points[iMatch].lifetime + 1;
+			p.impulse = previous.points[iMatch].impulse;
+		}
+	}
+}
+
+double ContactManifold::GetMaxDepth() const
+{
+	double maxDepth = -DBL_MAX;
+	for (int i = 0; i < nPoints; ++i)
+	{
+		maxDepth = std::max(maxDepth, points[i].depth);
+	}
+	return maxDepth;
+}
+
+void ContactManifold::GeneratePoints(
+	const Geometry* geom0, const dVec3& pos0, const dQuat& rot0, const dVec3& pt0,
+	const Geometry* geom1, const dVec3& pos1, const dQuat& rot1, const dVec3& pt1,
+	double maxSeparation)
+{
+	dVec3 feature[2][CONTACTMANIFOLD_MAX_FEATURE_VERTS];
+	int nFeature[2];
+	nFeature[0] = geom0->SupportFeature(pos0, rot0, n, feature[0], CONTACTMANIFOLD_MAX_FEATURE_VERTS);
+	nFeature[1] = geom1->SupportFeature(pos1, rot1, -n, feature[1], CONTACTMANIFOLD_MAX_FEATURE_VERTS);
+
+	if (nFeature[0] == 1 || nFeature[1] == 1)
+	{
+		// A vertex is involved, so the EPA points are the whole story.
+		SetSinglePoint(pt0, pt1);
+		return;
+	}
+
+	// Choose the reference feature. Faces are preferred over edges; for two edges, the contact normal serves as the
+	// reference "face" normal, but only if the edges are parallel (otherwise they cross at the EPA point).
+
+	dVec3 refNormal[2];
+	double align[2] = { -1.0, -1.0 };
+	for (int i = 0; i < 2; ++i)
+	{
+		const dVec3 outward = i == 0 ? n : -n;
+		if (nFeature[i] > 2)
+		{
+			refNormal[i] = PolygonNormal(feature[i], nFeature[i]);
+			refNormal[i] = refNormal[i].Scale(1.0 / sqrt(refNormal[i].Dot(refNormal[i])));
+			if (refNormal[i].Dot(outward) < 0.0)
+			{
+				refNormal[i] = -refNormal[i];
+			}
+			align[i] = refNormal[i].Dot(outward);
+		}
+		else
+		{
+			refNormal[i] = outward;
+		}
+	}
+
+	int iRef = align[1] > align[0] ? 1 : 0;
+	if (align[iRef] < CONTACTMANIFOLD_FACE_ALIGN_TOL)
+	{
+		if (nFeature[0] != 2 || nFeature[1] != 2)
+		{
+			SetSinglePoint(pt0, pt1);
+			return;
+		}
+		dVec3 e0 = feature[0][1] - feature[0][0];
+		dVec3 e1 = feature[1][1] - feature[1][0];
+		const double c = e0.Dot(e1);
+		if (c*c < CONTACTMANIFOLD_FACE_ALIGN_TOL*CONTACTMANIFOLD_FACE_ALIGN_TOL*e0.Dot(e0)*e1.Dot(e1))
+		{
+			SetSinglePoint(pt0, pt1);
+			return;
+		}
+		iRef = 0;
+	}
+	const int iInc = 1 - iRef;
+
+	const dVec3* ref = feature[iRef];
+	const int nRef = nFeature[iRef];
+	const dVec3& nrm = refNormal[iRef];
+
+	// Clip the incident feature against the side planes of the reference feature
+
+	dVec3 clipBuffer[2][CONTACTMANIFOLD_MAX_CLIP_VERTS];
+	int idBuffer[2][CONTACTMANIFOLD_MAX_CLIP_VERTS];
+
+	int nClip = nFeature[iInc];
+	for (int i = 0; i < nClip; ++i)
+	{
+		clipBuffer[0][i] = feature[iInc][i];
+		idBuffer[0][i] = i;
+	}
+	int iBuffer = 0;
+
+	if (nRef == 2)
+	{
+		const dVec3 e = ref[1] - ref[0];
+		nClip = ClipToPlane(clipBuffer[0], idBuffer[0], nClip, ref[1], e, 0, clipBuffer[1], idBuffer[1]);
+		nClip = ClipToPlane(clipBuffer[1], idBuffer[1], nClip, ref[0], -e, 1, clipBuffer[0], idBuffer[0]);
+	}
+	else
+	{
+		dVec3 centroid(0.0, 0.0, 0.0);
+		for (int i = 0; i < nRef; ++i)
+		{
+			centroid = centroid + ref[i];
+		}
+		centroid = centroid.Scale(1.0 / (double)nRef);
+
+		for (int i = 0; i < nRef && nClip > 0; ++i)
+		{
+			const dVec3& a = ref[i];
+			const dVec3& b = ref[(i + 1) % nRef];
+			dVec3 sideNormal = (b - a).Cross(nrm);
+			if (sideNormal.Dot(centroid - a) > 0.0)
+			{
+				sideNormal = -sideNormal;
+			}
+			nClip = ClipToPlane(clipBuffer[iBuffer], idBuffer[iBuffer], nClip, a, sideNormal, i, clipBuffer[1 - iBuffer], idBuffer[1 - iBuffer]);
+			iBuffer = 1 - iBuffer;
+		}
+	}
+
+	// Keep the clipped points that are beneath (or just above) the reference face
+
+	const dVec3* clipped = clipBuffer[iBuffer];
+	const int* clippedIds = idBuffer[iBuffer];
+
+	Point candidates[CONTACTMANIFOLD_MAX_CLIP_VERTS];
+	int nCandidates = 0;
+	int iDeepest = -1;
+	for (int i = 0; i < nClip; ++i)
+	{
+		const double separation = (clipped[i] - ref[0]).Dot(nrm);
+		if (separation > maxSeparation)
+		{
+			continue;
+		}
+		Point& p = candidates[nCandidates];
+		p.x[iInc] = clipped[i];
+		p.x[iRef] = clipped[i] - nrm.Scale(separation);
+		p.depth = -separation;
+		p.id = clippedIds[i] | (iRef == 1 ? REFERENCE1_ID : 0);
+		p.lifetime = 0;
+		p.impulse = ContactImpulse();
+		if (iDeepest < 0 || p.depth > candidates[iDeepest].depth)
+		{
+			iDeepest = nCandidates;
+		}
+		nCandidates++;
+	}
+
+	if (nCandidates == 0)
+	{
+		SetSinglePoint(pt0, pt1);
+		return;
+	}
+
+	if (nCandidates <= CONTACTMANIFOLD_MAX_POINTS)
+	{
+		for (int i = 0; i < nCandidates; ++i)
+		{
+			points[i] = candidates[i];
+		}
+		nPoints = nCandidates;
+		return;
+	}
+
+	// Reduce to CONTACTMANIFOLD_MAX_POINTS: the deepest point, the point farthest from it,
+	// the point making the largest triangle with those two, and the point adding the most area to that triangle.
+
+	int iKeep[4];
+	iKeep[0] = iDeepest;
+
+	double best = -1.0;
+	for (int i = 0; i < nCandidates; ++i)
+	{
+		if (i == iKeep[0])
+		{
+			continue;
+		}
+		const dVec3 d = candidates[i].x[iInc] - candidates[iKeep[0]].x[iInc];
+		if (d.Dot(d) > best)
+		{
+			best = d.Dot(d);
+			iKeep[1] = i;
+		}
+	}
+
+	const dVec3& A = candidates[iKeep[0]].x[iInc];
+	const dVec3& B = candidates[iKeep[1]].x[iInc];
+
+	best = -1.0;
+	for (int i = 0; i < nCandidates; ++i)
+	{
+		if (i == iKeep[0] || i == iKeep[1])
+		{
+			continue;
+		}
+		const double area = abs((B - A).Cross(candidates[i].x[iInc] - A).Dot(nrm));
+		if (area > best)
+		{
+			best = area;
+			iKeep[2] = i;
+		}
+	}
+
+	const dVec3& C = candidates[iKeep[2]].x[iInc];
+	const double orientation = (B - A).Cross(C - A).Dot(nrm) < 0.0 ? -1.0 : 1.0;
+
+	// The point farthest outside of triangle ABC has the most negative (oriented) area with one of its edges
+	best = DBL_MAX;
+	for (int i = 0; i < nCandidates; ++i)
+	{
+		if (i == iKeep[0] || i == iKeep[1] || i == iKeep[2])
+		{
+			continue;
+		}
+		const dVec3& P = candidates[i].x[iInc];
+		const double areaAB = orientation*(B - A).Cross(P - A).Dot(nrm);
+		const double areaBC = orientation*(C - B).Cross(P - B).Dot(nrm);
+		const double areaCA = orientation*(A - C).Cross(P - C).Dot(nrm);
+		const double area = std::min(areaAB, std::min(areaBC, areaCA));
+		if (area < best)
+		{
+			best = area;
+			iKeep[3] = i;
+		}
+	}
+
+	for (int i = 0; i < 4; ++i)
+	{
+		points[i] = candidates[iKeep[i]];
+	}
+	nPoints = 4;
+}
+
+void ContactManifold::DebugDraw(DebugRenderer* renderer) const
+{
+	const float k = 0.05f;
+	const fVec3 color(0.0f, 1.0f, 0.0f);
+	for (int i = 0; i < nPoints; ++i)
+	{
+		const fVec3 x0(points[i].x[0]);
+		const fVec3 x1(points[i].x[1]);
+		renderer->DrawBox(k, k, k, x0, fQuat::Identity(), color, false, false);
+		renderer->DrawLine(x0, x1, fVec3(0.0f, 0.0f, 1.0f));
+		renderer->DrawLine(x0, fVec3(points[i].x[0] + n.Scale(0.25)), color);
+		if (nPoints > 1)
+		{
+			renderer->DrawLine(x0, fVec3(points[(i + 1) % nPoints].x[0]), color);
+		}
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "YshMath.h"
+#include "Contact.h"
+
+class Geometry;
+class DebugRenderer;
+
+#define CONTACTMANIFOLD_MAX_POINTS 4
+#define CONTACTMANIFOLD_MAX_FEATURE_VERTS 16
+
+// A reference face is only clipped against if its normal is within this cosine of the contact normal
+#define CONTACTMANIFOLD_FACE_ALIGN_TOL 0.98
+// Clipped points that are separated by less than this distance are kept, so that resting contacts don't flicker
+#define CONTACTMANIFOLD_SEPARATION_TOL 0.005
+
+// A manifold is reused without running the narrowphase if the relative transform of the geometries has changed by less
+// than this distance and rotation (cosine of the half angle) since it was built
+#define CONTACTMANIFOLD_REUSE_DIST 0.001
+#define CONTACTMANIFOLD_REUSE_COS 0.9999999
+// Tracked points are dropped once their anchors drift apart by more than this distance
+#define CONTACTMANIFOLD_BREAKING_DIST 0.02
+// Points without a matching feature id are matched to the nearest previous point within this distance
+#define CONTACTMANIFOLD_MATCH_DIST 0.02
+
+// Builds the contact points of a penetrating pair of geometries from the normal found by EPA.
+// The support features of both geometries along the normal are found; the one whose face is better aligned
+// with the normal becomes the reference, and the other (the incident feature) is clipped against its side planes
+// (Sutherland-Hodgman). The surviving points beneath the reference face are reduced to at most
+// CONTACTMANIFOLD_MAX_POINTS, keeping the deepest point and the largest area.
+//
+// Manifolds persist across steps: the points are anchored in the local frames of both geometries, so that
+// a resting pair can be tracked (Refresh) without the narrowphase, and rebuilt manifolds inherit the
+// per-point data of the previous step's points with the same feature ids (Merge).
+
+struct ContactManifold
+{
+public:
+	struct Point
+	{
+		dVec3 x[2]; // the point on each geometry (world space)
+		dVec3 local[2]; // x[i] in the local frame of geometry i
+		double depth; // penetration along the normal (positive if penetrating)
+		int id; // identifies the pair of features that produced the point, so it can be matched across frames
+		int lifetime; // the number of consecutive steps the point has been matched
+		ContactImpulse impulse; // the solver's accumulated impulse, carried over to warm start the next step
+	};
+
+	ContactManifold();
+
+	// pt0, pt1, and n0 are the outputs of Geometry::Intersect. n0 is the outward normal of geom0.
+	// Geometries that don't touch yet can be given their closest points, and a maxSeparation beyond their distance.
+	void Build(
+		const Geometry* geom0, const dVec3& pos0, const dQuat& rot0, const dVec3& pt0,
+		const Geometry* geom1, const dVec3& pos1, const dQuat& rot1, const dVec3& pt1,
+		const dVec3& n0, double maxSeparation = CONTACTMANIFOLD_SEPARATION_TOL);
+
+	// True if the relative transform of the geometries is (nearly) the one the manifold was built with
+	bool IsReusable(const dVec3& pos0, const dQuat& rot0, const dVec3& pos1, const dQuat& rot1) const;
+	// Recomputes the world space points from their anchors and drops those that drifted apart.
+	// Returns false if no points remain.
+	bool Refresh(const dVec3& pos0, const dQuat& rot0, const dVec3& pos1, const dQuat& rot1);
+	// Carries the per-point data of matching points over from the previous manifold of the same pair
+	void Merge(const ContactManifold& previous);
+
+	double GetMaxDepth() const;
+
+	void DebugDraw(DebugRenderer* renderer) const;
+
+	dVec3 n; // unit normal pointing out of geom0 and into geom1
+	Point points[CONTACTMANIFOLD_MAX_POINTS];
+	int nPoints;
+
+private:
+	void GeneratePoints(
+		const Geometry* geom0, const dVec3& pos0, const dQuat& rot0, const dVec3& pt0,
+		const Geometry* geom1, const dVec3& pos1, const dQuat& rot1, const dVec3& pt1,
+		double maxSeparation);
+	void SetSinglePoint(const dVec3& pt0, const dVec3& pt1);
+
+	dVec3 m_localN; // n in the local frame of geom0
+	dVec3 m_relPos; // the position of geom1 in the local frame of geom0 when the manifold was built
+	dQuat m_relRot; // the rotation of geom1 relative to geom0 when the manifold was built
+};
@@ -0,0 +1,748 @@
+#include "stdafx.h"
+#include "ContactSolver.h"
+#include "RigidBody.h"
+#include "ThreadPool.h"
+
+namespace
+{
+	int CountBits(int bits)
+	{
+		int n = 0;
+		for (; bits; bits &= bits - 1)
+		{
+			n++;
+		}
+		return n;
+	}
+}
+
+ContactSolver::ContactSolver() : m_nParallelBatches(0)
+{
+}
+
+ContactSolver& ContactSolver::ThreadWorkspace()
+{
+	thread_local ContactSolver workspace;
+	return workspace;
+}
+
+MathUtils::GaussSeidelConfig ContactSolver::DefaultConfig()
+{
+	MathUtils::GaussSeidelConfig config;
+	config.maxIterations = CONTACTSOLVER_ITERATIONS;
+	config.relaxation = CONTACTSOLVER_RELAXATION;
+	config.tolerance = CONTACTSOLVER_TOLERANCE;
+	return config;
+}
+
+int ContactSolver::IBody(RigidBody* body) const
+{
+	const auto it = std::lower_bound(m_sortedBodies.begin(), m_sortedBodies.end(), body);
+	assert(it != m_sortedBodies.end() && *it == body);
+	return (int)(it - m_sortedBodies.begin());
+}
+
+void ContactSolver::InitRow(SolverRow& row, const SolverBody& b0, const SolverBody& b1, const dVec3& r0, const dVec3& r1, const dVec3& d0, const dVec3& d1) const
+{
+	row.d0 = d0;
+	row.d1 = d1;
+	row.r0xd0 = r0.Cross(d0);
+	row.r1xd1 = r1.Cross(d1);
+	row.Iinv_r0xd0 = b0.Iinv.Transform(row.r0xd0);
+	row.Iinv_r1xd1 = b1.Iinv.Transform(row.r1xd1);
+
+	const double JMJ =
+		b0.minv*d0.Dot(d0) +
+		b1.minv*d1.Dot(d1) +
+		row.r0xd0.Dot(row.Iinv_r0xd0) +
+		row.r1xd1.Dot(row.Iinv_r1xd1);
+	assert(JMJ >= 0.0);
+	row.effectiveMass = JMJ > 0.0 ? 1.0 / JMJ : 0.0;
+}
+
+double ContactSolver::RowVelocity(const SolverRow& row, const SolverBody& b0, const SolverBody& b1) const
+{
+	return
+		row.d0.Dot(b0.v) +
+		row.d1.Dot(b1.v) +
+		row.r0xd0.Dot(b0.w) +
+		row.r1xd1.Dot(b1.w);
+}
+
+void ContactSolver::ApplyImpulse(const SolverRow& row, SolverBody& b0, SolverBody& b1, double impulse) const
+{
+	if (b0.dynamic)
+	{
+		b0.v = b0.v + row.d0.Scale(b0.minv*impulse);
+		b0.w = b0.w + row.Iinv_r0xd0.Scale(impulse);
+	}
+	if (b1.dynamic)
+	{
+		b1.v = b1.v + row.d1.Scale(b1.minv*impulse);
+		b1.w = b1.w + row.Iinv_r1xd1.Scale(impulse);
+	}
+}
+
+void ContactSolver::SolveContact(SolverContact& c, const MathUtils::GaussSeidelConfig& config, MathUtils::GaussSeidelStats& stats)
+{
+	SolverBody& b0 = m_bodies[c.iBody[0]];
+	SolverBody& b1 = m_bodies[c.iBody[1]];
+
+	// Friction first, limited by the current normal impulse. Both tangents are updated together,
+	// and the resulting impulse is projected back onto the friction cone.
+
+	double error[2];
+	double friction[2];
+	for (int k = 0; k < 2; ++k)
+	{
+		error[k] = -RowVelocity(c.friction[k], b0, b1);
+		friction[k] = c.friction[k].impulse + config.relaxation*c.friction[k].effectiveMass*error[k];
+	}
+
+	const double maxFriction = c.mu*c.normal.impulse;
+	const double frictionSqr = friction[0] * friction[0] + friction[1] * friction[1];
+	const bool slipping = frictionSqr > maxFriction*maxFriction;
+	if (slipping)
+	{
+		const double s = frictionSqr > 0.0 ? maxFriction / sqrt(frictionSqr) : 0.0;
+		friction[0] *= s;
+		friction[1] *= s;
+		stats.nClamped += 2;
+	}
+	for (int k = 0; k < 2; ++k)
+	{
+		ApplyImpulse(c.friction[k], b0, b1, friction[k] - c.friction[k].impulse);
+		c.friction[k].impulse = friction[k];
+		if (!slipping)
+		{
+			stats.residual = std::max(stats.residual, abs(error[k]));
+		}
+	}
+
+	// Clamp the accumulated impulse (not the increment), so that earlier iterations can be undone
+
+	const double errorN = c.target - RowVelocity(c.normal, b0, b1);
+	const double normal = std::max(0.0, c.normal.impulse + config.relaxation*c.normal.effectiveMass*errorN);
+	ApplyImpulse(c.normal, b0, b1, normal - c.normal.impulse);
+	c.normal.impulse = normal;
+
+	if (normal > 0.0)
+	{
+		stats.residual = std::max(stats.residual, abs(errorN));
+	}
+	else
+	{
+		stats.nClamped++;
+	}
+}
+
+double ContactSolver::SolvePenetration(SolverContact& c)
+{
+	// The normal row again, on the pseudo velocities. Returns the error of the row (zero if it's clamped).
+
+	SolverBody& b0 = m_bodies[c.iBody[0]];
+	SolverBody& b1 = m_bodies[c.iBody[1]];
+	const SolverRow& row = c.normal;
+
+	const double v =
+		row.d0.Dot(b0.vPseudo) +
+		row.d1.Dot(b1.vPseudo) +
+		row.r0xd0.Dot(b0.wPseudo) +
+		row.r1xd1.Dot(b1.wPseudo);
+
+	const double error = c.bias - v;
+	const double impulse = std::max(0.0, c.pseudoImpulse + row.effectiveMass*error);
+	const double dImpulse = impulse - c.pseudoImpulse;
+	c.pseudoImpulse = impulse;
+
+	if (b0.dynamic)
+	{
+		b0.vPseudo = b0.vPseudo + row.d0.Scale(b0.minv*dImpulse);
+		b0.wPseudo = b0.wPseudo + row.Iinv_r0xd0.Scale(dImpulse);
+	}
+	if (b1.dynamic)
+	{
+		b1.vPseudo = b1.vPseudo + row.d1.Scale(b1.minv*dImpulse);
+		b1.wPseudo = b1.wPseudo + row.Iinv_r1xd1.Scale(dImpulse);
+	}
+
+	return impulse > 0.0 ? abs(error) : 0.0;
+}
+
+void ContactSolver::CorrectPositions(const MathUtils::GaussSeidelConfig& config)
+{
+	bool penetrating = false;
+	for (const SolverContact& c : m_contacts)
+	{
+		penetrating = penetrating || c.bias > 0.0;
+	}
+	if (!penetrating)
+	{
+		return;
+	}
+
+	// There are no warm starts or friction rows, so this converges in far fewer iterations than the velocities do
+
+	for (int iteration = 0; iteration < CONTACTSOLVER_POSITION_ITERATIONS; ++iteration)
+	{
+		double residual = 0.0;
+		for (SolverContact& c : m_contacts)
+		{
+			residual = std::max(residual, SolvePenetration(c));
+		}
+		if (residual < config.tolerance)
+		{
+			break;
+		}
+	}
+}
+
+void ContactSolver::Colour()
+{
+	const int nContacts = (int)m_contacts.size();
+
+	m_batchOffsets.clear();
+	m_batchOffsets.push_back(0);
+
+	if (nContacts < CONTACTSOLVER_COLOURING_MIN_CONTACTS)
+	{
+		m_batchOffsets.push_back(nContacts);
+		m_nParallelBatches = 0;
+		return;
+	}
+
+	// Greedily give each contact the lowest colour that neither of its dynamic bodies has used yet
+
+	m_bodyColours.assign(m_bodies.size(), 0);
+	m_contactColours.resize(nContacts);
+
+	int nColours = 0;
+	int batchSizes[CONTACTSOLVER_MAX_COLOURS + 1] = { 0 };
+
+	for (int i = 0; i < nContacts; ++i)
+	{
+		const SolverContact& c = m_contacts[i];
+
+		unsigned long long used = 0;
+		for (int j = 0; j < 2; ++j)
+		{
+			if (m_bodies[c.iBody[j]].dynamic)
+			{
+				used |= m_bodyColours[c.iBody[j]];
+			}
+		}
+
+		int colour = 0;
+		while (colour < CONTACTSOLVER_MAX_COLOURS && (used & (1ull << colour)))
+		{
+			colour++;
+		}
+
+		if (colour < CONTACTSOLVER_MAX_COLOURS)
+		{
+			for (int j = 0; j < 2; ++j)
+			{
+				m_bodyColours[c.iBody[j]] |= (1ull << colour);
+			}
+			nColours = std::max(nColours, colour + 1);
+		}
+		m_contactColours[i] = colour;
+		batchSizes[colour]++;
+	}
+
+	// Sort the contacts by colour (stable, so that the order is deterministic)
+
+	for (int colour = 0; colour < nColours; ++colour)
+	{
+		m_batchOffsets.push_back(m_batchOffsets.back() + batchSizes[colour]);
+	}
+	m_nParallelBatches = nColours;
+	if (batchSizes[CONTACTSOLVER_MAX_COLOURS] > 0)
+	{
+		m_batchOffsets.push_back(m_batchOffsets.back() + batchSizes[CONTACTSOLVER_MAX_COLOURS]);
+	}
+
+	int next[CONTACTSOLVER_MAX_COLOURS + 1];
+	for (int colour = 0; colour < nColours; ++colour)
+	{
+		next[colour] = m_batchOffsets[colour];
+	}
+	next[CONTACTSOLVER_MAX_COLOURS] = m_batchOffsets[nColours];
+
+	m_colouredContacts.resize(nContacts);
+	for (int i = 0; i < nContacts; ++i)
+	{
+		m_colouredContacts[next[m_contactColours[i]]++] = m_contacts[i];
+	}
+	m_contacts.swap(m_colouredContacts);
+}
+
+void ContactSolver::PackRow(SimdRow& row, const SolverRow* rows[CONTACTSOLVER_LANES]) const
+{
+	auto pack = [&rows](SimdVec3& v, dVec3 SolverRow::*field)
+	{
+		alignas(32) double x[3][CONTACTSOLVER_LANES];
+		for (int lane = 0; lane < CONTACTSOLVER_LANES; ++lane)
+		{
+			const dVec3& u = rows[lane]->*field;
+			x[0][lane] = u.x;
+			x[1][lane] = u.y;
+			x[2][lane] = u.z;
+		}
+		v.x = Simd::Load(x[0]);
+		v.y = Simd::Load(x[1]);
+		v.z = Simd::Load(x[2]);
+	};
+	pack(row.d0, &SolverRow::d0);
+	pack(row.r0xd0, &SolverRow::r0xd0);
+	pack(row.r1xd1, &SolverRow::r1xd1);
+	pack(row.Iinv_r0xd0, &SolverRow::Iinv_r0xd0);
+	pack(row.Iinv_r1xd1, &SolverRow::Iinv_r1xd1);
+
+	alignas(32) double effectiveMass[CONTACTSOLVER_LANES];
+	alignas(32) double impulse[CONTACTSOLVER_LANES];
+	for (int lane = 0; lane < CONTACTSOLVER_LANES; ++lane)
+	{
+		assert(rows[lane]->d1.x == -rows[lane]->d0.x && rows[lane]->d1.y == -rows[lane]->d0.y && rows[lane]->d1.z == -rows[lane]->d0.z);
+		effectiveMass[lane] = rows[lane]->effectiveMass;
+		impulse[lane] = rows[lane]->impulse;
+	}
+	row.effectiveMass = Simd::Load(effectiveMass);
+	row.impulse = Simd::Load(impulse);
+}
+
+void ContactSolver::Pack()
+{
+	static const SolverRow emptyRow = SolverRow();
+
+	m_simdBatches.clear();
+	m_simdBatchOffsets.assign(1, 0);
+
+	for (int iBatch = 0; iBatch < m_nParallelBatches; ++iBatch)
+	{
+		const int iBegin = m_batchOffsets[iBatch];
+		const int iEnd = m_batchOffsets[iBatch + 1];
+
+		for (int i = iBegin; i < iEnd; i += CONTACTSOLVER_LANES)
+		{
+			m_simdBatches.emplace_back();
+			SimdBatch& b = m_simdBatches.back();
+
+			const SolverRow* rows[3][CONTACTSOLVER_LANES];
+			alignas(32) double minv[2][CONTACTSOLVER_LANES];
+			alignas(32) double target[CONTACTSOLVER_LANES];
+			alignas(32) double mu[CONTACTSOLVER_LANES];
+			alignas(32) double active[CONTACTSOLVER_LANES];
+
+			for (int lane = 0; lane < CONTACTSOLVER_LANES; ++lane)
+			{
+				if (i + lane < iEnd)
+				{
+					const SolverContact& c = m_contacts[i + lane];
+					b.iContact[lane] = i + lane;
+					for (int j = 0; j < 2; ++j)
+					{
+						b.iBody[j][lane] = c.iBody[j];
+						minv[j][lane] = m_bodies[c.iBody[j]].minv;
+					}
+					rows[0][lane] = &c.normal;
+					rows[1][lane] = &c.friction[0];
+					rows[2][lane] = &c.friction[1];
+					target[lane] = c.target;
+					mu[lane] = c.mu;
+					active[lane] = 1.0;
+				}
+				else
+				{
+					// Empty lanes gather the bodies of the first lane, but are never scattered
+					b.iContact[lane] = -1;
+					for (int j = 0; j < 2; ++j)
+					{
+						b.iBody[j][lane] = b.iBody[j][0];
+						minv[j][lane] = 0.0;
+					}
+					rows[0][lane] = rows[1][lane] = rows[2][lane] = &emptyRow;
+					target[lane] = 0.0;
+					mu[lane] = 0.0;
+					active[lane] = 0.0;
+				}
+			}
+
+			b.minv[0] = Simd::Load(minv[0]);
+			b.minv[1] = Simd::Load(minv[1]);
+			PackRow(b.normal, rows[0]);
+			PackRow(b.friction[0], rows[1]);
+			PackRow(b.friction[1], rows[2]);
+			b.target = Simd::Load(target);
+			b.mu = Simd::Load(mu);
+			b.active = Simd::Greater(Simd::Load(active), Simd::Splat(0.0));
+		}
+
+		m_simdBatchOffsets.push_back((int)m_simdBatches.size());
+	}
+}
+
+void ContactSolver::Unpack()
+{
+	for (const SimdBatch& b : m_simdBatches)
+	{
+		alignas(32) double impulse[3][CONTACTSOLVER_LANES];
+		Simd::Store(impulse[0], b.normal.impulse);
+		Simd::Store(impulse[1], b.friction[0].impulse);
+		Simd::Store(impulse[2], b.friction[1].impulse);
+
+		for (int lane = 0; lane < CONTACTSOLVER_LANES && b.iContact[lane] >= 0; ++lane)
+		{
+			SolverContact& c = m_contacts[b.iContact[lane]];
+			c.normal.impulse = impulse[0][lane];
+			c.friction[0].impulse = impulse[1][lane];
+			c.friction[1].impulse = impulse[2][lane];
+		}
+	}
+}
+
+void ContactSolver::SolveBatch(SimdBatch& b, const MathUtils::GaussSeidelConfig& config, MathUtils::GaussSeidelStats& stats)
+{
+	// The same steps as SolveContact, for all lanes at once
+
+	auto gather = [this, &b](int j, dVec3 SolverBody::*field)
+	{
+		const dVec3& u0 = m_bodies[b.iBody[j][0]].*field;
+		const dVec3& u1 = m_bodies[b.iBody[j][1]].*field;
+		const dVec3& u2 = m_bodies[b.iBody[j][2]].*field;
+		const dVec3& u3 = m_bodies[b.iBody[j][3]].*field;
+		SimdVec3 v;
+		v.x = Simd::Set(u0.x, u1.x, u2.x, u3.x);
+		v.y = Simd::Set(u0.y, u1.y, u2.y, u3.y);
+		v.z = Simd::Set(u0.z, u1.z, u2.z, u3.z);
+		return v;
+	};
+	auto scatter = [this, &b](int j, dVec3 SolverBody::*field, const SimdVec3& v)
+	{
+		alignas(32) double x[3][CONTACTSOLVER_LANES];
+		Simd::Store(x[0], v.x);
+		Simd::Store(x[1], v.y);
+		Simd::Store(x[2], v.z);
+		for (int lane = 0; lane < CONTACTSOLVER_LANES && b.iContact[lane] >= 0; ++lane)
+		{
+			SolverBody& body = m_bodies[b.iBody[j][lane]];
+			if (body.dynamic)
+			{
+				body.*field = dVec3(x[0][lane], x[1][lane], x[2][lane]);
+			}
+		}
+	};
+
+	SimdVec3 v0 = gather(0, &SolverBody::v);
+	SimdVec3 w0 = gather(0, &SolverBody::w);
+	SimdVec3 v1 = gather(1, &SolverBody::v);
+	SimdVec3 w1 = gather(1, &SolverBody::w);
+
+	auto rowVelocity = [&](const SimdRow& row)
+	{
+		const SimdVec3 v0_v1 = { v0.x - v1.x, v0.y - v1.y, v0.z - v1.z };
+		return row.d0.Dot(v0_v1) + row.r0xd0.Dot(w0) + row.r1xd1.Dot(w1);
+	};
+	// Static bodies have zero inverse mass and inertia, so their lanes are left unchanged
+	auto applyImpulse = [&](const SimdRow& row, const Simd::Double4& impulse)
+	{
+		const Simd::Double4 k0 = b.minv[0] * impulse;
+		const Simd::Double4 k1 = b.minv[1] * impulse;
+		v0.x = v0.x + k0*row.d0.x; v0.y = v0.y + k0*row.d0.y; v0.z = v0.z + k0*row.d0.z;
+		w0.x = w0.x + impulse*row.Iinv_r0xd0.x; w0.y = w0.y + impulse*row.Iinv_r0xd0.y; w0.z = w0.z + impulse*row.Iinv_r0xd0.z;
+		v1.x = v1.x - k1*row.d0.x; v1.y = v1.y - k1*row.d0.y; v1.z = v1.z - k1*row.d0.z;
+		w1.x = w1.x + impulse*row.Iinv_r1xd1.x; w1.y = w1.y + impulse*row.Iinv_r1xd1.y; w1.z = w1.z + impulse*row.Iinv_r1xd1.z;
+	};
+
+	const Simd::Double4 relaxation = Simd::Splat(config.relaxation);
+	const Simd::Double4 zero = Simd::Splat(0.0);
+	const int active = Simd::MaskBits(b.active);
+
+	// Friction
+
+	Simd::Double4 error[2];
+	Simd::Double4 friction[2];
+	for (int k = 0; k < 2; ++k)
+	{
+		error[k] = zero - rowVelocity(b.friction[k]);
+		friction[k] = b.friction[k].impulse + relaxation*b.friction[k].effectiveMass*error[k];
+	}
+
+	const Simd::Double4 maxFriction = b.mu*b.normal.impulse;
+	const Simd::Double4 frictionSqr = friction[0] * friction[0] + friction[1] * friction[1];
+	const Simd::Double4 slipping = Simd::Greater(frictionSqr, maxFriction*maxFriction);
+	if (Simd::MaskBits(slipping))
+	{
+		// frictionSqr > 0 in the slipping lanes, and the others are left unscaled
+		const Simd::Double4 one = Simd::Splat(1.0);
+		const Simd::Double4 s = Simd::Select(slipping, maxFriction, one) / Simd::Sqrt(Simd::Select(slipping, frictionSqr, one));
+		friction[0] = friction[0] * s;
+		friction[1] = friction[1] * s;
+		stats.nClamped += 2 * CountBits(Simd::MaskBits(slipping) & active);
+	}
+	Simd::Double4 residual = zero;
+	for (int k = 0; k < 2; ++k)
+	{
+		applyImpulse(b.friction[k], friction[k] - b.friction[k].impulse);
+		b.friction[k].impulse = friction[k];
+		residual = Simd::Max(residual, Simd::AndNot(slipping, Simd::Abs(error[k])));
+	}
+
+	// Normal
+
+	const Simd::Double4 errorN = b.target - rowVelocity(b.normal);
+	const Simd::Double4 normal = Simd::Max(zero, b.normal.impulse + relaxation*b.normal.effectiveMass*errorN);
+	applyImpulse(b.normal, normal - b.normal.impulse);
+	b.normal.impulse = normal;
+
+	const Simd::Double4 pushing = Simd::Greater(normal, zero);
+	residual = Simd::Max(residual, Simd::And(pushing, Simd::Abs(errorN)));
+	stats.residual = std::max(stats.residual, Simd::HorizontalMax(residual));
+	stats.nClamped += CountBits(active & ~Simd::MaskBits(pushing));
+
+	scatter(0, &SolverBody::v, v0);
+	scatter(0, &SolverBody::w, w0);
+	scatter(1, &SolverBody::v, v1);
+	scatter(1, &SolverBody::w, w1);
+}
+
+void ContactSolver::Solve(
+	const Contact* contacts, int nContacts, double dt,
+	const MathUtils::GaussSeidelConfig& config, ThreadPool* threadPool, MathUtils::GaussSeidelStats& stats)
+{
+	// Gather the bodies and predict their velocities at the end of the step, ignoring the contacts
+
+	m_sortedBodies.clear();
+	for (int i = 0; i < nContacts; ++i)
+	{
+		m_sortedBodies.push_back(contacts[i].body[0]);
+		m_sortedBodies.push_back(contacts[i].body[1]);
+	}
+	std::sort(m_sortedBodies.begin(), m_sortedBodies.end());
+	m_sortedBodies.erase(std::unique(m_sortedBodies.begin(), m_sortedBodies.end()), m_sortedBodies.end());
+
+	const int nBodies = (int)m_sortedBodies.size();
+	m_bodies.resize(nBodies);
+	for (int i = 0; i < nBodies; ++i)
+	{
+		RigidBody* body = m_sortedBodies[i];
+		SolverBody& b = m_bodies[i];
+		b.body = body;
+		b.minv = body->GetInverseMass();
+		b.Iinv = body->GetInverseInertia();
+		b.dynamic = !body->IsStatic();
+		b.v = body->GetLinearVelocity() + (body->GetLinImpulse() + body->GetForce().Scale(dt)).Scale(b.minv);
+		b.w = body->GetAngularVelocity() + b.Iinv.Transform(body->GetAngImpulse() + body->GetTorque().Scale(dt));
+		b.vPseudo = dVec3(0.0, 0.0, 0.0);
+		b.wPseudo = dVec3(0.0, 0.0, 0.0);
+	}
+
+	m_contacts.resize(nContacts);
+	for (int i = 0; i < nContacts; ++i)
+	{
+		const Contact& contact = contacts[i];
+		SolverContact& c = m_contacts[i];
+
+		c.iContact = i;
+		c.iBody[0] = IBody(contact.body[0]);
+		c.iBody[1] = IBody(contact.body[1]);
+		SolverBody& b0 = m_bodies[c.iBody[0]];
+		SolverBody& b1 = m_bodies[c.iBody[1]];
+
+		const dVec3 r0 = contact.x[0] - contact.body[0]->GetPosition();
+		const dVec3 r1 = contact.x[1] - contact.body[1]->GetPosition();
+
+		dVec3 t[2];
+		MathUtils::OrthonormalBasis(contact.n[0], t[0], t[1]);
+
+		// The speculative contact of a fast body limits how fast the gap closes, and over a long step the gap closes as the
+		// bodies' centres approach along the normal. Its points needn't lie on that line, and constraining them would let
+		// some of the impulse go into spin while the centres keep closing faster than the gap allows, and the body skips
+		// through, so the row acts through the centres. Slow pairs keep their points, which hold up shapes resting on meshes.
+		const bool fastSpeculative = contact.depth < 0.0 && (contact.body[0]->IsFast() || contact.body[1]->IsFast());
+		if (fastSpeculative)
+		{
+			InitRow(c.normal, b0, b1, contact.n[0].Scale(r0.Dot(contact.n[0])), contact.n[1].Scale(r1.Dot(contact.n[1])), contact.n[0], contact.n[1]);
+		}
+		else
+		{
+			InitRow(c.normal, b0, b1, r0, r1, contact.n[0], contact.n[1]);
+		}
+		InitRow(c.friction[0], b0, b1, r0, r1, t[0], -t[0]);
+		InitRow(c.friction[1], b0, b1, r0, r1, t[1], -t[1]);
+
+		// Restitution and the choice of friction coefficient act on the velocities at the start of the step, pending impulses included
+
+		const dVec3 vLin[2] =
+		{
+			contact.body[0]->GetLinearVelocity() + contact.body[0]->GetLinImpulse().Scale(b0.minv),
+			contact.body[1]->GetLinearVelocity() + contact.body[1]->GetLinImpulse().Scale(b1.minv)
+		};
+		const dVec3 vAng[2] =
+		{
+			contact.body[0]->GetAngularVelocity() + b0.Iinv.Transform(contact.body[0]->GetAngImpulse()),
+			contact.body[1]->GetAngularVelocity() + b1.Iinv.Transform(contact.body[1]->GetAngImpulse())
+		};
+
+		const dVec3 v[2] =
+		{
+			vLin[0] + vAng[0].Cross(r0),
+			vLin[1] + vAng[1].Cross(r1)
+		};
+		const dVec3 v0_v1 = v[0] - v[1];
+
+		const double vImpact = v0_v1.Dot(contact.n[0]);
+
+		const double restitution = Material::Restitution(
+			contact.body[0]->GetMaterial(contact.x[0]),
+			contact.body[1]->GetMaterial(contact.x[1]));
+
+		if (contact.depth < 0.0)
+		{
+			// Speculative contacts may approach by their separation over the step, which brings them to rest against one
+			// another rather than through. They don't bounce.
+			c.target = contact.depth / dt;
+		}
+		else
+		{
+			c.target = (vImpact < -CONTACTSOLVER_RESTITUTION_THRESH) ? -vImpact*restitution : 0.0;
+		}
+
+		const dVec3 vSlip = v0_v1 - contact.n[0].Scale(vImpact);
+
+		const FrictionCoefficients mu = Material::Friction(
+			contact.body[0]->GetMaterial(contact.x[0]),
+			contact.body[1]->GetMaterial(contact.x[1]));
+
+		c.mu = (vSlip.Dot(vSlip) < CONTACTSOLVER_STATIC_SLIP_SPEED*CONTACTSOLVER_STATIC_SLIP_SPEED) ? mu.uStatic : mu.uKinetic;
+		if (fastSpeculative)
+		{
+			// The bodies only meet at the end of the step, and the impact (its bounce and friction) is left to the contact
+			// they touch at in the next one. Friction scaled by the impulse that took out most of the approach would spin them.
+			c.mu = 0.0;
+		}
+
+		const double correction = std::min(CONTACTSOLVER_MAX_CORRECTION, std::max(0.0, contact.depth - CONTACTSOLVER_SLOP));
+		c.bias = CONTACTSOLVER_BAUMGARTE*correction / dt;
+		c.pseudoImpulse = 0.0;
+
+		// Warm start
+
+		const ContactImpulse warmStart = contact.impulse ? *contact.impulse : ContactImpulse();
+		c.normal.impulse = warmStart.n;
+		c.friction[0].impulse = warmStart.t[0];
+		c.friction[1].impulse = warmStart.t[1];
+		ApplyImpulse(c.normal, b0, b1, c.normal.impulse);
+		ApplyImpulse(c.friction[0], b0, b1, c.friction[0].impulse);
+		ApplyImpulse(c.friction[1], b0, b1, c.friction[1].impulse);
+	}
+
+	Colour();
+	Pack();
+
+	stats = MathUtils::GaussSeidelStats();
+
+	while (stats.iterations < config.maxIterations)
+	{
+		stats.residual = 0.0;
+		stats.nClamped = 0;
+
+		for (int iBatch = 0; iBatch + 1 < (int)m_batchOffsets.size(); ++iBatch)
+		{
+			if (iBatch < m_nParallelBatches)
+			{
+				const int iBegin = m_simdBatchOffsets[iBatch];
+				const int iEnd = m_simdBatchOffsets[iBatch + 1];
+				const int taskSize = CONTACTSOLVER_TASK_SIZE / CONTACTSOLVER_LANES;
+
+				if (threadPool && iEnd - iBegin > taskSize)
+				{
+					const int nTasks = (iEnd - iBegin + taskSize - 1) / taskSize;
+					m_taskStats.assign(nTasks, MathUtils::GaussSeidelStats());
+
+					threadPool->ParallelFor(nTasks, [&](int iTask)
+					{
+						const int iTaskBegin = iBegin + iTask*taskSize;
+						const int iTaskEnd = std::min(iEnd, iTaskBegin + taskSize);
+						for (int i = iTaskBegin; i < iTaskEnd; ++i)
+						{
+							SolveBatch(m_simdBatches[i], config, m_taskStats[iTask]);
+						}
+					});
+
+					for (const MathUtils::GaussSeidelStats& taskStats : m_taskStats)
+					{
+						stats.residual = std::max(stats.residual, taskStats.residual);
+						stats.nClamped += taskStats.nClamped;
+					}
+				}
+				else
+				{
+					for (int i = iBegin; i < iEnd; ++i)
+					{
+						SolveBatch(m_simdBatches[i], config, stats);
+					}
+				}
+			}
+			else
+			{
+				for (int i = m_batchOffsets[iBatch]; i < m_batchOffsets[iBatch + 1]; ++i)
+				{
+					SolveContact(m_contacts[i], config, stats);
+				}
+			}
+		}
+		stats.iterations++;
+
+		if (stats.residual < config.tolerance)
+		{
+			break;
+		}
+	}
+
+	Unpack();
+
+	CorrectPositions(config);
+
+	for (const SolverContact& c : m_contacts)
+	{
+		const Contact& contact = contacts[c.iContact];
+
+		assert(abs(c.normal.impulse) < 100000.0);
+
+		if (contact.impulse)
+		{
+			contact.impulse->n = c.normal.impulse;
+			contact.impulse->t[0] = c.friction[0].impulse;
+			contact.impulse->t[1] = c.friction[1].impulse;
+		}
+
+		for (const SolverRow* row : { &c.normal, &c.friction[0], &c.friction[1] })
+		{
+			if (!contact.body[0]->IsStatic())
+			{
+				contact.body[0]->ApplyLinImpulse(row->d0.Scale(row->impulse));
+				contact.body[0]->ApplyAngImpulse(row->r0xd0.Scale(row->impulse));
+			}
+			if (!contact.body[1]->IsStatic())
+			{
+				contact.body[1]->ApplyLinImpulse(row->d1.Scale(row->impulse));
+				contact.body[1]->ApplyAngImpulse(row->r1xd1.Scale(row->impulse));
+			}
+		}
+
+		if (c.pseudoImpulse > 0.0)
+		{
+			if (!contact.body[0]->IsStatic())
+			{
+				contact.body[0]->ApplyLinPseudoImpulse(c.normal.d0.Scale(c.pseudoImpulse));
+				contact.body[0]->ApplyAngPseudoImpulse(c.normal.r0xd0.Scale(c.pseudoImpulse));
+			}
+			if (!contact.body[1]->IsStatic())
+			{
+				contact.body[1]->ApplyLinPseudoImpulse(c.normal.d1.Scale(c.pseudoImpulse));
+				contact.body[1]->ApplyAngPseudoImpulse(c.normal.r1xd1.Scale(c.pseudoImpulse));
+			}
+		}
+	}
+}
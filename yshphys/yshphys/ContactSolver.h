@@ -0,0 +1,179 @@
+#pragma once
+#include "YshMath.h"
+#include "Contact.h"
+
+class RigidBody;
+class ThreadPool;
+
+// Default configuration. The tolerance is on the largest velocity error (m/s) of any unclamped constraint.
+#define CONTACTSOLVER_ITERATIONS 16
+#define CONTACTSOLVER_RELAXATION 1.0
+#define CONTACTSOLVER_TOLERANCE 0.0001
+// Contacts approaching slower than this (m/s) don't bounce, so that resting contacts stay at rest
+#define CONTACTSOLVER_RESTITUTION_THRESH 0.25
+// Contacts slipping slower than this (m/s) at the start of the step use the static friction coefficient
+#define CONTACTSOLVER_STATIC_SLIP_SPEED 0.05
+
+// Position correction. Each step removes this fraction of the penetration beyond the slop (m), and at most
+// CONTACTSOLVER_MAX_CORRECTION (m) of it.
+#define CONTACTSOLVER_BAUMGARTE 0.2
+#define CONTACTSOLVER_SLOP 0.005
+#define CONTACTSOLVER_MAX_CORRECTION 0.2
+#define CONTACTSOLVER_POSITION_ITERATIONS 8
+
+// Islands with at least this many contacts are graph coloured, so that the contacts of a colour can be solved
+// CONTACTSOLVER_LANES at a time, and in parallel. Smaller islands don't gain from it: their solve is dominated by setup.
+#define CONTACTSOLVER_COLOURING_MIN_CONTACTS 256
+// Colours are tracked with a 64-bit mask per body. Contacts that find no free colour go into a final serial batch.
+#define CONTACTSOLVER_MAX_COLOURS 64
+// The number of contacts a thread solves at a time
+#define CONTACTSOLVER_TASK_SIZE 32
+// The number of contacts packed into a SIMD batch (the width of Simd::Double4)
+#define CONTACTSOLVER_LANES 4
+
+// Sequential impulse (projected Gauss-Seidel) contact solver. Rather than assembling J*M^-1*J^T, it iterates
+// directly on a copy of the bodies' velocities, applying each constraint's impulse as soon as it's computed.
+// The velocities the bodies would have at the end of the step (under their applied forces) are solved for,
+// so that a constraint's accumulated impulse is what it has to deliver over the whole step.
+// Contacts start from the impulses they accumulated in the previous step (warm starting).
+// Memory is linear in the number of contacts, and is reused between solves.
+//
+// Each contact has a normal row and two friction rows. The friction impulse is clamped to the friction cone
+// |friction| <= mu*normal, using the static coefficient for contacts that aren't slipping.
+//
+// Penetration is resolved separately (split impulses): once the velocities are solved, the normal rows are solved again
+// for pseudo velocities that push the contacts apart by a fraction of their depth over the step. The pseudo impulses
+// only move the bodies (RigidBody::ApplyLinPseudoImpulse), so that resolving penetration doesn't add kinetic energy.
+//
+// Large islands are partitioned by a greedy graph colouring, so that no two contacts of a colour share a dynamic body.
+// The contacts of a colour are independent, so they can be solved concurrently (across the threads of a ThreadPool).
+// The colouring only depends on the contacts, so the result is the same with or without a ThreadPool.
+//
+// The contacts of a colour are also packed into SIMD batches (array of structures of arrays), one contact per lane,
+// so that the inner loop solves CONTACTSOLVER_LANES contacts per instruction. The body velocities are gathered into
+// the lanes before a batch is solved and scattered back afterwards. Contacts that aren't coloured are solved one at a time.
+
+class ContactSolver
+{
+public:
+	ContactSolver();
+
+	ContactSolver(const ContactSolver&) = delete;
+	ContactSolver& operator = (const ContactSolver&) = delete;
+
+	static ContactSolver& ThreadWorkspace();
+	static MathUtils::GaussSeidelConfig DefaultConfig();
+
+	// threadPool may be null
+	void Solve(
+		const Contact* contacts, int nContacts, double dt,
+		const MathUtils::GaussSeidelConfig& config, ThreadPool* threadPool, MathUtils::GaussSeidelStats& stats);
+
+private:
+	struct SolverBody
+	{
+		RigidBody* body;
+		dVec3 v; // linear velocity
+		dVec3 w; // angular velocity
+		dVec3 vPseudo; // linear pseudo velocity
+		dVec3 wPseudo; // angular pseudo velocity
+		double minv;
+		dMat33 Iinv;
+		bool dynamic; // static bodies are never written to, so they can be shared by concurrently solved contacts
+	};
+
+	// dynamic variables are v, w
+	// a row constrains the velocity of the contact points along the directions d0 and d1 (typically d1 == -d0) ...
+	//     (v0 + w0 x r0).d0 + (v1 + w1 x r1).d1
+	// or rearranging via triple product rule...
+	//     d0.v0 + d1.v1 + (r0 x d0).w0 + (r1 x d1).w1
+	// hence the structure of a row of the constraint matrix J
+	struct SolverRow
+	{
+		dVec3 d0;
+		dVec3 d1;
+		dVec3 r0xd0;
+		dVec3 r1xd1;
+		dVec3 Iinv_r0xd0; // cached M^-1 * J^T (angular parts; the linear parts are just scaled directions)
+		dVec3 Iinv_r1xd1;
+		double effectiveMass; // 1 / (J * M^-1 * J^T)
+		double impulse; // accumulated
+	};
+
+	struct SolverContact
+	{
+		int iContact; // the index of the input Contact
+		int iBody[2];
+		SolverRow normal;
+		SolverRow friction[2];
+		double target; // the desired separating velocity
+		double mu;
+		double bias; // the desired separating pseudo velocity
+		double pseudoImpulse; // accumulated along the normal row
+	};
+
+	// The SIMD counterparts of the above, with one contact per lane. Empty lanes have all-zero rows, so they never
+	// produce an impulse. Contact rows always have d1 == -d0, so d1 isn't stored (the solve is bound by memory bandwidth).
+	struct SimdVec3
+	{
+		Simd::Double4 x, y, z;
+
+		Simd::Double4 Dot(const SimdVec3& v) const { return x*v.x + y*v.y + z*v.z; }
+	};
+
+	struct SimdRow
+	{
+		SimdVec3 d0;
+		SimdVec3 r0xd0;
+		SimdVec3 r1xd1;
+		SimdVec3 Iinv_r0xd0;
+		SimdVec3 Iinv_r1xd1;
+		Simd::Double4 effectiveMass;
+		Simd::Double4 impulse;
+	};
+
+	struct SimdBatch
+	{
+		int iContact[CONTACTSOLVER_LANES]; // the index into m_contacts, or -1 for an empty lane
+		int iBody[2][CONTACTSOLVER_LANES];
+		Simd::Double4 minv[2];
+		SimdRow normal;
+		SimdRow friction[2];
+		Simd::Double4 target;
+		Simd::Double4 mu;
+		Simd::Double4 active; // mask of the lanes that hold a contact
+	};
+
+	int IBody(RigidBody* body) const;
+
+	void InitRow(SolverRow& row, const SolverBody& b0, const SolverBody& b1, const dVec3& r0, const dVec3& r1, const dVec3& d0, const dVec3& d1) const;
+	double RowVelocity(const SolverRow& row, const SolverBody& b0, const SolverBody& b1) const;
+	void ApplyImpulse(const SolverRow& row, SolverBody& b0, SolverBody& b1, double impulse) const;
+
+	void SolveContact(SolverContact& c, const MathUtils::GaussSeidelConfig& config, MathUtils::GaussSeidelStats& stats);
+	double SolvePenetration(SolverContact& c);
+	void CorrectPositions(const MathUtils::GaussSeidelConfig& config);
+	void Colour();
+
+	void PackRow(SimdRow& row, const SolverRow* rows[CONTACTSOLVER_LANES]) const;
+	void Pack();
+	void Unpack();
+	void SolveBatch(SimdBatch& b, const MathUtils::GaussSeidelConfig& config, MathUtils::GaussSeidelStats& stats);
+
+	std::vector<SolverBody> m_bodies;
+	std::vector<RigidBody*> m_sortedBodies;
+	std::vector<SolverContact> m_contacts;
+
+	// Colouring. The contacts of batch i are m_contacts[m_batchOffsets[i]] to m_contacts[m_batchOffsets[i+1] - 1].
+	// The first m_nParallelBatches batches may be solved concurrently.
+	std::vector<unsigned long long> m_bodyColours;
+	std::vector<int> m_contactColours;
+	std::vector<SolverContact> m_colouredContacts;
+	std::vector<int> m_batchOffsets;
+	int m_nParallelBatches;
+	std::vector<MathUtils::GaussSeidelStats> m_taskStats;
+
+	// The SIMD batches of colour i are m_simdBatches[m_simdBatchOffsets[i]] to m_simdBatches[m_simdBatchOffsets[i+1] - 1]
+	std::vector<SimdBatch, Simd::AlignedAllocator<SimdBatch>> m_simdBatches;
+	std::vector<int> m_simdBatchOffsets;
+};
@@ -0,0 +1,730 @@
+#include "stdafx.h"
+#include "ConvexDecomposition.h"
+#include "Compound.h"
+#include "QuickHull.h"
+#include "ThreadPool.h"
+
+namespace
+{
+	enum VoxelState
+	{
+		VOXEL_EMPTY = 0,
+		VOXEL_SOLID,
+		VOXEL_OUTSIDE, // while filling the interior
+		VOXEL_PENDING // while finding connected pieces
+	};
+
+	// The list of hulls written by WriteCooked. The hulls themselves are cooked meshes, in files of their own.
+	struct CookedListHeader
+	{
+		char magic[4];
+		int version;
+		int nHulls;
+	};
+
+	const char g_cookedListMagic[4] = { 'Y', 'S', 'H', 'D' };
+
+	std::string HullFileName(const char* fileName, int i)
+	{
+		return std::string(fileName) + "." + std::to_string(i);
+	}
+
+	// Whether the triangle v overlaps the cube at center with the given half size (separating axis test)
+	bool TriangleOverlapsCube(const dVec3* v, const dVec3& center, double halfSize)
+	{
+		const dVec3 a = v[0] - center;
+		const dVec3 b = v[1] - center;
+		const dVec3 c = v[2] - center;
+		const dVec3 e[3] = { b - a, c - b, a - c };
+
+		auto Separates = [&](const dVec3& axis)
+		{
+			const double pa = axis.Dot(a);
+			const double pb = axis.Dot(b);
+			const double pc = axis.Dot(c);
+			const double r = halfSize*(abs(axis.x) + abs(axis.y) + abs(axis.z));
+			return std::min(pa, std::min(pb, pc)) > r || std::max(pa, std::max(pb, pc)) < -r;
+		};
+
+		dVec3 axes[3] = { dVec3(1.0, 0.0, 0.0), dVec3(0.0, 1.0, 0.0), dVec3(0.0, 0.0, 1.0) };
+		for (int i = 0; i < 3; ++i)
+		{
+			if (Separates(axes[i]))
+			{
+				return false;
+			}
+		}
+		if (Separates(e[0].Cross(e[1])))
+		{
+			return false;
+		}
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				if (Separates(axes[i].Cross(e[j])))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+ConvexDecomposition::ConvexDecomposition() :
+	m_nX(0), m_nY(0), m_nZ(0),
+	m_origin(0.0, 0.0, 0.0),
+	m_voxelSize(0.0)
+{
+	std::memset(&m_report, 0, sizeof(m_report));
+}
+
+ConvexDecomposition::~ConvexDecomposition()
+{
+	FreeHulls();
+}
+
+void ConvexDecomposition::FreeHulls()
+{
+	for (Mesh* hull : m_hulls)
+	{
+		delete hull;
+	}
+	m_hulls.clear();
+}
+
+ConvexDecomposition::Config ConvexDecomposition::DefaultConfig()
+{
+	Config config;
+	config.resolution = 64;
+	config.maxConcavity = 0.01;
+	config.maxHulls = 32;
+	config.nSplitCandidates = 8;
+	return config;
+}
+
+void ConvexDecomposition::VoxelCoords(int i, int c[3]) const
+{
+	c[0] = i % m_nX;
+	c[1] = (i / m_nX) % m_nY;
+	c[2] = i / (m_nX*m_nY);
+}
+
+void ConvexDecomposition::Voxelize(const fVec3* verts, int nVerts, const int* indices, int nTriangles, int resolution)
+{
+	assert(nVerts > 0 && resolution > 0);
+
+	dVec3 min(verts[0]);
+	dVec3 max(verts[0]);
+	for (int i = 1; i < nVerts; ++i)
+	{
+		for (int dim = 0; dim < 3; ++dim)
+		{
+			min[dim] = std::min(min[dim], (double)verts[i][dim]);
+			max[dim] = std::max(max[dim], (double)verts[i][dim]);
+		}
+	}
+	const dVec3 extent = max - min;
+	const double longest = std::max(extent.x, std::max(extent.y, extent.z));
+	assert(longest > 0.0);
+
+	// Leave an empty voxel (at least) on each side, from which the outside is filled
+	m_voxelSize = longest / (double)resolution;
+	m_origin = min - dVec3(1.0, 1.0, 1.0).Scale(m_voxelSize);
+	int n[3];
+	for (int dim = 0; dim < 3; ++dim)
+	{
+		n[dim] = (int)std::ceil(extent[dim] / m_voxelSize) + 3;
+	}
+	m_nX = n[0];
+	m_nY = n[1];
+	m_nZ = n[2];
+	m_voxels.assign(m_nX*m_nY*m_nZ, VOXEL_EMPTY);
+
+	// The surface: the voxels the triangles overlap
+
+	const double halfSize = 0.5*m_voxelSize*(1.0 + 1e-6);
+	for (int i = 0; i < nTriangles; ++i)
+	{
+		dVec3 v[3];
+		int lo[3];
+		int hi[3];
+		for (int j = 0; j < 3; ++j)
+		{
+			v[j] = dVec3(verts[indices[3 * i + j]]);
+		}
+		for (int dim = 0; dim < 3; ++dim)
+		{
+			const double vMin = std::min(v[0][dim], std::min(v[1][dim], v[2][dim]));
+			const double vMax = std::max(v[0][dim], std::max(v[1][dim], v[2][dim]));
+			lo[dim] = std::max(1, (int)std::floor((vMin - m_origin[dim]) / m_voxelSize - 1e-6));
+			hi[dim] = std::min(n[dim] - 2, (int)std::floor((vMax - m_origin[dim]) / m_voxelSize + 1e-6));
+		}
+		for (int z = lo[2]; z <= hi[2]; ++z)
+		{
+			for (int y = lo[1]; y <= hi[1]; ++y)
+			{
+				for (int x = lo[0]; x <= hi[0]; ++x)
+				{
+					unsigned char& voxel = m_voxels[VoxelIndex(x, y, z)];
+					const dVec3 center = m_origin + dVec3((double)x + 0.5, (double)y + 0.5, (double)z + 0.5).Scale(m_voxelSize);
+					if (voxel == VOXEL_EMPTY && TriangleOverlapsCube(v, center, halfSize))
+					{
+						voxel = VOXEL_SOLID;
+					}
+				}
+			}
+		}
+	}
+
+	// The interior: whatever can't be reached from the corner of the grid without crossing the surface
+
+	std::vector<int> stack;
+	stack.push_back(0);
+	m_voxels[0] = VOXEL_OUTSIDE;
+	while (!stack.empty())
+	{
+		const int i = stack.back();
+		stack.pop_back();
+		int c[3];
+		VoxelCoords(i, c);
+		const int neighbours[6][3] =
+		{
+			{ c[0] - 1, c[1], c[2] }, { c[0] + 1, c[1], c[2] },
+			{ c[0], c[1] - 1, c[2] }, { c[0], c[1] + 1, c[2] },
+			{ c[0], c[1], c[2] - 1 }, { c[0], c[1], c[2] + 1 }
+		};
+		for (int j = 0; j < 6; ++j)
+		{
+			const int* d = neighbours[j];
+			if (d[0] < 0 || d[0] >= m_nX || d[1] < 0 || d[1] >= m_nY || d[2] < 0 || d[2] >= m_nZ)
+			{
+				continue;
+			}
+			const int k = VoxelIndex(d[0], d[1], d[2]);
+			if (m_voxels[k] == VOXEL_EMPTY)
+			{
+				m_voxels[k] = VOXEL_OUTSIDE;
+				stack.push_back(k);
+			}
+		}
+	}
+
+	for (unsigned char& voxel : m_voxels)
+	{
+		voxel = voxel == VOXEL_OUTSIDE ? VOXEL_EMPTY : VOXEL_SOLID;
+	}
+}
+
+void ConvexDecomposition::FindConnectedPieces(const Piece& piece, std::vector<Piece>& pieces)
+{
+	for (int i : piece)
+	{
+		m_voxels[i] = VOXEL_PENDING;
+	}
+
+	// Solid voxels are never on the boundary of the grid, so their neighbours are all in it
+	const int steps[6] = { -1, 1, -m_nX, m_nX, -m_nX*m_nY, m_nX*m_nY };
+
+	std::vector<int> stack;
+	for (int seed : piece)
+	{
+		if (m_voxels[seed] != VOXEL_PENDING)
+		{
+			continue;
+		}
+		pieces.push_back(Piece());
+		Piece& connected = pieces.back();
+
+		m_voxels[seed] = VOXEL_SOLID;
+		stack.push_back(seed);
+		while (!stack.empty())
+		{
+			const int i = stack.back();
+			stack.pop_back();
+			connected.push_back(i);
+			for (int j = 0; j < 6; ++j)
+			{
+				const int k = i + steps[j];
+				if (m_voxels[k] == VOXEL_PENDING)
+				{
+					m_voxels[k] = VOXEL_SOLID;
+					stack.push_back(k);
+				}
+			}
+		}
+	}
+}
+
+int ConvexDecomposition::GetHullPoints(const Piece& piece, int axis, int cut, bool below, double inset, std::vector<fVec3>& points) const
+{
+	// The first and last voxel of each row (along x)
+	std::vector<int> rowMin(m_nY*m_nZ, m_nX);
+	std::vector<int> rowMax(m_nY*m_nZ, -1);
+	int nKept = 0;
+	for (int i : piece)
+	{
+		int c[3];
+		VoxelCoords(i, c);
+		if (axis >= 0 && (c[axis] < cut) != below)
+		{
+			continue;
+		}
+		const int row = c[2] * m_nY + c[1];
+		rowMin[row] = std::min(rowMin[row], c[0]);
+		rowMax[row] = std::max(rowMax[row], c[0]);
+		nKept++;
+	}
+
+	// The corners are gathered as indices into a grid of twice the resolution (the low and high corner along each axis of
+	// each voxel), so that the voxels that are both first and last in their row don't add their corners twice. Inset
+	// corners are a voxel's own. Otherwise the high corner of a voxel is the low corner of the next, and goes by its index.
+
+	const int nCornersX = 2 * m_nX + 1;
+	const int nCornersY = 2 * m_nY + 1;
+	const int high = inset > 0.0 ? 1 : 2;
+	std::vector<int> corners;
+	for (int row = 0; row < m_nY*m_nZ; ++row)
+	{
+		if (rowMax[row] < 0)
+		{
+			continue;
+		}
+		const int x[2] = { 2 * rowMin[row], 2 * rowMax[row] + high };
+		const int y[2] = { 2 * (row % m_nY), 2 * (row % m_nY) + high };
+		const int z[2] = { 2 * (row / m_nY), 2 * (row / m_nY) + high };
+		for (int corner = 0; corner < 8; ++corner)
+		{
+			corners.push_back((z[corner >> 2] * nCornersY + y[(corner >> 1) & 1])*nCornersX + x[corner & 1]);
+		}
+	}
+	std::sort(corners.begin(), corners.end());
+	corners.erase(std::unique(corners.begin(), corners.end()), corners.end());
+
+	points.clear();
+	for (int corner : corners)
+	{
+		const int c[3] = { corner % nCornersX, (corner / nCornersX) % nCornersY, corner / (nCornersX*nCornersY) };
+		dVec3 x;
+		for (int dim = 0; dim < 3; ++dim)
+		{
+			x[dim] = (double)(c[dim] / 2) + ((c[dim] & 1) ? 1.0 - inset : inset);
+		}
+		points.push_back(fVec3(m_origin + x.Scale(m_voxelSize)));
+	}
+	return nKept;
+}
+
+double ConvexDecomposition::HullVolume(const std::vector<fVec3>& points) const
+{
+	QuickHull qh(points.data(), (int)points.size(), 0.001*m_voxelSize);
+	qh.BuildHull();
+	Mesh mesh;
+	qh.ExportConvexMesh(mesh);
+	double volume;
+	mesh.CenterOfMassLocal_Solid(volume);
+	return volume;
+}
+
+void ConvexDecomposition::Decompose(const fVec3* verts, int nVerts, const int* indices, int nTriangles, const Config& config, ThreadPool* threadPool)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	assert(config.maxHulls > 0);
+
+	FreeHulls();
+	std::memset(&m_report, 0, sizeof(m_report));
+
+	auto ParallelFor = [&](int nTasks, const std::function<void(int iTask)>& task)
+	{
+		if (threadPool != nullptr)
+		{
+			threadPool->ParallelFor(nTasks, task);
+			return;
+		}
+		for (int i = 0; i < nTasks; ++i)
+		{
+			task(i);
+		}
+	};
+
+	const Clock::time_point t0 = Clock::now();
+	Voxelize(verts, nVerts, indices, nTriangles, config.resolution);
+	const Clock::time_point t1 = Clock::now();
+
+	std::vector<Piece> pieces;
+	{
+		Piece solid;
+		for (int i = 0; i < (int)m_voxels.size(); ++i)
+		{
+			if (m_voxels[i] == VOXEL_SOLID)
+			{
+				solid.push_back(i);
+			}
+		}
+		m_report.nVoxels = (int)solid.size();
+		FindConnectedPieces(solid, pieces);
+	}
+
+	// A mesh in more disconnected parts than hulls allowed has its smallest parts merged into the nearest (by their centers)
+
+	if ((int)pieces.size() > config.maxHulls)
+	{
+		std::vector<dVec3> centers(pieces.size(), dVec3(0.0, 0.0, 0.0));
+		for (int i = 0; i < (int)pieces.size(); ++i)
+		{
+			for (int j : pieces[i])
+			{
+				int c[3];
+				VoxelCoords(j, c);
+				centers[i] = centers[i] + dVec3((double)c[0], (double)c[1], (double)c[2]);
+			}
+			centers[i] = centers[i].Scale(1.0 / (double)pieces[i].size());
+		}
+		while ((int)pieces.size() > config.maxHulls)
+		{
+			int smallest = 0;
+			for (int i = 1; i < (int)pieces.size(); ++i)
+			{
+				if (pieces[i].size() < pieces[smallest].size())
+				{
+					smallest = i;
+				}
+			}
+			int nearest = -1;
+			double nearestDist2 = DBL_MAX;
+			for (int i = 0; i < (int)pieces.size(); ++i)
+			{
+				const dVec3 d = centers[i] - centers[smallest];
+				if (i != smallest && d.Dot(d) < nearestDist2)
+				{
+					nearest = i;
+					nearestDist2 = d.Dot(d);
+				}
+			}
+			const double wSmallest = (double)pieces[smallest].size();
+			const double wNearest = (double)pieces[nearest].size();
+			centers[nearest] = (centers[nearest].Scale(wNearest) + centers[smallest].Scale(wSmallest)).Scale(1.0 / (wNearest + wSmallest));
+			pieces[nearest].insert(pieces[nearest].end(), pieces[smallest].begin(), pieces[smallest].end());
+			pieces[smallest].swap(pieces.back());
+			centers[smallest] = centers.back();
+			pieces.pop_back();
+			centers.pop_back();
+		}
+	}
+
+	const double voxelVolume = m_voxelSize*m_voxelSize*m_voxelSize;
+	m_report.voxelVolume = voxelVolume*(double)m_report.nVoxels;
+	const double tolerance = config.maxConcavity*m_report.voxelVolume;
+
+	// How much the hull of each piece exceeds the piece. The pieces that are already evaluated come first.
+	std::vector<double> concavity;
+
+	struct Split
+	{
+		int iPiece;
+		int axis;
+		int cut;
+		double cost; // the total concavity of the two halves
+	};
+	std::vector<Split> splits;
+
+	while (true)
+	{
+		const int nEvaluated = (int)concavity.size();
+		concavity.resize(pieces.size());
+		ParallelFor((int)pieces.size() - nEvaluated, [&](int iTask)
+		{
+			const int i = nEvaluated + iTask;
+			std::vector<fVec3> points;
+			const int n = GetHullPoints(pieces[i], -1, 0, true, 0.0, points);
+			concavity[i] = HullVolume(points) - voxelVolume*(double)n;
+		});
+
+		// Split the least convex pieces first, while there's room for more hulls
+
+		std::vector<int> toSplit;
+		for (int i = 0; i < (int)pieces.size(); ++i)
+		{
+			if (concavity[i] > tolerance && pieces[i].size() > 1)
+			{
+				toSplit.push_back(i);
+			}
+		}
+		const int nRoom = config.maxHulls - (int)pieces.size();
+		if (toSplit.empty() || nRoom <= 0)
+		{
+			break;
+		}
+		std::sort(toSplit.begin(), toSplit.end(), [&](int a, int b) { return concavity[a] > concavity[b]; });
+		if ((int)toSplit.size() > nRoom)
+		{
+			toSplit.resize(nRoom);
+		}
+
+		// The candidate planes are spread evenly over the extent of each piece, between its voxels
+
+		splits.clear();
+		for (int iPiece : toSplit)
+		{
+			int lo[3] = { m_nX, m_nY, m_nZ };
+			int hi[3] = { -1, -1, -1 };
+			for (int i : pieces[iPiece])
+			{
+				int c[3];
+				VoxelCoords(i, c);
+				for (int dim = 0; dim < 3; ++dim)
+				{
+					lo[dim] = std::min(lo[dim], c[dim]);
+					hi[dim] = std::max(hi[dim], c[dim]);
+				}
+			}
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				int prevCut = lo[axis];
+				for (int k = 1; k <= config.nSplitCandidates; ++k)
+				{
+					const int cut = lo[axis] + (hi[axis] - lo[axis] + 1)*k / (config.nSplitCandidates + 1);
+					if (cut > prevCut && cut <= hi[axis])
+					{
+						Split split;
+						split.iPiece = iPiece;
+						split.axis = axis;
+						split.cut = cut;
+						split.cost = DBL_MAX;
+						splits.push_back(split);
+						prevCut = cut;
+					}
+				}
+			}
+		}
+
+		ParallelFor((int)splits.size(), [&](int iTask)
+		{
+			Split& split = splits[iTask];
+			const Piece& piece = pieces[split.iPiece];
+			std::vector<fVec3> points;
+			split.cost = 0.0;
+			for (int side = 0; side < 2; ++side)
+			{
+				const int n = GetHullPoints(piece, split.axis, split.cut, side == 0, 0.0, points);
+				if (n > 0)
+				{
+					split.cost += HullVolume(points) - voxelVolume*(double)n;
+				}
+			}
+		});
+
+		std::vector<const Split*> best(pieces.size(), nullptr);
+		for (const Split& split : splits)
+		{
+			const Split*& b = best[split.iPiece];
+			if (b == nullptr || split.cost < b->cost)
+			{
+				b = &split;
+			}
+		}
+
+		// Each piece that's split is replaced by the connected pieces of its halves, which can be more than two. Splits that
+		// would take the pieces past maxHulls aren't made, going from the least convex piece to the most convex.
+
+		std::vector<std::vector<Piece>> splitPieces(pieces.size());
+		int nPieces = (int)pieces.size();
+		for (int i : toSplit)
+		{
+			if (best[i] == nullptr)
+			{
+				continue;
+			}
+			Piece halves[2];
+			for (int j : pieces[i])
+			{
+				int c[3];
+				VoxelCoords(j, c);
+				halves[c[best[i]->axis] < best[i]->cut ? 0 : 1].push_back(j);
+			}
+			FindConnectedPieces(halves[0], splitPieces[i]);
+			FindConnectedPieces(halves[1], splitPieces[i]);
+			if (nPieces - 1 + (int)splitPieces[i].size() > config.maxHulls)
+			{
+				splitPieces[i].clear();
+				continue;
+			}
+			nPieces += (int)splitPieces[i].size() - 1;
+		}
+		if (nPieces == (int)pieces.size())
+		{
+			break;
+		}
+
+		// The pieces that aren't split keep their place (and concavity), and the new pieces are evaluated next
+
+		std::vector<Piece> next;
+		std::vector<double> nextConcavity;
+		for (int i = 0; i < (int)pieces.size(); ++i)
+		{
+			if (splitPieces[i].empty())
+			{
+				next.push_back(Piece());
+				next.back().swap(pieces[i]);
+				nextConcavity.push_back(concavity[i]);
+			}
+		}
+		for (std::vector<Piece>& split : splitPieces)
+		{
+			for (Piece& piece : split)
+			{
+				next.push_back(Piece());
+				next.back().swap(piece);
+			}
+		}
+		pieces.swap(next);
+		concavity.swap(nextConcavity);
+	}
+	const Clock::time_point t2 = Clock::now();
+
+	m_hulls.assign(pieces.size(), nullptr);
+	ParallelFor((int)pieces.size(), [&](int i)
+	{
+		std::vector<fVec3> points;
+		GetHullPoints(pieces[i], -1, 0, true, CONVEXDECOMPOSITION_HULL_INSET, points);
+		QuickHull qh(points.data(), (int)points.size(), 0.001*m_voxelSize);
+		qh.BuildHull();
+		m_hulls[i] = new Mesh;
+		qh.ExportConvexMesh(*m_hulls[i]);
+	});
+	const Clock::time_point t3 = Clock::now();
+
+	m_report.voxelizeMilliseconds = std::chrono::duration<double, std::milli>(t1 - t0).count();
+	m_report.splitMilliseconds = std::chrono::duration<double, std::milli>(t2 - t1).count();
+	m_report.hullMilliseconds = std::chrono::duration<double, std::milli>(t3 - t2).count();
+	ReportHulls();
+}
+
+void ConvexDecomposition::ReportHulls()
+{
+	m_report.nHulls = (int)m_hulls.size();
+	m_report.nHullVerts = 0;
+	m_report.hullBytes = 0;
+	m_report.hullVolume = 0.0;
+	for (const Mesh* hull : m_hulls)
+	{
+		double volume;
+		hull->CenterOfMassLocal_Solid(volume);
+		m_report.hullVolume += volume;
+		m_report.nHullVerts += hull->GetNumVerts();
+		m_report.hullBytes +=
+			hull->GetNumHalfEdges()*(int)sizeof(Mesh::HalfEdge) +
+			hull->GetNumFaces()*(int)sizeof(Mesh::Face) +
+			hull->GetNumVerts()*(int)sizeof(fVec3);
+	}
+
+	// Time support queries in directions spread evenly over the sphere (a Fibonacci spiral)
+	const int nDirections = 1024;
+	std::vector<dVec3> directions(nDirections);
+	for (int i = 0; i < nDirections; ++i)
+	{
+		const double z = 1.0 - 2.0*((double)i + 0.5) / (double)nDirections;
+		const double r = sqrt(std::max(0.0, 1.0 - z*z));
+		const double phi = 2.399963229728653*(double)i;
+		directions[i] = dVec3(r*cos(phi), r*sin(phi), z);
+	}
+	volatile double sink = 0.0;
+	const std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+	for (const dVec3& v : directions)
+	{
+		double best = -DBL_MAX;
+		for (const Mesh* hull : m_hulls)
+		{
+			best = std::max(best, hull->SupportLocal(v).Dot(v));
+		}
+		sink = sink + best;
+	}
+	const std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	m_report.supportNanoseconds = std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)nDirections;
+}
+
+int ConvexDecomposition::GetNHulls() const
+{
+	return (int)m_hulls.size();
+}
+
+const Mesh* ConvexDecomposition::GetHull(int i) const
+{
+	return m_hulls[i];
+}
+
+const ConvexDecomposition::Report& ConvexDecomposition::GetReport() const
+{
+	return m_report;
+}
+
+void ConvexDecomposition::CreateCompound(Compound& compound) const
+{
+	std::vector<Compound::Child> children(m_hulls.size());
+	for (int i = 0; i < (int)m_hulls.size(); ++i)
+	{
+		children[i].geom = m_hulls[i];
+		children[i].pos = dVec3(0.0, 0.0, 0.0);
+		children[i].rot = dQuat::Identity();
+	}
+	compound.Create(children.data(), (int)children.size());
+}
+
+bool ConvexDecomposition::WriteCooked(const char* fileName) const
+{
+	CookedListHeader header;
+	std::memcpy(header.magic, g_cookedListMagic, sizeof(header.magic));
+	header.version = CONVEXDECOMPOSITION_COOKED_VERSION;
+	header.nHulls = (int)m_hulls.size();
+
+	std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		return false;
+	}
+	file.write((const char*)&header, sizeof(header));
+	if (!file.good())
+	{
+		return false;
+	}
+
+	for (int i = 0; i < (int)m_hulls.size(); ++i)
+	{
+		if (!m_hulls[i]->WriteCooked(HullFileName(fileName, i).c_str()))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ConvexDecomposition::LoadCooked(const char* fileName)
+{
+	CookedListHeader header;
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file.read((char*)&header, sizeof(header)) ||
+		std::memcmp(header.magic, g_cookedListMagic, sizeof(header.magic)) != 0 ||
+		header.version != CONVEXDECOMPOSITION_COOKED_VERSION ||
+		header.nHulls < 0)
+	{
+		return false;
+	}
+
+	FreeHulls();
+	std::memset(&m_report, 0, sizeof(m_report));
+	for (int i = 0; i < header.nHulls; ++i)
+	{
+		Mesh* hull = new Mesh;
+		if (!hull->LoadCooked(HullFileName(fileName, i).c_str()))
+		{
+			delete hull;
+			FreeHulls();
+			return false;
+		}
+		m_hulls.push_back(hull);
+	}
+	ReportHulls();
+	return true;
+}
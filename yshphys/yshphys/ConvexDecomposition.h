@@ -0,0 +1,111 @@
+#pragma once
+#include "Mesh.h"
+
+class Compound;
+class ThreadPool;
+
+// The version of the list of hulls written by ConvexDecomposition::WriteCooked
+#define CONVEXDECOMPOSITION_COOKED_VERSION 1
+// How far inside its voxel (as a fraction of the voxel size) each point of a final hull is
+#define CONVEXDECOMPOSITION_HULL_INSET 0.25
+
+// Approximate convex decomposition, for cooking a concave mesh (closed, and wound consistently) into a Compound of convex
+// Mesh hulls offline. It's voxel based:
+//   1. The mesh is voxelized: the voxels that its triangles overlap are its surface, and the voxels that can't be reached
+//      from outside the mesh without crossing the surface are its interior.
+//   2. The solid voxels are split into connected pieces. Each piece whose convex hull exceeds its own volume by more than
+//      the concavity tolerance is split in two by the axis-aligned plane (out of a few candidates per axis) that minimizes
+//      the concavity of the two halves, and each half is split into connected pieces again. This repeats until every piece
+//      is convex enough, or no split is left that keeps the pieces within maxHulls (if the mesh itself is in more
+//      disconnected parts than that, its smallest parts are merged into the nearest). Concavity is measured on the full
+//      voxels, so that it's 0 for a piece that fills its hull. It includes the staircase of the voxels along curved
+//      surfaces, which shrinks with the resolution.
+//   3. Each piece becomes the QuickHull of the corners of its voxels, pulled in towards the voxels' centers. The surface
+//      voxels straddle the mesh's surface, so their full corners would overshoot it by up to a voxel.
+// The candidate planes of all the pieces being split, and the final hulls, are spread across the threads of a ThreadPool.
+//
+// Only the extreme voxels of each row (along x) of a piece can be on its hull, so those are all that QuickHull is given.
+
+class ConvexDecomposition
+{
+public:
+	struct Config
+	{
+		int resolution; // the number of voxels along the longest side of the mesh's bounds
+		double maxConcavity; // pieces are split until their hull exceeds them by at most this fraction of the mesh's volume
+		int maxHulls; // at least 1
+		int nSplitCandidates; // the number of planes tried along each axis when a piece is split
+	};
+
+	// The quality (volume error) and size of the decomposition, and its cost, both to build and at runtime
+	struct Report
+	{
+		double voxelizeMilliseconds;
+		double splitMilliseconds;
+		double hullMilliseconds;
+
+		int nVoxels; // solid
+		double voxelVolume;
+		double hullVolume; // the sum of the volumes of the hulls
+
+		int nHulls;
+		int nHullVerts;
+		int hullBytes; // the vertices, halfedges, and faces of the hulls
+
+		double supportNanoseconds; // a support query against all of the hulls (as for a Compound of them)
+	};
+
+	ConvexDecomposition();
+	~ConvexDecomposition();
+
+	ConvexDecomposition(const ConvexDecomposition&) = delete;
+	ConvexDecomposition& operator = (const ConvexDecomposition&) = delete;
+
+	static Config DefaultConfig();
+
+	// The triangles have 3 vertex indices each. threadPool may be null.
+	void Decompose(const fVec3* verts, int nVerts, const int* indices, int nTriangles, const Config& config, ThreadPool* threadPool);
+
+	int GetNHulls() const;
+	const Mesh* GetHull(int i) const;
+	const Report& GetReport() const;
+
+	// Makes the hulls the children of compound. The decomposition keeps the hulls, and must outlive the compound.
+	void CreateCompound(Compound& compound) const;
+
+	// Cooks hull i to "fileName.i" (see Mesh::WriteCooked), and lists the hulls in fileName. Both return false on failure.
+	// Loading only reports on the hulls, since the voxels are gone.
+	bool WriteCooked(const char* fileName) const;
+	bool LoadCooked(const char* fileName);
+
+private:
+	typedef std::vector<int> Piece; // the indices of a piece's voxels in the grid
+
+	void Voxelize(const fVec3* verts, int nVerts, const int* indices, int nTriangles, int resolution);
+	// Splits the voxels of piece into 6-connected pieces, appended to pieces
+	void FindConnectedPieces(const Piece& piece, std::vector<Piece>& pieces);
+	// The corners (inset by the given fraction of a voxel) of the extreme voxels of each row of piece, keeping only the voxels
+	// below cut along axis if below is set, or those at or above it if not (or all of them if axis is -1). Returns the number
+	// of voxels kept.
+	int GetHullPoints(const Piece& piece, int axis, int cut, bool below, double inset, std::vector<fVec3>& points) const;
+	double HullVolume(const std::vector<fVec3>& points) const;
+	// Fills in the size and runtime cost of the hulls in the report
+	void ReportHulls();
+
+	int VoxelIndex(int x, int y, int z) const { return (z*m_nY + y)*m_nX + x; }
+	void VoxelCoords(int i, int c[3]) const;
+
+	void FreeHulls();
+
+	// The grid has an empty voxel all around the mesh
+	int m_nX;
+	int m_nY;
+	int m_nZ;
+	dVec3 m_origin; // the min corner of voxel (0, 0, 0)
+	double m_voxelSize;
+	std::vector<unsigned char> m_voxels;
+
+	std::vector<Mesh*> m_hulls;
+
+	Report m_report;
+};
@@ -37,6 +37,37 @@ dVec3 Cylinder::SupportLocal(const dVec3& v) const
 		m_halfHeight*MathUtils::sgn(v.z));
 }
 
+int Cylinder::SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const
+{
+	const double vv = v.Dot(v);
+	const double tol2 = SUPPORTFEATURE_PARALLEL_TOL*SUPPORTFEATURE_PARALLEL_TOL;
+	const double rr = v.x*v.x + v.y*v.y;
+
+	if (maxVerts >= 3 && rr < tol2*vv)
+	{
+		// v is along the axis: the cap, counter-clockwise about its outward normal
+
+		const int n = maxVerts < SUPPORTFEATURE_RING_VERTS ? maxVerts : SUPPORTFEATURE_RING_VERTS;
+		const double s = v.z < 0.0 ? -1.0 : 1.0;
+		for (int i = 0; i < n; ++i)
+		{
+			const double phi = s*2.0*dPI*(double)i / (double)n;
+			verts[i] = dVec3(m_radius*cos(phi), m_radius*sin(phi), s*m_halfHeight);
+		}
+		return n;
+	}
+	else if (maxVerts >= 2 && v.z*v.z < tol2*vv)
+	{
+		// v is perpendicular to the axis: the side segment
+
+		const double k = m_radius / sqrt(rr);
+		verts[0] = dVec3(v.x*k, v.y*k, -m_halfHeight);
+		verts[1] = dVec3(v.x*k, v.y*k, m_halfHeight);
+		return 2;
+	}
+	return Geometry::SupportFeatureLocal(v, verts, maxVerts);
+}
+
 Polygon Cylinder::IntersectPlaneLocal(const dVec3& planeOrigin, const dVec3& planeNormal, const dVec3& x, const dVec3& y) const
 {
 	Polygon poly;
@@ -11,6 +11,7 @@ public:
 	void SetRadius(double radius);
 
 	virtual dVec3 SupportLocal(const dVec3& v) const;
+	virtual int SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const;
 
 	virtual Polygon IntersectPlaneLocal(const dVec3& planeOrigin, const dVec3& planeNormal, const dVec3& xAxis, const dVec3& yAxis) const;
 
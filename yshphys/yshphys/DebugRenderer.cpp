@@ -3,7 +3,15 @@
 
 #include "Picker.h"
 
-DebugRenderer::DebugRenderer()
+DebugRenderer::DebugRenderer() : m_picker(nullptr)
+{
+}
+
+DebugRenderer::~DebugRenderer()
+{
+}
+
+DebugRenderer_GL::DebugRenderer_GL()
 {
 	glGenVertexArrays(1, &m_VAO);
 	glGenBuffers(1, &m_xVBO);
@@ -29,7 +37,7 @@ DebugRenderer::DebugRenderer()
 }
 
 
-DebugRenderer::~DebugRenderer()
+DebugRenderer_GL::~DebugRenderer_GL()
 {
 	glBindVertexArray(m_VAO);
 	glDisableVertexAttribArray(0);
@@ -42,7 +50,7 @@ DebugRenderer::~DebugRenderer()
 	glDeleteBuffers(1, &m_IBO);
 }
 
-void DebugRenderer::DrawObjectsToGBuffer(const Viewport& viewport) const
+void DebugRenderer_GL::DrawObjectsToGBuffer(const Viewport& viewport) const
 {
 	const fMat44 viewMatrix = viewport.CreateViewMatrix();
 	const fMat44 projectionMatrix = viewport.CreateProjectionMatrix();
@@ -56,9 +64,7 @@ void DebugRenderer::DrawObjectsToGBuffer(const Viewport& viewport) const
 	{
 		const DebugDrawData& data = m_objects[i];
 
-		const fMat44 modelMatrix =
-			HomogeneousTransformation_t<float>::CreateTranslation(data.pos)*
-			HomogeneousTransformation_t<float>::CreateRotation(data.rot);
+		const fMat44 modelMatrix = fHomogeneousTransformation::CreateRigidTransform(data.rot, data.pos);
 
 		glBindBuffer(GL_ARRAY_BUFFER, m_xVBO);
 		glBufferData(GL_ARRAY_BUFFER, 3 * data.nVertices * sizeof(GL_FLOAT), data.vertices, GL_DYNAMIC_DRAW);
@@ -97,6 +103,11 @@ void DebugRenderer::EvictObjects()
 	m_objects.clear();
 }
 
+void DebugRenderer::DrawRecorded(const DebugRenderer& recording)
+{
+	m_objects.insert(m_objects.end(), recording.m_objects.begin(), recording.m_objects.end());
+}
+
 void DebugRenderer::DrawLine(const fVec3& start, const fVec3& end, const fVec3& color)
 {
 	DebugDrawData data;
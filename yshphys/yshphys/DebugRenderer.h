@@ -9,10 +9,14 @@
 
 class Picker;
 
+// Collects one time draws. This class only records them, so it can be drawn to on any thread (e.g. by physics, into a
+// snapshot that's handed to the renderer), and replayed into the renderer's own with DrawRecorded.
 class DebugRenderer
 {
-	friend class RenderScene;
 public:
+	DebugRenderer();
+	virtual ~DebugRenderer();
+
 	// The following functions are for one time draws. The caller has no control over the shader. Everything is drawn with flat colors.
 	// Intended for debugging and should be used sparingly as these shuttle memory to the GPU each time they are called.
 	void DrawTriangle(const fVec3& A, const fVec3& B, const fVec3& C, const fVec3& color, bool wireFrame, bool shaded = true);
@@ -23,16 +27,14 @@ public:
 	void DrawBVTree(const BVTree& tree, const fVec3& color);
 	void DrawPicker(const Picker& picker, const fVec3& color);
 
+	// Draws everything that was drawn to recording (since it was last evicted)
+	void DrawRecorded(const DebugRenderer& recording);
+	void EvictObjects();
+
 	Picker* m_picker;
 
 protected:
 
-	DebugRenderer();
-	virtual ~DebugRenderer();
-
-	void DrawObjectsToGBuffer(const Viewport& viewport) const;
-	void EvictObjects();
-
 	struct DebugDrawData
 	{
 		float vertices[SINGLE_DRAW_VERTEX_BUFFER_SIZE][3];
@@ -50,12 +52,24 @@ protected:
 	};
 
 	std::vector<DebugDrawData> m_objects;
+
+	void DrawPolygon(const fVec3* verts, int nVerts, const fVec3& pos, const fQuat& rot, const fVec3& color, bool wireFrame, bool shaded = true);
+};
+
+// The render scene's DebugRenderer, which draws what it collects with OpenGL (on the thread that owns the GL context)
+class DebugRenderer_GL : public DebugRenderer
+{
+	friend class RenderScene;
+protected:
+
+	DebugRenderer_GL();
+	virtual ~DebugRenderer_GL();
+
+	void DrawObjectsToGBuffer(const Viewport& viewport) const;
+
 	GLuint m_VAO;
 	GLuint m_xVBO;
 	GLuint m_nVBO;
 	GLuint m_IBO;
 	Shader_FlatUniformColor m_shader;
-
-	void DrawPolygon(const fVec3* verts, int nVerts, const fVec3& pos, const fQuat& rot, const fVec3& color, bool wireFrame, bool shaded = true);
 };
-
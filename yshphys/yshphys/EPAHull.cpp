@@ -25,16 +25,17 @@ void EPAHull::FaceHeap::HeapifyDown(int index)
 
 	while (true)
 	{
+		const int nFaces = (int)m_faces.size();
 		int iLeft = 2 * (i + 1) - 1;
 		int iRight = iLeft + 1;
-		if (iRight > m_nFaces)
+		if (iRight > nFaces)
 		{
 			break;
 		}
 		else
 		{
 			int j;
-			if (iRight == m_nFaces)
+			if (iRight == nFaces)
 			{
 				j = iLeft;
 			}
@@ -63,21 +64,25 @@ void EPAHull::FaceHeap::HeapifyDown(int index)
 }
 void EPAHull::FaceHeap::RemoveFaceFromHeap(Face* face)
 {
-	const int& i = face->iHeap;
 	RemoveFaceFromHeap(face->iHeap);
 }
 void EPAHull::FaceHeap::RemoveFaceFromHeap(int i)
 {
 	m_faces[i]->iHeap = -1;
-	m_faces[i] = m_faces[--m_nFaces];
-	m_faces[i]->iHeap = i;
-	HeapifyDown(i);
+	m_faces[i] = m_faces.back();
+	m_faces.pop_back();
+	if (i < (int)m_faces.size())
+	{
+		m_faces[i]->iHeap = i;
+		HeapifyUp(i);
+		HeapifyDown(m_faces[i]->iHeap);
+	}
 }
 void EPAHull::FaceHeap::Push(Face* face)
 {
-	face->iHeap = m_nFaces;
-	m_faces[m_nFaces] = face;
-	HeapifyUp(m_nFaces++);
+	face->iHeap = (int)m_faces.size();
+	m_faces.push_back(face);
+	HeapifyUp(face->iHeap);
 }
 void EPAHull::FaceHeap::Pop()
 {
@@ -88,14 +93,36 @@ EPAHull::Face* EPAHull::FaceHeap::Top() const
 	return m_faces[0];
 }
 
-EPAHull::EPAHull(
+EPAHull::EPAHull()
+{
+}
+
+EPAHull& EPAHull::ThreadWorkspace()
+{
+	thread_local EPAHull workspace;
+	return workspace;
+}
+
+void EPAHull::Reset(
 	const Geometry* geom0, const dVec3& pos0, const dQuat& rot0,
 	const Geometry* geom1, const dVec3& pos1, const dQuat& rot1,
-	const GJKSimplex& tetrahedron) :
-	m_nHorizonEdges(0)
+	const GJKSimplex& tetrahedron)
 {
 	assert(tetrahedron.GetNumPoints() == 4);
 
+	for (HalfEdge* edge : m_horizonEdges)
+	{
+		edge->isHorizon = false;
+	}
+	m_horizonEdges.clear();
+
+	m_faceHeap.Clear();
+	m_freeFaces.clear();
+	m_freeEdges.clear();
+	m_faces.Clear();
+	m_edges.Clear();
+	m_verts.Clear();
+
 	m_geom0.geom = geom0;
 	m_geom0.pos = pos0;
 	m_geom0.rot = rot0;
@@ -104,15 +131,15 @@ EPAHull::EPAHull(
 	m_geom1.pos = pos1;
 	m_geom1.rot = rot1;
 
-	for (int e = 0; e < EPAHULL_MAXEDGES; ++e)
+	for (int i = 0; i < 4; ++i)
 	{
-		m_edges[e].index = e;
+		*m_verts.Allocate() = fMinkowskiPoint(tetrahedron.m_pts[i]);
+		m_faces.Allocate()->Reset();
+	}
+	for (int e = 0; e < 12; ++e)
+	{
+		m_edges.Allocate();
 	}
-
-	m_verts[0] = fMinkowskiPoint(tetrahedron.m_pts[0]);
-	m_verts[1] = fMinkowskiPoint(tetrahedron.m_pts[1]);
-	m_verts[2] = fMinkowskiPoint(tetrahedron.m_pts[2]);
-	m_verts[3] = fMinkowskiPoint(tetrahedron.m_pts[3]);
 
 	for (int i = 0; i < 4; ++i)
 	{
@@ -184,52 +211,30 @@ EPAHull::EPAHull(
 		m_faceHeap.Push(&m_faces[f]);
 	}
 
-	for (int i = 0; i < EPAHULL_MAXFACES - 4; ++i)
-	{
-		m_freeFaces[i] = &m_faces[(EPAHULL_MAXFACES - 1) - i];
-	}
-	for (int i = 0; i < EPAHULL_MAXEDGES- 12; ++i)
-	{
-		m_freeEdges[i] = (EPAHULL_MAXEDGES - 1) - i;
-	}
-
-	m_nFreeFaces = EPAHULL_MAXFACES - 4;
-	m_nFreeEdges = EPAHULL_MAXEDGES - 12;
-
-	m_nVerts = 4;
 }
 
 void EPAHull::CarveHorizon(const fVec3& fEye, Face* visibleFace)
 {
 	const dVec3 dEye(fEye);
-	for (int i = 0; i < m_nHorizonEdges; ++i)
+	for (HalfEdge* edge : m_horizonEdges)
 	{
-		m_horizonEdges[i]->isHorizon = false;
+		edge->isHorizon = false;
 	}
-	m_nHorizonEdges = 0;
+	m_horizonEdges.clear();
 
-	struct EdgeStack
-	{
-	public:
-		void Push(HalfEdge* edge) { e[n++] = edge; }
-		HalfEdge* Pop() { return e[--n]; }
-		bool Empty() const { return n == 0; }
-	private:
-		HalfEdge* e[1024];
-		int n = 0;
-	}
-	edgeStack;
+	// Both scratch vectors keep their capacity from previous expansions
+	m_edgeStack.clear();
+	m_visitedFaces.clear();
 
-	std::vector<Face*> visitedFaces;
 	auto MarkFaceAsVisited = [&](Face* face)
 	{
-		visitedFaces.push_back(face);
+		m_visitedFaces.push_back(face);
 		face->visited = true;
 	};
 
 	for (HalfEdge* e : { visibleFace->edge, visibleFace->edge->prev, visibleFace->edge->next })
 	{
-		edgeStack.Push(e);
+		m_edgeStack.push_back(e);
 		MarkFaceAsVisited(e->twin->face);
 	}
 	MarkFaceAsVisited(visibleFace);
@@ -238,14 +243,12 @@ void EPAHull::CarveHorizon(const fVec3& fEye, Face* visibleFace)
 	m_faceHeap.RemoveFaceFromHeap(visibleFace);
 	PushFreeFace(visibleFace);
 
-	int nFreedEdges = 0;
-	std::vector<HalfEdge*> freedEdges;
-
 	HalfEdge* horizonStart = nullptr;
 
-	while (!edgeStack.Empty())
+	while (!m_edgeStack.empty())
 	{
-		HalfEdge* edge = edgeStack.Pop();
+		HalfEdge* edge = m_edgeStack.back();
+		m_edgeStack.pop_back();
 		HalfEdge* twin = edge->twin;
 
 		Face* opposingFace = twin->face;
@@ -263,20 +266,16 @@ void EPAHull::CarveHorizon(const fVec3& fEye, Face* visibleFace)
 
 			if (!twin->prev->twin->face->visited)
 			{
-				edgeStack.Push(twin->prev);
+				m_edgeStack.push_back(twin->prev);
 				MarkFaceAsVisited(twin->prev->twin->face);
 			}
 			if (!twin->next->twin->face->visited)
 			{
-				edgeStack.Push(twin->next);
+				m_edgeStack.push_back(twin->next);
 				MarkFaceAsVisited(twin->next->twin->face);
 			}
 			PushFreeEdge(edge);
 			PushFreeEdge(twin);
-			nFreedEdges += 2;
-
-			freedEdges.push_back(edge);
-			freedEdges.push_back(twin);
 
 			opposingFace->visible = true;
 		}
@@ -289,8 +288,7 @@ void EPAHull::CarveHorizon(const fVec3& fEye, Face* visibleFace)
 	HalfEdge* edge = horizonStart;
 	do
 	{
-		assert(m_nHorizonEdges < EPAHULL_MAXHORIZONEDGES);
-		m_horizonEdges[m_nHorizonEdges++] = edge;
+		m_horizonEdges.push_back(edge);
 		edge->isHorizon = true;
 
 		HalfEdge* e0 = edge;
@@ -315,7 +313,7 @@ void EPAHull::CarveHorizon(const fVec3& fEye, Face* visibleFace)
 
 	} while (edge != horizonStart);
 
-	for (Face* face: visitedFaces)
+	for (Face* face : m_visitedFaces)
 	{
 		face->visible = false;
 		face->visited = false;
@@ -324,7 +322,8 @@ void EPAHull::CarveHorizon(const fVec3& fEye, Face* visibleFace)
 
 bool EPAHull::PatchHorizon(const fMinkowskiPoint* eye)
 {
-	for (int i = 0; i < m_nHorizonEdges; ++i)
+	const int nHorizonEdges = (int)m_horizonEdges.size();
+	for (int i = 0; i < nHorizonEdges; ++i)
 	{
 		HalfEdge* curr = m_horizonEdges[i];
 
@@ -370,10 +369,10 @@ bool EPAHull::PatchHorizon(const fMinkowskiPoint* eye)
 		next->prev = curr;
 	}
 
-	for (int i = 0; i < m_nHorizonEdges; ++i)
+	for (int i = 0; i < nHorizonEdges; ++i)
 	{
-		m_horizonEdges[i]->next->twin = m_horizonEdges[(i + 1) % m_nHorizonEdges]->prev;
-		m_horizonEdges[i]->prev->twin = m_horizonEdges[(i - 1 + m_nHorizonEdges) % m_nHorizonEdges]->next;
+		m_horizonEdges[i]->next->twin = m_horizonEdges[(i + 1) % nHorizonEdges]->prev;
+		m_horizonEdges[i]->prev->twin = m_horizonEdges[(i - 1 + nHorizonEdges) % nHorizonEdges]->next;
 	}
 	return true;
 }
@@ -400,17 +399,18 @@ bool EPAHull::Expand()
 		const fVec3 fEye(dEye);
 		CarveHorizon(fEye, closestFace);
 
-		fMinkowskiPoint* newVert = &m_verts[m_nVerts];
+		fMinkowskiPoint* newVert = m_verts.Allocate();
 		newVert->m_MinkDif = fEye;
 		newVert->m_MinkSum = fVec3(pt0 + pt1);
-		m_nVerts++;
 
 		if (!PatchHorizon(newVert))
 		{
 			return false;
 		}
 
+#ifndef NDEBUG
 		SanityCheck();
+#endif
 
 		return true;
 	}
@@ -464,21 +464,19 @@ bool EPAHull::ComputeIntersection(dVec3& pt0, dVec3& n0, dVec3& pt1, dVec3& n1)
 void EPAHull::SanityCheck() const
 {
 	// Verify that the horizon forms a cycle and that the horizon has no "coinciding" edges
-	for (int i = 0; i < m_nHorizonEdges; ++i)
+	const int nHorizonEdges = (int)m_horizonEdges.size();
+	for (int i = 0; i < nHorizonEdges; ++i)
 	{
-		assert(m_horizonEdges[(i + 1) % m_nHorizonEdges]->twin->vert == m_horizonEdges[i]->vert);
-		assert(std::find(m_horizonEdges, m_horizonEdges + m_nHorizonEdges, m_horizonEdges[i]->twin) == m_horizonEdges + m_nHorizonEdges);
+		assert(m_horizonEdges[(i + 1) % nHorizonEdges]->twin->vert == m_horizonEdges[i]->vert);
+		assert(std::find(m_horizonEdges.begin(), m_horizonEdges.end(), m_horizonEdges[i]->twin) == m_horizonEdges.end());
 	}
 
 	int nF = 0;
 	int nHE = 0;
 
-	std::vector<const HalfEdge*> edges;
-	std::set<const fMinkowskiPoint*> verts;
+	const std::vector<Face*>& faces = m_faceHeap.GetFaces();
 
-	std::vector<Face*> faces = m_faceHeap.GetFaces();
-
-	for (Face* f : faces)
+	for (const Face* f : faces)
 	{
 		HalfEdge* e[3];
 		e[0] = f->edge;
@@ -494,10 +492,6 @@ void EPAHull::SanityCheck() const
 		assert(e[1]->vert == e[2]->twin->vert);
 		assert(e[2]->vert == e[0]->twin->vert);
 
-		edges.push_back(e[0]);
-		edges.push_back(e[1]);
-		edges.push_back(e[2]);
-
 		nF++;
 		nHE += 3;
 	}
@@ -505,50 +499,44 @@ void EPAHull::SanityCheck() const
 	// Verify that there are an even number of triangles
 	assert(nF % 2 == 0);
 
-	for (const HalfEdge* e : edges)
+	// Verify that each point we added in the expansion ended up on the hull. This is quadratic, but it walks the
+	// existing structures instead of building a vertex set, so the check itself never allocates.
+	const int nV = m_verts.Size();
+	for (int i = 0; i < nV; ++i)
 	{
-		verts.insert(e->vert);
+		const fMinkowskiPoint* vert = &m_verts[i];
+		bool onHull = false;
+		for (const Face* f : faces)
+		{
+			onHull = onHull || f->edge->vert == vert || f->edge->next->vert == vert || f->edge->prev->vert == vert;
+		}
+		assert(onHull);
 	}
-	const int nV = (int)verts.size();
-
-	// Verify that each point we added in the expansion ended up on the hull
-	assert(nV == m_nVerts);
 
 	const int nE = nHE / 2;
 
 	// Verify EULER'S CHARACTERISTIC
 	assert(nV - nE + nF == 2);
 
-	// Verify that all the new edges and the horizon are convex
-	for (int i = 0; i < m_nHorizonEdges; ++i)
+	// Verify that all the new edges are non-degenerate
+	for (const HalfEdge* edge : m_horizonEdges)
 	{
-		const dVec3& n0 = m_horizonEdges[i]->face->normal;
-		for (HalfEdge* e : { m_horizonEdges[i], m_horizonEdges[i]->next, m_horizonEdges[i]->prev })
+		for (const HalfEdge* e : { edge, (const HalfEdge*)edge->next, (const HalfEdge*)edge->prev })
 		{
-			const dVec3& n1 = e->twin->face->normal;
-
 			const dVec3 AB(e->vert->m_MinkDif - e->twin->vert->m_MinkDif);
-
-			const double AB_AB = AB.Dot(AB);
-
-			assert((float)AB_AB > FLT_MIN);
-
-			const dVec3 v = AB.Scale(1.0 / sqrt(AB_AB));
-
-//			assert((float)n0.Cross(n1).Dot(v) >= 0.0f);
+			assert((float)AB.Dot(AB) > FLT_MIN);
 		}
 	}
 
-
 	// Verify the freelists
-	assert(nHE + m_nFreeEdges == EPAHULL_MAXEDGES);
-	assert((int)faces.size() + m_nFreeFaces == EPAHULL_MAXFACES);
+	assert(nHE + (int)m_freeEdges.size() == m_edges.Size());
+	assert(nF + (int)m_freeFaces.size() == m_faces.Size());
 
 	// Verify that all mutable face attributes are reset for the next pass
-	for (const Face face : m_faces)
+	for (int i = 0; i < m_faces.Size(); ++i)
 	{
-		assert(!face.visited);
-		assert(!face.visible);
+		assert(!m_faces[i].visited);
+		assert(!m_faces[i].visible);
 	}
 }
 
@@ -556,7 +544,7 @@ void EPAHull::DebugDraw(DebugRenderer* renderer) const
 {
 	std::set<const HalfEdge*> edges;
 
-	std::vector<Face*> faces = m_faceHeap.GetFaces();
+	const std::vector<Face*>& faces = m_faceHeap.GetFaces();
 
 	for (Face* face : faces)
 	{
@@ -1,14 +1,14 @@
+#pragma once
 #include "Simplex3D.h"
 #include "Geometry.h"
 #include "DebugRenderer.h"
+#include "ChunkedPool.h"
 
 #define EPAHULL_MAXITERS 64
 
-#define EPAHULL_MAXFACES 256
-#define EPAHULL_MAXEDGES (3 * EPAHULL_MAXFACES)
-#define EPAHULL_MAXVERTS (4 + EPAHULL_MAXITERS)
-
-#define EPAHULL_MAXHORIZONEDGES 16
+// Faces, edges and vertices are pooled in chunks of this size. The pools only ever grow, so after the first few
+// collisions on a thread EPA runs without touching the heap.
+#define EPAHULL_CHUNKSIZE 256
 
 struct OrientedGeometry
 {
@@ -19,6 +19,8 @@ struct OrientedGeometry
 	dVec3 Support(const dVec3& v) const { return geom->Support(pos, rot, v); }
 };
 
+// EPAHull is meant to be used as a reusable workspace: grab the one belonging to the calling thread, Reset it with the
+// GJK tetrahedron, then ComputeIntersection. All of its buffers persist between uses.
 class EPAHull
 {
 private:
@@ -26,8 +28,13 @@ private:
 	struct Face;
 	struct FaceHeap;
 public:
+	EPAHull();
+	EPAHull(const EPAHull&) = delete;
+	EPAHull& operator = (const EPAHull&) = delete;
+
+	static EPAHull& ThreadWorkspace();
 
-	EPAHull(
+	void Reset(
 		const Geometry* geom0, const dVec3& pos0, const dQuat& rot0,
 		const Geometry* geom1, const dVec3& pos1, const dQuat& rot1,
 		const GJKSimplex& tetrahedron);
@@ -50,11 +57,9 @@ private:
 		HalfEdge*				twin;
 		Face*	 				face;
 
-		int						index;
-
 		mutable bool			isHorizon;
 
-		HalfEdge() : vert(nullptr), next(nullptr), prev(nullptr), twin(nullptr), face(nullptr), isHorizon(false), index(-1) {}
+		HalfEdge() : vert(nullptr), next(nullptr), prev(nullptr), twin(nullptr), face(nullptr), isHorizon(false) {}
 	};
 	struct Face
 	{
@@ -88,11 +93,11 @@ private:
 		void Push(Face* face);
 		void Pop();
 		Face* Top() const;
-		bool Empty() const { return m_nFaces <= 0; }
-		std::vector<Face*> GetFaces() const { return std::vector<Face*>(m_faces, m_faces + m_nFaces); }
+		bool Empty() const { return m_faces.empty(); }
+		void Clear() { m_faces.clear(); }
+		const std::vector<Face*>& GetFaces() const { return m_faces; }
 	private:
-		Face* m_faces[EPAHULL_MAXFACES];
-		int m_nFaces = 0;
+		std::vector<Face*> m_faces;
 
 		void HeapifyUp(int index);
 		void HeapifyDown(int index);
@@ -100,20 +105,18 @@ private:
 	}
 	m_faceHeap;
 
-	Face			m_faces[EPAHULL_MAXFACES];
-	fMinkowskiPoint	m_verts[EPAHULL_MAXVERTS]; // store data in single precision, but do computations in double precision
-	HalfEdge		m_edges[EPAHULL_MAXEDGES];
-
-	Face*			m_freeFaces[EPAHULL_MAXFACES];
-	int				m_nFreeFaces;
+	ChunkedPool<Face, EPAHULL_CHUNKSIZE>			m_faces;
+	ChunkedPool<fMinkowskiPoint, EPAHULL_CHUNKSIZE>	m_verts; // store data in single precision, but do computations in double precision
+	ChunkedPool<HalfEdge, EPAHULL_CHUNKSIZE>		m_edges;
 
-	int				m_freeEdges[EPAHULL_MAXEDGES];
-	int				m_nFreeEdges;
+	std::vector<Face*>		m_freeFaces;
+	std::vector<HalfEdge*>	m_freeEdges;
 
-	int				m_nVerts;
+	mutable std::vector<HalfEdge*>	m_horizonEdges;
 
-	mutable HalfEdge*	m_horizonEdges[EPAHULL_MAXHORIZONEDGES];
-	mutable int			m_nHorizonEdges;
+	// Scratch space for CarveHorizon
+	std::vector<HalfEdge*>	m_edgeStack;
+	std::vector<Face*>		m_visitedFaces;
 
 	OrientedGeometry	m_geom0;
 	OrientedGeometry	m_geom1;
@@ -121,31 +124,40 @@ private:
 	// When we free a face, it becomes INACTIVE
 	void PushFreeFace(Face* face)
 	{
-		m_freeFaces[m_nFreeFaces++] = face;
+		m_freeFaces.push_back(face);
 	}
 	Face* PopFreeFace()
 	{
-		Face* face = m_freeFaces[--m_nFreeFaces];
+		Face* face;
+		if (m_freeFaces.empty())
+		{
+			face = m_faces.Allocate();
+		}
+		else
+		{
+			face = m_freeFaces.back();
+			m_freeFaces.pop_back();
+		}
 		face->Reset();
 		return face;
 	}
 
 	void PushFreeEdge(HalfEdge* edge)
 	{
-		for (int i = 0; i < m_nFreeEdges; ++i)
-		{
-			assert(edge->index != m_freeEdges[i]);
-		}
-
-		m_freeEdges[m_nFreeEdges] = edge->index;
-		m_nFreeEdges++;
+		assert(std::find(m_freeEdges.begin(), m_freeEdges.end(), edge) == m_freeEdges.end());
+		m_freeEdges.push_back(edge);
 	}
 	HalfEdge* PopFreeEdge()
 	{
-		m_nFreeEdges--;
-		return &m_edges[m_freeEdges[m_nFreeEdges]];
+		if (m_freeEdges.empty())
+		{
+			return m_edges.Allocate();
+		}
+		HalfEdge* edge = m_freeEdges.back();
+		m_freeEdges.pop_back();
+		return edge;
 	}
 
 	void CarveHorizon(const fVec3& eye, Face* visibleFace);
 	bool PatchHorizon(const fMinkowskiPoint* eye);
-};
\ No newline at end of file
+};
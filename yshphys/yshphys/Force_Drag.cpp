@@ -0,0 +1,25 @@
+#include "stdafx.h"
+#include "Force_Drag.h"
+
+
+Force_Drag::Force_Drag() :
+	linear(0.0),
+	quadratic(0.0),
+	angular(0.0)
+{
+}
+
+
+Force_Drag::~Force_Drag()
+{
+}
+
+void Force_Drag::ComputeForceAndTorque(const RigidBody::Inertia& inertia, const RigidBody::State& state, dVec3& F, dVec3& T) const
+{
+	const dVec3 v = state.P.Scale(inertia.minv);
+	F = v.Scale(-(linear + quadratic*sqrt(v.Dot(v))));
+
+	const dMat33 R(state.q);
+	const dVec3 w = (R*inertia.Ibodyinv*R.Transpose()).Transform(state.L);
+	T = w.Scale(-angular);
+}
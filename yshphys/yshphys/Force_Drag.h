@@ -0,0 +1,17 @@
+#pragma once
+#include "Force.h"
+
+// Opposes the motion of the body: F = -(linear + quadratic*|v|)*v through the center of mass, and T = -angular*w
+class Force_Drag :
+	public Force
+{
+public:
+	Force_Drag();
+	virtual ~Force_Drag();
+
+	virtual void ComputeForceAndTorque(const RigidBody::Inertia& inertia, const RigidBody::State& state, dVec3& F, dVec3& T) const;
+
+	double linear;
+	double quadratic;
+	double angular;
+};
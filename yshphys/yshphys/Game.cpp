@@ -4,10 +4,14 @@
 #include <SDL.h>
 
 Game::Game() :
-	m_dtPhys(15), m_tPhysics(0),
+	m_dtPhys(1.0 / 60.0), m_nSubsteps(2), m_maxStepsPerFrame(4), m_accumulator(0.0), m_tFrame(0), m_tStart(0),
+	m_pipelined(false), m_quit(false),
 	m_dtInput(15), m_tInput(0),
-	m_firstNode(nullptr)
+	m_firstNode(nullptr),
+	m_threadPool(std::max(0, (int)std::thread::hardware_concurrency() - 1))
 {
+	m_physicsScene.SetThreadPool(&m_threadPool);
+
 	m_gameNodes = new GameNode[MAX_GAME_NODES];
 
 	for (int i = 0; i < MAX_GAME_NODES - 1; ++i)
@@ -56,6 +60,7 @@ void Game::AddGameObject(GameObject* gameObject)
 		if (RigidBody* physicsObject = gameObject->GetPhysicsObject())
 		{
 			m_physicsScene.AddPhysicsObject(physicsObject);
+			gameObject->StorePhysicsTransform();
 		}
 		if (RenderObject* renderObject = gameObject->GetRenderObject())
 		{
@@ -81,70 +86,229 @@ void Game::RemoveGameObject(GameObject* gameObject)
 	}
 }
 
-void Game::Run()
+void Game::SetPhysicsTimestep(double dt, int nSubsteps, int maxStepsPerFrame)
+{
+	assert(dt > 0.0 && nSubsteps > 0 && maxStepsPerFrame > 0);
+	m_dtPhys = dt;
+	m_nSubsteps = nSubsteps;
+	m_maxStepsPerFrame = maxStepsPerFrame;
+}
+
+void Game::StepPhysics()
+{
+	GameNode* node = m_firstNode;
+	while (node != nullptr)
+	{
+		node->GetGameObject()->StorePhysicsTransform();
+		node = node->GetNext();
+	}
+
+	const double dt = m_dtPhys / (double)m_nSubsteps;
+	for (int i = 0; i < m_nSubsteps; ++i)
+	{
+		m_physicsScene.Step(dt);
+	}
+}
+
+void Game::SetPipelined(bool pipelined)
+{
+	m_pipelined = pipelined;
+}
+
+void Game::RunPhysicsCommand(const std::function<void()>& command)
+{
+	if (!m_pipelined)
+	{
+		command();
+		return;
+	}
+	std::lock_guard<std::mutex> lock(m_commandMutex);
+	m_physicsCommands.push_back(command);
+}
+
+void Game::RunPhysicsCommands()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_commandMutex);
+		m_runningCommands.swap(m_physicsCommands);
+	}
+	for (const std::function<void()>& command : m_runningCommands)
+	{
+		command();
+	}
+	m_runningCommands.clear();
+}
+
+void Game::PhysicsLoop()
 {
-	bool quit = 0;
+	const double counterPeriod = 1.0 / (double)SDL_GetPerformanceFrequency();
+	double tPhysics = 0.0;
 
-	while (!quit)
+	while (!m_quit)
 	{
-		Uint32 t = SDL_GetTicks();
+		const double t = (double)(SDL_GetPerformanceCounter() - m_tStart)*counterPeriod;
+		if (t < tPhysics + m_dtPhys)
+		{
+			std::this_thread::sleep_for(std::chrono::duration<double>(tPhysics + m_dtPhys - t));
+			continue;
+		}
+		if (t > tPhysics + m_dtPhys*(double)m_maxStepsPerFrame)
+		{
+			tPhysics = t - m_dtPhys;
+		}
+
+		RunPhysicsCommands();
+		StepPhysics();
 
-		if (t - m_tInput > m_dtInput)
+		PhysicsSnapshot& snapshot = m_snapshots.Back();
+		snapshot.objects.clear();
+		GameNode* node = m_firstNode;
+		while (node != nullptr)
 		{
-			m_tInput = t;
+			snapshot.objects.emplace_back();
+			node->GetGameObject()->TakePhysicsSnapshot(snapshot.objects.back());
+			node = node->GetNext();
+		}
+		snapshot.debugDraw.EvictObjects();
+		DebugDraw(&snapshot.debugDraw);
+
+		tPhysics += m_dtPhys;
+		snapshot.time = tPhysics;
+		m_snapshots.Publish();
+	}
+}
+
+void Game::ProcessInput()
+{
+	Uint32 t = SDL_GetTicks();
+
+	if (t - m_tInput > m_dtInput)
+	{
+		m_tInput = t;
 
-//			if (SDL_GetMouseFocus() == m_window->m_window)
+//		if (SDL_GetMouseFocus() == m_window->m_window)
+		{
+			m_inputManager.ProcessEvents(m_dtInput);
+			if (m_inputManager.QuitRequested())
 			{
-				m_inputManager.ProcessEvents(m_dtInput);
-				if (m_inputManager.QuitRequested())
-				{
-					quit = true;
-				}
+				m_quit = true;
 			}
 		}
-		if (t - m_tPhysics > m_dtPhys)
+	}
+}
+
+void Game::DebugDraw(DebugRenderer* renderer)
+{
+	m_physicsScene.DebugDraw(renderer);
+
+//	renderer->DrawBVTree(m_physicsScene.GetBVTree(), fVec3(1.0f, 1.0f, 1.0f));
+	if (const Picker* picker = m_renderScene.DebugDrawSystem().m_picker)
+	{
+		renderer->DrawPicker(*picker, fVec3(0.0f, 1.0f, 0.0f));
+	}
+
+	if (rb[0] != nullptr && rb[1] != nullptr)
+	{
+		GJKSimplex simp;
+		if (Geometry::Intersect(
+			rb[0]->GetGeometry(), rb[0]->GetPosition(), rb[0]->GetRotation(), dVec3(), dVec3(),
+			rb[1]->GetGeometry(), rb[1]->GetPosition(), rb[1]->GetRotation(), dVec3(), dVec3(),
+			simp))
+		{
+			EPAHull& hull = EPAHull::ThreadWorkspace();
+			hull.Reset(
+				rb[0]->GetGeometry(), rb[0]->GetPosition(), rb[0]->GetRotation(),
+				rb[1]->GetGeometry(), rb[1]->GetPosition(), rb[1]->GetRotation(),
+				simp);
+			hull.ComputeIntersection(dVec3(), dVec3(), dVec3(), dVec3());
+			hull.DebugDraw(renderer);
+		}
+	}
+//	epa->DebugDraw(renderer);
+
+	const float axesLength = 16.0f;
+	renderer->DrawLine(fVec3(-axesLength, 0.0f, 0.0f), fVec3(axesLength, 0.0f, 0.0f), fVec3(1.0f, 0.0f, 0.0f));
+	renderer->DrawLine(fVec3(0.0f, -axesLength, 0.0f), fVec3(0.0f, axesLength, 0.0f), fVec3(0.0f, 1.0f, 0.0f));
+	renderer->DrawLine(fVec3(0.0f, 0.0f, -axesLength), fVec3(0.0f, 0.0f, axesLength), fVec3(0.0f, 0.0f, 1.0f));
+}
+
+void Game::Render()
+{
+	m_renderScene.DrawScene(m_window);
+
+	m_window->UpdateGLRender();
+}
+
+void Game::Run()
+{
+	m_quit = false;
+
+	const double counterPeriod = 1.0 / (double)SDL_GetPerformanceFrequency();
+	m_tStart = SDL_GetPerformanceCounter();
+	m_tFrame = m_tStart;
+	m_accumulator = 0.0;
+
+	if (m_pipelined)
+	{
+		std::thread physicsThread(&Game::PhysicsLoop, this);
+
+		while (!m_quit)
 		{
-			m_physicsScene.DebugDraw(&m_renderScene.DebugDrawSystem());
-			m_physicsScene.Step((double)m_dtPhys*0.001);
+			ProcessInput();
+
+			// Draw one physics step behind, interpolating between the transforms before and after the latest step
+			m_snapshots.Acquire();
+			const PhysicsSnapshot& snapshot = m_snapshots.Front();
+			m_renderScene.DebugDrawSystem().DrawRecorded(snapshot.debugDraw);
+			const double t = (double)(SDL_GetPerformanceCounter() - m_tStart)*counterPeriod;
+			const double alpha = std::min(1.0, std::max(0.0, (t - snapshot.time) / m_dtPhys));
 
-			// RenderScene and PhysicsScene should know nothing about one another. All the coupling should be handled by Game and GameObject
+			int i = 0;
 			GameNode* node = m_firstNode;
-			while (node != nullptr)
+			while (node != nullptr && i < (int)snapshot.objects.size())
 			{
-				node->GetGameObject()->PropagatePhysicsTransform();
+				node->GetGameObject()->PropagatePhysicsSnapshot(snapshot.objects[i++], alpha);
 				node = node->GetNext();
 			}
-//			m_renderScene.DebugDrawSystem().DrawBVTree(m_physicsScene.GetBVTree(), fVec3(1.0f, 1.0f, 1.0f));
-			m_renderScene.DebugDrawSystem().DrawPicker(*m_renderScene.DebugDrawSystem().m_picker, fVec3(0.0f, 1.0f, 0.0f));
 
-			if (rb[0] != nullptr && rb[1] != nullptr)
-			{
-				GJKSimplex simp;
-				if (Geometry::Intersect(
-					rb[0]->GetGeometry(), rb[0]->GetPosition(), rb[0]->GetRotation(), dVec3(), dVec3(),
-					rb[1]->GetGeometry(), rb[1]->GetPosition(), rb[1]->GetRotation(), dVec3(), dVec3(),
-					simp))
-				{
-					EPAHull hull(
-						rb[0]->GetGeometry(), rb[0]->GetPosition(), rb[0]->GetRotation(),
-						rb[1]->GetGeometry(), rb[1]->GetPosition(), rb[1]->GetRotation(),
-						simp);
-					hull.ComputeIntersection(dVec3(), dVec3(), dVec3(), dVec3());
-					hull.DebugDraw(&m_renderScene.DebugDrawSystem());
-				}
-			}
-//			epa->DebugDraw(&m_renderScene.DebugDrawSystem());
+			Render();
+		}
 
-			const float axesLength = 16.0f;
-			m_renderScene.DebugDrawSystem().DrawLine(fVec3(-axesLength, 0.0f, 0.0f), fVec3(axesLength, 0.0f, 0.0f), fVec3(1.0f, 0.0f, 0.0f));
-			m_renderScene.DebugDrawSystem().DrawLine(fVec3(0.0f, -axesLength, 0.0f), fVec3(0.0f, axesLength, 0.0f), fVec3(0.0f, 1.0f, 0.0f));
-			m_renderScene.DebugDrawSystem().DrawLine(fVec3(0.0f, 0.0f, -axesLength), fVec3(0.0f, 0.0f, axesLength), fVec3(0.0f, 0.0f, 1.0f));
+		physicsThread.join();
+		return;
+	}
 
-			m_renderScene.DrawScene(m_window);
+	while (!m_quit)
+	{
+		ProcessInput();
 
-			m_window->UpdateGLRender();
+		const Uint64 tFrame = SDL_GetPerformanceCounter();
+		m_accumulator += (double)(tFrame - m_tFrame)*counterPeriod;
+		m_tFrame = tFrame;
+
+		int nSteps = 0;
+		while (m_accumulator >= m_dtPhys)
+		{
+			if (nSteps == m_maxStepsPerFrame)
+			{
+				m_accumulator = fmod(m_accumulator, m_dtPhys);
+				break;
+			}
+			StepPhysics();
+			m_accumulator -= m_dtPhys;
+			nSteps++;
+		}
 
-			m_tPhysics = t;
+		// RenderScene and PhysicsScene should know nothing about one another. All the coupling should be handled by Game and GameObject
+		const double alpha = m_accumulator / m_dtPhys;
+		GameNode* node = m_firstNode;
+		while (node != nullptr)
+		{
+			node->GetGameObject()->PropagatePhysicsTransform(alpha);
+			node = node->GetNext();
 		}
+
+		DebugDraw(&m_renderScene.DebugDrawSystem());
+		Render();
 	}
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include "PhysicsScene.h"
 #include "GameNode.h"
 #include "EPAHull.h"
+#include "TripleBuffer.h"
+#include "GeometryLibrary.h"
+#include "RenderMeshLibrary.h"
 
 #define MAX_GAME_NODES 1024
 
@@ -15,12 +18,32 @@ public:
 
 	void Run();
 
+	// Physics advances in fixed steps of dt (s), each split into nSubsteps steps of the PhysicsScene, however fast the game
+	// renders. At most maxStepsPerFrame steps are taken between renders; time beyond that is dropped, so that a stall
+	// doesn't snowball. Rendering interpolates between the last two physics steps.
+	void SetPhysicsTimestep(double dt, int nSubsteps, int maxStepsPerFrame);
+
+	// In pipelined mode, physics steps on a thread of its own, and publishes the transforms of the game objects after
+	// every step, along with its debug drawing. The render loop draws the latest of them without waiting for physics, and
+	// vice versa. Input is processed by the render loop, and whatever it does to the physics scene goes through
+	// RunPhysicsCommand. Game objects can't be added or removed during Run.
+	void SetPipelined(bool pipelined);
+
+	// Runs command against the physics scene: right away, or in pipelined mode, on the physics thread before its next step.
+	// Input handlers that touch the physics scene (e.g. Picker) do it through here.
+	void RunPhysicsCommand(const std::function<void()>& command);
+
 	void AddGameObject(GameObject* gameObject);
 	void RemoveGameObject(GameObject* gameObject);
 
+	// The shapes shared by the game objects. Declared first, so they outlive everything that references them.
+	GeometryLibrary m_geometryLibrary;
+	RenderMeshLibrary m_renderMeshLibrary;
+
 	InputManager m_inputManager;
 
 	PhysicsScene m_physicsScene;
+	ThreadPool m_threadPool;
 	RenderScene m_renderScene;
 
 	Window* m_window; // The window into which the rendered scene is displayed and from which the inputManager gets its mouse coordinates
@@ -30,11 +53,39 @@ public:
 
 protected:
 
-	unsigned int m_dtPhys;
+	struct PhysicsSnapshot
+	{
+		PhysicsSnapshot() : time(0.0) {}
+
+		double time; // the time (s since Run started) at which the current transforms are due
+		std::vector<GameObject::PhysicsSnapshot> objects; // in the order of the game nodes
+		DebugRenderer debugDraw; // the debug drawing of the physics scene, as of the step
+	};
+
+	void StepPhysics();
+	void PhysicsLoop();
+	void ProcessInput();
+	void RunPhysicsCommands();
+	void DebugDraw(DebugRenderer* renderer);
+	void Render();
+
+	double m_dtPhys;
+	int m_nSubsteps;
+	int m_maxStepsPerFrame;
+	double m_accumulator; // the simulation time (s) that physics is behind the clock
+
 	unsigned int m_dtInput;
 
 	unsigned int m_tRender;
-	unsigned int m_tPhysics;
+	unsigned long long m_tFrame; // performance counter
+	unsigned long long m_tStart; // performance counter
+
+	bool m_pipelined;
+	std::atomic<bool> m_quit;
+	std::mutex m_commandMutex; // guards m_physicsCommands, which the physics thread takes in one swap before each step
+	std::vector<std::function<void()>> m_physicsCommands;
+	std::vector<std::function<void()>> m_runningCommands; // the physics thread's side of the swap
+	TripleBuffer<PhysicsSnapshot> m_snapshots;
 
 	unsigned int m_tInput;
 
@@ -4,7 +4,8 @@
 #include "RigidBody.h"
 
 
-GameObject::GameObject() : m_renderPosOffset(0.0, 0.0, 0.0), m_renderRotOffset(fQuat::Identity())
+GameObject::GameObject() : m_renderPosOffset(0.0, 0.0, 0.0), m_renderRotOffset(fQuat::Identity()),
+	m_prevPos(0.0, 0.0, 0.0), m_prevRot(dQuat::Identity())
 {
 }
 GameObject::~GameObject()
@@ -31,12 +32,61 @@ RigidBody* GameObject::GetPhysicsObject() const
 	return m_physicsObject;
 }
 
-void GameObject::PropagatePhysicsTransform() const
+void GameObject::StorePhysicsTransform()
+{
+	if (m_physicsObject)
+	{
+		m_prevPos = m_physicsObject->GetPosition();
+		m_prevRot = m_physicsObject->GetRotation();
+	}
+}
+
+void GameObject::PropagatePhysicsTransform(double alpha) const
 {
 	if (m_physicsObject && m_renderObject)
 	{
-		const dQuat q0 = m_physicsObject->GetRotation();
-		const dVec3 x0 = m_physicsObject->GetPosition();
+		PhysicsSnapshot snapshot;
+		TakePhysicsSnapshot(snapshot);
+		PropagatePhysicsSnapshot(snapshot, alpha);
+	}
+}
+
+void GameObject::TakePhysicsSnapshot(PhysicsSnapshot& snapshot) const
+{
+	snapshot.prevPos = m_prevPos;
+	snapshot.prevRot = m_prevRot;
+	if (m_physicsObject)
+	{
+		snapshot.pos = m_physicsObject->GetPosition();
+		snapshot.rot = m_physicsObject->GetRotation();
+	}
+	else
+	{
+		snapshot.pos = m_prevPos;
+		snapshot.rot = m_prevRot;
+	}
+}
+
+void GameObject::PropagatePhysicsSnapshot(const PhysicsSnapshot& snapshot, double alpha) const
+{
+	if (m_physicsObject && m_renderObject)
+	{
+		const dVec3& x = snapshot.pos;
+		const dQuat& q = snapshot.rot;
+		const dVec3& xPrev = snapshot.prevPos;
+		const dQuat& qPrev = snapshot.prevRot;
+
+		// Normalized lerp, along the shorter arc. The rotation over a physics step is small enough that it's
+		// indistinguishable from slerp.
+		const double sign = (qPrev.x*q.x + qPrev.y*q.y + qPrev.z*q.z + qPrev.w*q.w) < 0.0 ? -1.0 : 1.0;
+		const double a = 1.0 - alpha;
+		const double b = alpha*sign;
+		const dQuat q0 = dQuat(
+			a*qPrev.x + b*q.x,
+			a*qPrev.y + b*q.y,
+			a*qPrev.z + b*q.z,
+			a*qPrev.w + b*q.w).Normalize();
+		const dVec3 x0 = xPrev.Scale(a) + x.Scale(alpha);
 		const fQuat& q1 = m_renderRotOffset;
 		const fVec3& x1 = m_renderPosOffset;
 		m_renderObject->SetRotation(q0*q1);
@@ -11,6 +11,15 @@ class GameObject
 {
 	friend class GameNode;
 public:
+	// The physics object's transforms before and after the last physics step
+	struct PhysicsSnapshot
+	{
+		dVec3 prevPos;
+		dQuat prevRot;
+		dVec3 pos;
+		dQuat rot;
+	};
+
 	GameObject();
 	virtual ~GameObject();
 
@@ -22,7 +31,15 @@ public:
 	RenderObject* GetRenderObject() const;
 	RigidBody* GetPhysicsObject() const;
 
-	void PropagatePhysicsTransform() const;
+	// Remembers the physics object's current transform, as the start of the interpolation over the next physics step
+	void StorePhysicsTransform();
+	// Places the render object between the stored transform (alpha = 0) and the physics object's current one (alpha = 1)
+	void PropagatePhysicsTransform(double alpha) const;
+
+	// For when physics and rendering run on different threads: the physics thread takes the snapshot once it has
+	// stepped, and the render thread propagates it
+	void TakePhysicsSnapshot(PhysicsSnapshot& snapshot) const;
+	void PropagatePhysicsSnapshot(const PhysicsSnapshot& snapshot, double alpha) const;
 
 	fVec3 m_renderPosOffset;
 	fQuat m_renderRotOffset;
@@ -32,5 +49,8 @@ protected:
 	RigidBody* m_physicsObject;
 
 	GameNode* m_node;
+
+	dVec3 m_prevPos;
+	dQuat m_prevRot;
 };
 
@@ -9,7 +9,11 @@
 #define MIN_SUPPORT_SQR 0.0001
 #define GJK_TERMINATION_RATIO 0.01
 
-Geometry::Geometry() : m_material(Material::Type::WOOD)
+Geometry::Geometry() : m_material(Material::Type::WOOD), m_refCount(0)
+{
+}
+
+Geometry::Geometry(const Geometry& geom) : m_localOOBB(geom.m_localOOBB), m_material(geom.m_material), m_refCount(0)
 {
 }
 
@@ -17,6 +21,30 @@ Geometry::~Geometry()
 {
 }
 
+Geometry& Geometry::operator = (const Geometry& geom)
+{
+	// The copy is a different geometry, so it keeps its own references
+	m_localOOBB = geom.m_localOOBB;
+	m_material = geom.m_material;
+	return *this;
+}
+
+void Geometry::AddRef() const
+{
+	m_refCount++;
+}
+
+void Geometry::Release() const
+{
+	assert(m_refCount > 0);
+	m_refCount--;
+}
+
+int Geometry::GetRefCount() const
+{
+	return m_refCount;
+}
+
 void Geometry::UpdateLocalOOBB()
 {
 	m_localOOBB.min.x = SupportLocal(dVec3(-1.0, 0.0, 0.0)).x;
@@ -77,11 +105,34 @@ dVec3 Geometry::SupportLocal(const dVec3& v) const
 	return dVec3(0.0, 0.0, 0.0);
 }
 
+int Geometry::SupportFeature(const dVec3& x, const dQuat& q, const dVec3& v, dVec3* verts, int maxVerts) const
+{
+	const int n = SupportFeatureLocal((-q).Transform(v), verts, maxVerts);
+	for (int i = 0; i < n; ++i)
+	{
+		verts[i] = x + q.Transform(verts[i]);
+	}
+	return n;
+}
+
+int Geometry::SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const
+{
+	assert(maxVerts > 0);
+	verts[0] = SupportLocal(v);
+	return 1;
+}
+
 Material::Type Geometry::GetMaterialLocal(const dVec3& x) const
 {
 	return m_material;
 }
 
+void Geometry::ForEachPart(const BoundingBox& localBounds, const PartCallback& f) const
+{
+	// A convex geometry is its own (only) part
+	f(0, this, dVec3(0.0, 0.0, 0.0), dQuat::Identity());
+}
+
 Polygon Geometry::IntersectPlane(const dVec3& pos, const dQuat& rot, const dVec3& planeOrigin, const dVec3& planeNormal, const dVec3& xAxis, const dVec3& yAxis) const
 {
 	dMat33 planeOrientationT;
@@ -313,7 +364,8 @@ bool Geometry::Intersect(
 
 		if (closestFeature.GetNumPoints() == 4)
 		{
-			EPAHull hull(geom0, pos0, rot0, geom1, pos1, rot1, simplex);
+			EPAHull& hull = EPAHull::ThreadWorkspace();
+			hull.Reset(geom0, pos0, rot0, geom1, pos1, rot1, simplex);
 			return hull.ComputeIntersection(pt0, n0, pt1, n1);
 		}
 		else
@@ -333,7 +385,8 @@ bool Geometry::Intersect(
 					CompleteSimplex3(geom0, pos0, rot0, geom1, pos1, rot1, simplex);
 					break;
 				}
-				EPAHull hull(geom0, pos0, rot0, geom1, pos1, rot1, simplex);
+				EPAHull& hull = EPAHull::ThreadWorkspace();
+				hull.Reset(geom0, pos0, rot0, geom1, pos1, rot1, simplex);
 				return hull.ComputeIntersection(pt0, n0, pt1, n1);
 			};
 
@@ -9,10 +9,19 @@
 // Well, this is kinda ugly. We are going to store the material with the geometry (as opposed to with the rigidbody)
 // This way, a trimesh geometry can be textured with many different physics materials, and we only need one rigidbody.
 
+// Curved geometries report a flat support feature (a side segment or a cap) when the support direction is within
+// this sine of being perpendicular to it. Circular caps are approximated by SUPPORTFEATURE_RING_VERTS vertices.
+#define SUPPORTFEATURE_PARALLEL_TOL 0.02
+#define SUPPORTFEATURE_RING_VERTS 8
+
 enum EGeomType
 {
 	SPHERE = 0,
 	BOX,
+	TRIANGLE,
+	TRIANGLEMESH,
+	HEIGHTFIELD,
+	COMPOUND,
 	GENERIC
 };
 
@@ -22,8 +31,17 @@ class Geometry
 {
 public:
 	Geometry();
+	Geometry(const Geometry& geom);
 	virtual ~Geometry();
 
+	Geometry& operator = (const Geometry& geom);
+
+	// A geometry can be shared by any number of rigid bodies (see GeometryLibrary), which reference it for as long as they use it.
+	// The count doesn't delete anything when it drops to zero; whoever created the geometry decides when to free it.
+	void AddRef() const;
+	void Release() const;
+	int GetRefCount() const;
+
 	virtual void UpdateLocalOOBB();
 	BoundingBox GetLocalOOBB() const;
 
@@ -32,6 +50,12 @@ public:
 	virtual dVec3 Support(const dVec3& pos, const dQuat& rot, const dVec3& v) const;
 	virtual dVec3 SupportLocal(const dVec3& v) const;
 
+	// The support feature is the face, edge, or vertex of the geometry that is extremal in the direction v.
+	// Its vertices are written to verts as a convex polygon (consistently wound) and their count is returned.
+	// Curved geometries return a single vertex unless v is (nearly) perpendicular to one of their flat features.
+	int SupportFeature(const dVec3& pos, const dQuat& rot, const dVec3& v, dVec3* verts, int maxVerts) const;
+	virtual int SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const;
+
 	virtual Material::Type GetMaterialLocal(const dVec3& x) const;
 
 	void SetUniformMaterial(Material::Type material);
@@ -54,12 +78,22 @@ public:
 
 	virtual EGeomType GetType() const { return EGeomType::GENERIC; }
 
+	// Concave geometries (such as triangle meshes and compounds) are collections of convex parts, and collide part by part:
+	// the narrowphase asks for the parts near the other geometry, and keeps a contact manifold for each of them.
+	// Parts are given in the local frame of the concave geometry (pos and rot), and only live for the duration of the call.
+	typedef std::function<void(int iPart, const Geometry* part, const dVec3& pos, const dQuat& rot)> PartCallback;
+	virtual bool IsConcave() const { return false; }
+	// Calls f for every part whose bounds overlap localBounds (in the local frame)
+	virtual void ForEachPart(const BoundingBox& localBounds, const PartCallback& f) const;
+
 protected:
 
 	BoundingBox m_localOOBB; // assuming m_pos and m_rot are both zero
 
 	Material::Type m_material;
 
+	mutable int m_refCount;
+
 	static dVec3 QuantizeDirection(const dVec3& v);
 };
 
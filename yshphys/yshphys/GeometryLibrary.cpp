@@ -0,0 +1,125 @@
+#include "stdafx.h"
+#include "GeometryLibrary.h"
+
+GeometryLibrary::Key::Key(Shape shape_, double p0, double p1, double p2) : shape(shape_)
+{
+	params[0] = p0;
+	params[1] = p1;
+	params[2] = p2;
+}
+
+bool GeometryLibrary::Key::operator < (const Key& key) const
+{
+	if (shape != key.shape)
+	{
+		return shape < key.shape;
+	}
+	return std::lexicographical_compare(params, params + 3, key.params, key.params + 3);
+}
+
+GeometryLibrary::GeometryLibrary()
+{
+}
+
+GeometryLibrary::~GeometryLibrary()
+{
+	for (auto& entry : m_geometries)
+	{
+		delete entry.second;
+	}
+}
+
+Geometry* GeometryLibrary::Find(const Key& key) const
+{
+	auto it = m_geometries.find(key);
+	return (it != m_geometries.end()) ? it->second : nullptr;
+}
+
+const Box* GeometryLibrary::GetBox(double halfDimX, double halfDimY, double halfDimZ)
+{
+	const Key key(SHAPE_BOX, halfDimX, halfDimY, halfDimZ);
+	if (Geometry* geom = Find(key))
+	{
+		return (const Box*)geom;
+	}
+	Box* box = new Box;
+	box->SetDimensions(halfDimX, halfDimY, halfDimZ);
+	m_geometries[key] = box;
+	return box;
+}
+
+const Sphere* GeometryLibrary::GetSphere(double radius)
+{
+	const Key key(SHAPE_SPHERE, radius, 0.0, 0.0);
+	if (Geometry* geom = Find(key))
+	{
+		return (const Sphere*)geom;
+	}
+	Sphere* sphere = new Sphere;
+	sphere->SetRadius(radius);
+	m_geometries[key] = sphere;
+	return sphere;
+}
+
+const Cylinder* GeometryLibrary::GetCylinder(double radius, double halfHeight)
+{
+	const Key key(SHAPE_CYLINDER, radius, halfHeight, 0.0);
+	if (Geometry* geom = Find(key))
+	{
+		return (const Cylinder*)geom;
+	}
+	Cylinder* cylinder = new Cylinder;
+	cylinder->SetRadius(radius);
+	cylinder->SetHalfHeight(halfHeight);
+	m_geometries[key] = cylinder;
+	return cylinder;
+}
+
+const Capsule* GeometryLibrary::GetCapsule(double radius, double halfHeight)
+{
+	const Key key(SHAPE_CAPSULE, radius, halfHeight, 0.0);
+	if (Geometry* geom = Find(key))
+	{
+		return (const Capsule*)geom;
+	}
+	Capsule* capsule = new Capsule;
+	capsule->SetRadius(radius);
+	capsule->SetHalfHeight(halfHeight);
+	m_geometries[key] = capsule;
+	return capsule;
+}
+
+const Cone* GeometryLibrary::GetCone(double radius, double height)
+{
+	const Key key(SHAPE_CONE, radius, height, 0.0);
+	if (Geometry* geom = Find(key))
+	{
+		return (const Cone*)geom;
+	}
+	Cone* cone = new Cone;
+	cone->SetRadius(radius);
+	cone->SetHeight(height);
+	m_geometries[key] = cone;
+	return cone;
+}
+
+void GeometryLibrary::PurgeUnused()
+{
+	for (auto it = m_geometries.begin(); it != m_geometries.end();)
+	{
+		if (it->second->GetRefCount() == 0)
+		{
+			delete it->second;
+			it = m_geometries.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+int GeometryLibrary::GetNGeometries() const
+{
+	return (int)m_geometries.size();
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "Box.h"
+#include "Sphere.h"
+#include "Cylinder.h"
+#include "Capsule.h"
+#include "Cone.h"
+
+// Hands out one geometry per shape and set of dimensions, shared by every body that asks for it, so that a pile of
+// ten thousand identical crates has a single Box (and its support data stays hot in the cache).
+// The library owns the geometries. Nothing modifies them once they're handed out (bodies only ever see const geometries),
+// so they all keep the default material. Each one lives until the library is destroyed, or purged while no body references it.
+
+class GeometryLibrary
+{
+public:
+	GeometryLibrary();
+	~GeometryLibrary();
+
+	GeometryLibrary(const GeometryLibrary&) = delete;
+	GeometryLibrary& operator = (const GeometryLibrary&) = delete;
+
+	const Box* GetBox(double halfDimX, double halfDimY, double halfDimZ);
+	const Sphere* GetSphere(double radius);
+	const Cylinder* GetCylinder(double radius, double halfHeight);
+	const Capsule* GetCapsule(double radius, double halfHeight);
+	const Cone* GetCone(double radius, double height);
+
+	// Frees the geometries that no body references anymore
+	void PurgeUnused();
+
+	int GetNGeometries() const;
+
+private:
+	enum Shape
+	{
+		SHAPE_BOX = 0,
+		SHAPE_SPHERE,
+		SHAPE_CYLINDER,
+		SHAPE_CAPSULE,
+		SHAPE_CONE
+	};
+
+	struct Key
+	{
+		Key(Shape shape, double p0, double p1, double p2);
+		bool operator < (const Key& key) const;
+
+		Shape shape;
+		double params[3];
+	};
+
+	Geometry* Find(const Key& key) const;
+
+	std::map<Key, Geometry*> m_geometries;
+};
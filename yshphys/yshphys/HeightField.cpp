@@ -0,0 +1,279 @@
+#include "stdafx.h"
+#include "HeightField.h"
+#include "Ray.h"
+
+#define HEIGHTFIELD_MAX_QUANTISED 65535
+
+HeightField::HeightField() :
+	m_nX(0), m_nY(0),
+	m_cellSizeX(1.0), m_cellSizeY(1.0),
+	m_origin(0.0, 0.0, 0.0),
+	m_minHeight(0.0), m_heightScale(0.0)
+{
+	m_localOOBB.min = dVec3(0.0, 0.0, 0.0);
+	m_localOOBB.max = dVec3(0.0, 0.0, 0.0);
+}
+
+HeightField::~HeightField()
+{
+}
+
+void HeightField::Create(const float* heights, int nX, int nY, double cellSizeX, double cellSizeY)
+{
+	assert(nX >= 2 && nY >= 2);
+	assert(cellSizeX > 0.0 && cellSizeY > 0.0);
+
+	m_nX = nX;
+	m_nY = nY;
+	m_cellSizeX = cellSizeX;
+	m_cellSizeY = cellSizeY;
+	m_origin = dVec3(-0.5*cellSizeX*(double)(nX - 1), -0.5*cellSizeY*(double)(nY - 1), 0.0);
+
+	const int n = nX*nY;
+	float minHeight = heights[0];
+	float maxHeight = heights[0];
+	for (int i = 1; i < n; ++i)
+	{
+		minHeight = std::min(minHeight, heights[i]);
+		maxHeight = std::max(maxHeight, heights[i]);
+	}
+	m_minHeight = (double)minHeight;
+	m_heightScale = ((double)maxHeight - (double)minHeight) / (double)HEIGHTFIELD_MAX_QUANTISED;
+
+	m_heights.resize(n);
+	for (int i = 0; i < n; ++i)
+	{
+		const double q = m_heightScale > 0.0 ? ((double)heights[i] - m_minHeight) / m_heightScale : 0.0;
+		m_heights[i] = (unsigned short)std::min((double)HEIGHTFIELD_MAX_QUANTISED, std::floor(q + 0.5));
+	}
+
+	m_localOOBB.min = dVec3(m_origin.x, m_origin.y, m_minHeight);
+	m_localOOBB.max = dVec3(-m_origin.x, -m_origin.y, m_minHeight + m_heightScale*(double)HEIGHTFIELD_MAX_QUANTISED);
+}
+
+int HeightField::GetNSamplesX() const
+{
+	return m_nX;
+}
+
+int HeightField::GetNSamplesY() const
+{
+	return m_nY;
+}
+
+double HeightField::GetHeight(int i, int j) const
+{
+	return m_minHeight + m_heightScale*(double)m_heights[j*m_nX + i];
+}
+
+dVec3 HeightField::GetVertex(int i, int j) const
+{
+	return dVec3(m_origin.x + m_cellSizeX*(double)i, m_origin.y + m_cellSizeY*(double)j, GetHeight(i, j));
+}
+
+bool HeightField::IsInGrid(int i, int j) const
+{
+	return i >= 0 && i < m_nX && j >= 0 && j < m_nY;
+}
+
+void HeightField::GetCellHeights(int i, int j, double& minHeight, double& maxHeight) const
+{
+	const unsigned short* row0 = &m_heights[j*m_nX + i];
+	const unsigned short* row1 = row0 + m_nX;
+	const unsigned short qMin = std::min(std::min(row0[0], row0[1]), std::min(row1[0], row1[1]));
+	const unsigned short qMax = std::max(std::max(row0[0], row0[1]), std::max(row1[0], row1[1]));
+	minHeight = m_minHeight + m_heightScale*(double)qMin;
+	maxHeight = m_minHeight + m_heightScale*(double)qMax;
+}
+
+void HeightField::GetTriangle(int i, int j, int k, Triangle& tri) const
+{
+	// The neighbour across each edge is in the next cell over, or (for the diagonal) the other triangle of the cell.
+	// Its vertex across the edge (w) decides whether the edge is internal; the edges of the terrain never are.
+
+	dVec3 v[3];
+	int wi[3];
+	int wj[3];
+	if (k == 0)
+	{
+		v[0] = GetVertex(i, j);
+		v[1] = GetVertex(i + 1, j);
+		v[2] = GetVertex(i + 1, j + 1);
+		wi[0] = i;     wj[0] = j - 1;
+		wi[1] = i + 2; wj[1] = j + 1;
+		wi[2] = i;     wj[2] = j + 1;
+	}
+	else
+	{
+		v[0] = GetVertex(i, j);
+		v[1] = GetVertex(i + 1, j + 1);
+		v[2] = GetVertex(i, j + 1);
+		wi[0] = i + 1; wj[0] = j;
+		wi[1] = i + 1; wj[1] = j + 2;
+		wi[2] = i - 1; wj[2] = j;
+	}
+
+	unsigned int internalEdges = 0;
+	for (int e = 0; e < 3; ++e)
+	{
+		if (IsInGrid(wi[e], wj[e]) &&
+			Triangle::IsInternalEdge(v[e], v[(e + 1) % 3], v[(e + 2) % 3], GetVertex(wi[e], wj[e])))
+		{
+			internalEdges |= 1 << e;
+		}
+	}
+
+	tri.SetVertices(v[0], v[1], v[2], internalEdges);
+}
+
+dVec3 HeightField::SupportLocal(const dVec3& v) const
+{
+	return dVec3(
+		v.x >= 0.0 ? m_localOOBB.max.x : m_localOOBB.min.x,
+		v.y >= 0.0 ? m_localOOBB.max.y : m_localOOBB.min.y,
+		v.z >= 0.0 ? m_localOOBB.max.z : m_localOOBB.min.z);
+}
+
+void HeightField::ForEachPart(const BoundingBox& localBounds, const PartCallback& f) const
+{
+	if (m_heights.empty() ||
+		localBounds.max.x < m_localOOBB.min.x || localBounds.min.x > m_localOOBB.max.x ||
+		localBounds.max.y < m_localOOBB.min.y || localBounds.min.y > m_localOOBB.max.y)
+	{
+		return;
+	}
+
+	const int i0 = std::max(0, (int)std::floor((localBounds.min.x - m_origin.x) / m_cellSizeX));
+	const int i1 = std::min(m_nX - 2, (int)std::floor((localBounds.max.x - m_origin.x) / m_cellSizeX));
+	const int j0 = std::max(0, (int)std::floor((localBounds.min.y - m_origin.y) / m_cellSizeY));
+	const int j1 = std::min(m_nY - 2, (int)std::floor((localBounds.max.y - m_origin.y) / m_cellSizeY));
+
+	Triangle tri;
+	for (int j = j0; j <= j1; ++j)
+	{
+		for (int i = i0; i <= i1; ++i)
+		{
+			double minHeight, maxHeight;
+			GetCellHeights(i, j, minHeight, maxHeight);
+			if (localBounds.min.z > maxHeight || localBounds.max.z < minHeight)
+			{
+				continue;
+			}
+			const int iCell = j*(m_nX - 1) + i;
+			for (int k = 0; k < 2; ++k)
+			{
+				GetTriangle(i, j, k, tri);
+				f(2 * iCell + k, &tri, dVec3(0.0, 0.0, 0.0), dQuat::Identity());
+			}
+		}
+	}
+}
+
+bool HeightField::RayIntersect(const dVec3& pos, const dQuat& rot, const Ray& ray, dVec3& hit) const
+{
+	if (m_heights.empty())
+	{
+		return false;
+	}
+
+	Ray r;
+	r.SetOrigin((-rot).Transform(ray.GetOrigin() - pos));
+	r.SetDirection((-rot).Transform(ray.GetDirection()));
+	r.SetLength(ray.GetLength());
+
+	const dVec3 padding = dVec3(1.0, 1.0, 1.0).Scale(HEIGHTFIELD_RAY_PADDING);
+	AABB bounds;
+	bounds.min = m_localOOBB.min - padding;
+	bounds.max = m_localOOBB.max + padding;
+
+	double tIn, tOut;
+	if (!r.IntersectAABB(bounds, tIn, tOut))
+	{
+		return false;
+	}
+	const double tStart = std::max(tIn, 0.0);
+	const double tEnd = std::min(tOut, ray.GetLength());
+	if (tStart > tEnd)
+	{
+		return false;
+	}
+
+	// Walk the cells under the ray in the order it crosses them, starting with the one it enters the terrain over
+
+	const dVec3 o = r.GetOrigin();
+	const dVec3 d = r.GetDirection();
+	const dVec3 entry = o + d.Scale(tStart);
+
+	int i = std::min(m_nX - 2, std::max(0, (int)std::floor((entry.x - m_origin.x) / m_cellSizeX)));
+	int j = std::min(m_nY - 2, std::max(0, (int)std::floor((entry.y - m_origin.y) / m_cellSizeY)));
+	const int stepI = d.x > 0.0 ? 1 : -1;
+	const int stepJ = d.y > 0.0 ? 1 : -1;
+
+	// The ray parameter at which the ray crosses into the next column (x) and row (y) of cells, and the step between those
+	double tNextX = DBL_MAX;
+	double tNextY = DBL_MAX;
+	double tDeltaX = DBL_MAX;
+	double tDeltaY = DBL_MAX;
+	if (d.x != 0.0)
+	{
+		tNextX = (m_origin.x + m_cellSizeX*(double)(d.x > 0.0 ? i + 1 : i) - o.x) / d.x;
+		tDeltaX = m_cellSizeX / abs(d.x);
+	}
+	if (d.y != 0.0)
+	{
+		tNextY = (m_origin.y + m_cellSizeY*(double)(d.y > 0.0 ? j + 1 : j) - o.y) / d.y;
+		tDeltaY = m_cellSizeY / abs(d.y);
+	}
+
+	Triangle tri;
+	double t = tStart;
+	while (true)
+	{
+		const double tCellEnd = std::min(std::min(tNextX, tNextY), tEnd);
+
+		// Skip the cell if the ray stays above or below it while crossing it
+		double minHeight, maxHeight;
+		GetCellHeights(i, j, minHeight, maxHeight);
+		const double z0 = o.z + d.z*t;
+		const double z1 = o.z + d.z*tCellEnd;
+		if (std::min(z0, z1) <= maxHeight + HEIGHTFIELD_RAY_PADDING && std::max(z0, z1) >= minHeight - HEIGHTFIELD_RAY_PADDING)
+		{
+			double tHit = DBL_MAX;
+			for (int k = 0; k < 2; ++k)
+			{
+				GetTriangle(i, j, k, tri);
+				dVec3 x;
+				if (tri.RayIntersect(dVec3(0.0, 0.0, 0.0), dQuat::Identity(), r, x))
+				{
+					tHit = std::min(tHit, (x - o).Dot(d) / d.Dot(d));
+				}
+			}
+			if (tHit != DBL_MAX)
+			{
+				hit = ray.GetOrigin() + ray.GetDirection().Scale(tHit);
+				return true;
+			}
+		}
+
+		if (tCellEnd >= tEnd)
+		{
+			return false;
+		}
+		if (tNextX < tNextY)
+		{
+			i += stepI;
+			t = tNextX;
+			tNextX += tDeltaX;
+		}
+		else
+		{
+			j += stepJ;
+			t = tNextY;
+			tNextY += tDeltaY;
+		}
+		if (i < 0 || i > m_nX - 2 || j < 0 || j > m_nY - 2)
+		{
+			return false;
+		}
+	}
+}
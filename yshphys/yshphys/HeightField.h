@@ -0,0 +1,64 @@
+#pragma once
+#include "Geometry.h"
+#include "Triangle.h"
+
+// Rays are tested against the bounds of the terrain, and the height range of each cell, padded by this distance
+#define HEIGHTFIELD_RAY_PADDING 0.0001
+
+// Terrain: a grid of heights (along z) over the xy plane, centered on the origin. Heights are quantised to 16 bits between
+// the lowest and highest sample, so a 4k x 4k terrain is 32 MB where a TriangleMesh of it would be about a gigabyte.
+//
+// Each cell of the grid is split into two triangles along the diagonal from its (min x, min y) corner to its (max x, max y)
+// corner, both wound counterclockwise seen from above. Like a TriangleMesh, the terrain is concave and collides triangle by
+// triangle (see Geometry::ForEachPart), but the triangles near a geometry are found by indexing the cells its bounds cover,
+// and rays walk the cells they cross in order (a 2D DDA), stopping at the first cell they hit.
+// Part i is triangle i % 2 of cell i / 2, with cells numbered row by row (x fastest).
+
+class HeightField :
+	public Geometry
+{
+public:
+	HeightField();
+	virtual ~HeightField();
+
+	// heights has nX*nY samples, row by row (x fastest). nX and nY must be at least 2.
+	void Create(const float* heights, int nX, int nY, double cellSizeX, double cellSizeY);
+
+	int GetNSamplesX() const;
+	int GetNSamplesY() const;
+
+	// The (dequantised) height of sample (i, j)
+	double GetHeight(int i, int j) const;
+
+	// Sets tri to triangle k (0 or 1) of cell (i, j), and its internal edges
+	void GetTriangle(int i, int j, int k, Triangle& tri) const;
+
+	// The support of the bounding box. Nothing should run GJK on the terrain itself.
+	virtual dVec3 SupportLocal(const dVec3& v) const;
+
+	virtual bool RayIntersect(const dVec3& pos, const dQuat& rot, const Ray& ray, dVec3& hitPt) const;
+
+	virtual bool IsConcave() const { return true; }
+	virtual void ForEachPart(const BoundingBox& localBounds, const PartCallback& f) const;
+
+	virtual EGeomType GetType() const { return EGeomType::HEIGHTFIELD; }
+
+private:
+	// Sample (i, j) in the local frame
+	dVec3 GetVertex(int i, int j) const;
+	bool IsInGrid(int i, int j) const;
+
+	// The range of heights over cell (i, j)
+	void GetCellHeights(int i, int j, double& minHeight, double& maxHeight) const;
+
+	std::vector<unsigned short> m_heights;
+	int m_nX;
+	int m_nY;
+
+	double m_cellSizeX;
+	double m_cellSizeY;
+	dVec3 m_origin; // the position of sample (0, 0), at height zero
+
+	double m_minHeight; // the height of a quantised zero
+	double m_heightScale; // the height of a quantised one
+};
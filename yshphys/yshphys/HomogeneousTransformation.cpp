@@ -79,6 +79,15 @@ Mat44_t<T> HomogeneousTransformation_t<T>::CreateTranslation(const Vec3_t<T>& t)
 	return tMat;
 }
 template <class T>
+Mat44_t<T> HomogeneousTransformation_t<T>::CreateRigidTransform(const Quat_t<T>& q, const Vec3_t<T>& t)
+{
+	Mat44_t<T> M(CreateRotation(q));
+	M(0, 3) = t.x;
+	M(1, 3) = t.y;
+	M(2, 3) = t.z;
+	return M;
+}
+template <class T>
 Mat44_t<T> HomogeneousTransformation_t<T>::CreateScale(T sx, T sy, T sz)
 {
 	Mat44_t<T> S;
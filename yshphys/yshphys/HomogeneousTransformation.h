@@ -8,6 +8,8 @@ public:
 	static Mat44_t<T> CreateRotation(const Quat_t<T>& q);
 	static Mat44_t<T> CreateTranslation(const Vec3_t<T>& t);
 	static Mat44_t<T> CreateScale(T sx, T sy, T sz);
+	// Equivalent to CreateTranslation(t)*CreateRotation(q), without the 4x4 product
+	static Mat44_t<T> CreateRigidTransform(const Quat_t<T>& q, const Vec3_t<T>& t);
 
 	static Mat44_t<T> CreateViewMatrix(const Vec3_t<T>& eye, const Vec3_t<T>& viewDir, const Vec3_t<T>& viewUp);
 
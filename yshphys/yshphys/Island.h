@@ -2,6 +2,7 @@
 #include "RigidBody.h"
 
 class PhysicsScene;
+class ThreadPool;
 
 class Island
 {
@@ -19,6 +20,6 @@ private:
 
 	void PrependTo(Island* island);
 	Island* Merge(Island* island);
-	void ResolveContacts() const;
+	void ResolveContacts(double dt, const MathUtils::GaussSeidelConfig& config, ThreadPool* threadPool, MathUtils::GaussSeidelStats& stats) const;
 };
 
@@ -0,0 +1,30 @@
+#pragma once
+
+// A whole file mapped into memory. The mapping is copy-on-write: the data can be modified in place,
+// but the changes stay private to the process and are never written back to the file.
+
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator = (const MappedFile&) = delete;
+
+	bool Open(const char* fileName);
+	void Close();
+
+	void* GetData() const;
+	size_t GetSize() const;
+
+private:
+#ifdef _WIN32
+	void* m_file; // HANDLE
+	void* m_mapping; // HANDLE
+#else
+	int m_file;
+#endif
+	void* m_data;
+	size_t m_size;
+};
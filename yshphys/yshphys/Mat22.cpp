@@ -2,16 +2,6 @@
 #include "Mat22.h"
 #include "Vec2.h"
 
-template <class T>
-Mat22_t<T>::Mat22_t()
-{
-}
-
-template <class T>
-Mat22_t<T>::~Mat22_t()
-{
-}
-
 template <class T>
 Vec2_t<T> Mat22_t<T>::GetRow(int i) const
 {
@@ -64,14 +54,14 @@ Mat22_t<T> Mat22_t<T>::Transpose() const
 template <class T>
 T Mat22_t<T>::Determinant() const
 {
-	return M_ij[0][0] * M_ij[1][1] - M_ij[0][1] - M_ij[1][0];
+	return M_ij[0][0] * M_ij[1][1] - M_ij[0][1] * M_ij[1][0];
 }
 
 template <class T>
 Mat22_t<T> Mat22_t<T>::Inverse() const
 {
 	Mat22_t<T> inv;
-	const T detInv = (T)1.0 / (M_ij[0][0] * M_ij[1][1] - M_ij[0][1] - M_ij[1][0]);
+	const T detInv = (T)1.0 / (M_ij[0][0] * M_ij[1][1] - M_ij[0][1] * M_ij[1][0]);
 	inv.M_ij[0][0] = M_ij[1][1] * detInv;
 	inv.M_ij[0][1] = -M_ij[0][1] * detInv;
 	inv.M_ij[1][0] = -M_ij[1][0] * detInv;
@@ -124,18 +114,6 @@ Mat22_t<T> Mat22_t<T>::Abs() const
 	return A;
 }
 
-template <class T>
-T Mat22_t<T>::operator () (unsigned int i, unsigned int j) const
-{
-	return M_ij[i][j];
-}
-
-template <class T>
-T& Mat22_t<T>::operator () (unsigned int i, unsigned int j)
-{
-	return M_ij[i][j];
-}
-
 template <class T>
 Mat22_t<T> Mat22_t<T>::operator * (const Mat22_t& B) const
 {
@@ -145,7 +123,7 @@ Mat22_t<T> Mat22_t<T>::operator * (const Mat22_t& B) const
 		for (int j = 0; j < 2; ++j)
 		{
 			T contraction(0.0);
-			for (int k = 0; k < 3; ++k)
+			for (int k = 0; k < 2; ++k)
 			{
 				contraction += M_ij[i][k] * B.M_ij[k][j];
 			}
@@ -167,4 +145,7 @@ bool Mat22_t<T>::operator == (const Mat22_t& M) const
 }
 
 template class Mat22_t<float>;
-template class Mat22_t<double>;
\ No newline at end of file
+template class Mat22_t<double>;
+
+static_assert(sizeof(dMat22) == 4 * sizeof(double), "dMat22 must not carry any padding or hidden members");
+static_assert(std::is_trivially_copyable<dMat22>::value, "dMat22 must be trivially copyable");
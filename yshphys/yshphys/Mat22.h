@@ -5,8 +5,7 @@ template <class T>
 class Mat22_t
 {
 public:
-	Mat22_t();
-	virtual ~Mat22_t();
+	Mat22_t() = default;
 
 	Vec2_t<T> GetRow(int i) const;
 	Vec2_t<T> GetColumn(int j) const;
@@ -27,8 +26,8 @@ public:
 
 	Mat22_t<T> Abs() const;
 	
-	T operator () (unsigned int i, unsigned int j) const;
-	T& operator () (unsigned int i, unsigned int j);
+	T operator () (unsigned int i, unsigned int j) const { return M_ij[i][j]; }
+	T& operator () (unsigned int i, unsigned int j) { return M_ij[i][j]; }
 
 	Mat22_t<T> operator * (const Mat22_t& M) const;
 	bool operator == (const Mat22_t& M) const;
@@ -5,12 +5,11 @@ template <class T>
 class Mat33_t
 {
 public:
-	Mat33_t();
+	Mat33_t() = default;
 	Mat33_t(const Quat_t<T>& q);
-	virtual ~Mat33_t();
 
-	Vec3_t<T> GetRow(int i) const;
-	Vec3_t<T> GetColumn(int j) const;
+	Vec3_t<T> GetRow(int i) const { return Vec3_t<T>(M_ij[i][0], M_ij[i][1], M_ij[i][2]); }
+	Vec3_t<T> GetColumn(int j) const { return Vec3_t<T>(M_ij[0][j], M_ij[1][j], M_ij[2][j]); }
 
 	void SetRow(int i, const Vec3_t<T>& v);
 	void SetColumn(int j, const Vec3_t<T>& v);
@@ -28,8 +27,8 @@ public:
 
 	Mat33_t<T> Abs() const;
 	
-	T operator () (unsigned int i, unsigned int j) const;
-	T& operator () (unsigned int i, unsigned int j);
+	T operator () (unsigned int i, unsigned int j) const { return M_ij[i][j]; }
+	T& operator () (unsigned int i, unsigned int j) { return M_ij[i][j]; }
 
 	Mat33_t<T> operator + (const Mat33_t<T>& M) const;
 	Mat33_t<T> operator * (const Mat33_t<T>& M) const;
@@ -38,3 +37,106 @@ public:
 private:
 	T M_ij[3][3];
 };
+
+template <class T>
+inline void Mat33_t<T>::SetRow(int i, const Vec3_t<T>& v)
+{
+	M_ij[i][0] = v.x;
+	M_ij[i][1] = v.y;
+	M_ij[i][2] = v.z;
+}
+
+template <class T>
+inline void Mat33_t<T>::SetColumn(int j, const Vec3_t<T>& v)
+{
+	M_ij[0][j] = v.x;
+	M_ij[1][j] = v.y;
+	M_ij[2][j] = v.z;
+}
+
+template <class T>
+inline Mat33_t<T> Mat33_t<T>::Transpose() const
+{
+	Mat33_t<T> transpose;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			transpose.M_ij[i][j] = M_ij[j][i];
+		}
+	}
+	return transpose;
+}
+
+template <class T>
+inline Vec3_t<T> Mat33_t<T>::Transform(const Vec3_t<T>& v) const
+{
+	return Vec3_t<T>
+	(
+		M_ij[0][0] * v.x + M_ij[0][1] * v.y + M_ij[0][2] * v.z,
+		M_ij[1][0] * v.x + M_ij[1][1] * v.y + M_ij[1][2] * v.z,
+		M_ij[2][0] * v.x + M_ij[2][1] * v.y + M_ij[2][2] * v.z
+	);
+}
+
+template <class T>
+inline Mat33_t<T> Mat33_t<T>::Scale(T scalar) const
+{
+	Mat33_t<T> product;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			product.M_ij[i][j] = scalar * M_ij[i][j];
+		}
+	}
+	return product;
+}
+
+template <class T>
+inline Mat33_t<T> Mat33_t<T>::Identity()
+{
+	Mat33_t<T> mat;
+
+	mat.M_ij[0][0] = (T)1.0;
+	mat.M_ij[0][1] = (T)0.0;
+	mat.M_ij[0][2] = (T)0.0;
+
+	mat.M_ij[1][0] = (T)0.0;
+	mat.M_ij[1][1] = (T)1.0;
+	mat.M_ij[1][2] = (T)0.0;
+
+	mat.M_ij[2][0] = (T)0.0;
+	mat.M_ij[2][1] = (T)0.0;
+	mat.M_ij[2][2] = (T)1.0;
+
+	return mat;
+}
+
+template <class T>
+inline Mat33_t<T> Mat33_t<T>::operator + (const Mat33_t<T>& B) const
+{
+	Mat33_t<T> sum;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			sum.M_ij[i][j] = M_ij[i][j] + B.M_ij[i][j];
+		}
+	}
+	return sum;
+}
+
+template <class T>
+inline Mat33_t<T> Mat33_t<T>::operator * (const Mat33_t<T>& B) const
+{
+	Mat33_t<T> product;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			product.M_ij[i][j] = M_ij[i][0] * B.M_ij[0][j] + M_ij[i][1] * B.M_ij[1][j] + M_ij[i][2] * B.M_ij[2][j];
+		}
+	}
+	return product;
+}
@@ -3,66 +3,12 @@
 #include "Vec4.h"
 #include "MathUtils.h"
 
-template <class T>
-Mat44_t<T>::Mat44_t()
-{
-}
-
-template <class T>
-Mat44_t<T>::~Mat44_t()
-{
-}
-
 template <class T>
 void Mat44_t<T>::GetData(T* const rowMajorEntries) const
 {
 	std::memcpy(rowMajorEntries, M_ij, sizeof(M_ij));
 }
 
-template <class T>
-Vec4_t<T> Mat44_t<T>::GetRow(int i) const
-{
-	return Vec4_t<T>(M_ij[i][0], M_ij[i][1], M_ij[i][2], M_ij[i][3]);
-}
-
-template <class T>
-Vec4_t<T> Mat44_t<T>::GetColumn(int j) const
-{
-	return Vec4_t<T>(M_ij[0][j], M_ij[1][j], M_ij[2][j], M_ij[3][j]);
-}
-
-template <class T>
-void Mat44_t<T>::SetRow(int i, const Vec4_t<T>& v)
-{
-	M_ij[i][0] = v.x;
-	M_ij[i][1] = v.y;
-	M_ij[i][2] = v.z;
-	M_ij[i][3] = v.w;
-}
-
-template <class T>
-void Mat44_t<T>::SetColumn(int j, const Vec4_t<T>& v)
-{
-	M_ij[0][j] = v.x;
-	M_ij[1][j] = v.y;
-	M_ij[2][j] = v.z;
-	M_ij[3][j] = v.w;
-}
-
-template <class T>
-Mat44_t<T> Mat44_t<T>::Transpose() const
-{
-	Mat44_t<T> transpose;
-	for (int i = 0; i < 4; ++i)
-	{
-		for (int j = 0; j < 4; ++j)
-		{
-			transpose.M_ij[i][j] = M_ij[j][i];
-		}
-	}
-	return transpose;
-}
-
 template <class T>
 T Mat44_t<T>::Determinant() const
 {
@@ -93,81 +39,6 @@ Mat44_t<T> Mat44_t<T>::Inverse() const
 	return inv;
 }
 
-template <class T>
-Vec4_t<T> Mat44_t<T>::Transform(const Vec4_t<T>& v) const
-{
-	Vec3_t<T> product;
-	for (int j = 0; j < 4; ++j)
-	{
-		T contraction(0.0);
-		for (int k = 0; k < 4; ++k)
-		{
-			contraction += M_ij[j][k] * v[k];
-		}
-		product[j] = contraction;
-	}
-	return product;
-}
-
-template <class T>
-Mat44_t<T> Mat44_t<T>::Scale(T scalar) const
-{
-	Mat44_t<T> product;
-	for (int i = 0; i < 4; ++i)
-	{
-		for (int j = 0; j < 4; ++j)
-		{
-			product.M_ij[i][j] = scalar * M_ij[i][j];
-		}
-	}
-	return product;
-}
-
-template <class T>
-T Mat44_t<T>::operator () (unsigned int i, unsigned int j) const
-{
-	return M_ij[i][j];
-}
-
-template <class T>
-T& Mat44_t<T>::operator () (unsigned int i, unsigned int j)
-{
-	return M_ij[i][j];
-}
-
-template <class T>
-Mat44_t<T> Mat44_t<T>::operator + (const Mat44_t<T>& B) const
-{
-	Mat44_t<T> sum;
-	for (int i = 0; i < 4; ++i)
-	{
-		for (int j = 0; j < 4; ++j)
-		{
-			sum.M_ij[i][j] = M_ij[i][j] + B.M_ij[i][j];
-		}
-	}
-	return sum;
-}
-
-template <class T>
-Mat44_t<T> Mat44_t<T>::operator * (const Mat44_t<T>& B) const
-{
-	Mat44_t<T> product;
-	for (int i = 0; i < 4; ++i)
-	{
-		for (int j = 0; j < 4; ++j)
-		{
-			T contraction(0.0);
-			for (int k = 0; k < 4; ++k)
-			{
-				contraction += M_ij[i][k] * B.M_ij[k][j];
-			}
-			product.M_ij[i][j] = contraction;
-		}
-	}
-	return product;
-}
-
 template <class T>
 bool Mat44_t<T>::operator == (const Mat44_t<T>& M) const
 {
@@ -195,3 +66,6 @@ bool Mat44_t<T>::operator == (const Mat44_t<T>& M) const
 
 template class Mat44_t<float>;
 template class Mat44_t<double>;
+
+static_assert(sizeof(fMat44) == 16 * sizeof(float), "fMat44 must not carry any padding or hidden members");
+static_assert(std::is_trivially_copyable<fMat44>::value, "fMat44 must be trivially copyable");
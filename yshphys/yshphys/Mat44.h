@@ -5,13 +5,12 @@ template <class T>
 class Mat44_t
 {
 public:
-	Mat44_t();
-	virtual ~Mat44_t();
+	Mat44_t() = default;
 
 	void GetData(T* const rowMajorEntries) const;
 
-	Vec4_t<T> GetRow(int i) const;
-	Vec4_t<T> GetColumn(int j) const;
+	Vec4_t<T> GetRow(int i) const { return Vec4_t<T>(M_ij[i][0], M_ij[i][1], M_ij[i][2], M_ij[i][3]); }
+	Vec4_t<T> GetColumn(int j) const { return Vec4_t<T>(M_ij[0][j], M_ij[1][j], M_ij[2][j], M_ij[3][j]); }
 
 	void SetRow(int i, const Vec4_t<T>& v);
 	void SetColumn(int j, const Vec4_t<T>& v);
@@ -22,8 +21,8 @@ public:
 	Vec4_t<T> Transform(const Vec4_t<T>& v) const;
 	Mat44_t<T> Scale(T scalar) const;
 
-	T operator () (unsigned int i, unsigned int j) const;
-	T& operator () (unsigned int i, unsigned int j);
+	T operator () (unsigned int i, unsigned int j) const { return M_ij[i][j]; }
+	T& operator () (unsigned int i, unsigned int j) { return M_ij[i][j]; }
 
 	Mat44_t<T> operator + (const Mat44_t<T>& M) const;
 	Mat44_t<T> operator * (const Mat44_t<T>& M) const;
@@ -32,3 +31,114 @@ public:
 private:
 	T M_ij[4][4];
 };
+
+template <class T>
+inline void Mat44_t<T>::SetRow(int i, const Vec4_t<T>& v)
+{
+	M_ij[i][0] = v.x;
+	M_ij[i][1] = v.y;
+	M_ij[i][2] = v.z;
+	M_ij[i][3] = v.w;
+}
+
+template <class T>
+inline void Mat44_t<T>::SetColumn(int j, const Vec4_t<T>& v)
+{
+	M_ij[0][j] = v.x;
+	M_ij[1][j] = v.y;
+	M_ij[2][j] = v.z;
+	M_ij[3][j] = v.w;
+}
+
+template <class T>
+inline Mat44_t<T> Mat44_t<T>::Transpose() const
+{
+	Mat44_t<T> transpose;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			transpose.M_ij[i][j] = M_ij[j][i];
+		}
+	}
+	return transpose;
+}
+
+template <class T>
+inline Vec4_t<T> Mat44_t<T>::Transform(const Vec4_t<T>& v) const
+{
+	Vec4_t<T> product;
+	Simd::Mat44Transform(&M_ij[0][0], &v.x, &product.x);
+	return product;
+}
+
+template <class T>
+inline Mat44_t<T> Mat44_t<T>::Scale(T scalar) const
+{
+	Mat44_t<T> product;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			product.M_ij[i][j] = scalar * M_ij[i][j];
+		}
+	}
+	return product;
+}
+
+template <class T>
+inline Mat44_t<T> Mat44_t<T>::operator + (const Mat44_t<T>& B) const
+{
+	Mat44_t<T> sum;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			sum.M_ij[i][j] = M_ij[i][j] + B.M_ij[i][j];
+		}
+	}
+	return sum;
+}
+
+template <class T>
+inline Mat44_t<T> Mat44_t<T>::operator * (const Mat44_t<T>& B) const
+{
+	Mat44_t<T> product;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			product.M_ij[i][j] =
+				M_ij[i][0] * B.M_ij[0][j] +
+				M_ij[i][1] * B.M_ij[1][j] +
+				M_ij[i][2] * B.M_ij[2][j] +
+				M_ij[i][3] * B.M_ij[3][j];
+		}
+	}
+	return product;
+}
+
+#if YSH_SIMD_SSE
+
+template <>
+inline Mat44_t<float> Mat44_t<float>::operator * (const Mat44_t<float>& B) const
+{
+	const __m128 b0 = Simd::Load(B.M_ij[0]);
+	const __m128 b1 = Simd::Load(B.M_ij[1]);
+	const __m128 b2 = Simd::Load(B.M_ij[2]);
+	const __m128 b3 = Simd::Load(B.M_ij[3]);
+
+	Mat44_t<float> product;
+	for (int i = 0; i < 4; ++i)
+	{
+		const __m128 a = Simd::Load(M_ij[i]);
+		__m128 row = _mm_mul_ps(YSH_SWIZZLE(a, 0, 0, 0, 0), b0);
+		row = Simd::MultiplyAdd(YSH_SWIZZLE(a, 1, 1, 1, 1), b1, row);
+		row = Simd::MultiplyAdd(YSH_SWIZZLE(a, 2, 2, 2, 2), b2, row);
+		row = Simd::MultiplyAdd(YSH_SWIZZLE(a, 3, 3, 3, 3), b3, row);
+		Simd::Store(product.M_ij[i], row);
+	}
+	return product;
+}
+
+#endif
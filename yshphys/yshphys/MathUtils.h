@@ -17,6 +17,29 @@ namespace MathUtils
 		return (T(0) < val) - (val < T(0));
 	}
 
+	// Completes the unit vector n to a right-handed orthonormal basis (t0, t1, n).
+	// The result depends only on n, so that bases computed on different frames agree.
+	template <typename T>
+	void OrthonormalBasis(const Vec3_t<T>& n, Vec3_t<T>& t0, Vec3_t<T>& t1)
+	{
+		// Cross n with the coordinate axis it is least aligned with
+		const Vec3_t<T> n_n = n.Times(n);
+		if (n_n.x <= n_n.y && n_n.x <= n_n.z)
+		{
+			t0 = Vec3_t<T>(T(0.0), n.z, -n.y);
+		}
+		else if (n_n.y <= n_n.z)
+		{
+			t0 = Vec3_t<T>(-n.z, T(0.0), n.x);
+		}
+		else
+		{
+			t0 = Vec3_t<T>(n.y, -n.x, T(0.0));
+		}
+		t0 = t0.Scale(T(1.0) / sqrt(t0.Dot(t0)));
+		t1 = n.Cross(t0);
+	}
+
 	template <typename T>
 	Vec3_t<T> RandomDirection3()
 	{
@@ -133,27 +156,48 @@ namespace MathUtils
 		}
 	}
 
+	// Iteration budget and stopping criterion of the Gauss-Seidel solvers (GaussSeidel below, and ContactSolver)
+	struct GaussSeidelConfig
+	{
+		int maxIterations; // hard limit, so that the cost of a solve is bounded
+		double relaxation; // successive over-relaxation factor. 1 is plain Gauss-Seidel; values in (1, 2) may converge faster
+		double tolerance; // stop as soon as the residual falls below this
+
+		GaussSeidelConfig() : maxIterations(64), relaxation(1.0), tolerance(0.000001) {}
+	};
+	struct GaussSeidelStats
+	{
+		int iterations; // the number of iterations performed
+		double residual; // the residual of the unknowns that weren't clamped, as of the last iteration
+		int nClamped; // the number of unknowns at their limits after the last iteration
+
+		GaussSeidelStats() : iterations(0), residual(0.0), nClamped(0) {}
+	};
+
 	////////////////////////////////////////////////////////////////////////////////////////////
 	// Credits to Julio Jerez (Newton Dynamics) for showing me his implementation of GaussSeidel
 	// This is basically a carbon copy of his, differing only in stylistic minutiae.
 	////////////////////////////////////////////////////////////////////////////////////////////
 	template <typename T>
-	void GaussSeidel(const T* const A, const T* const b, const T* const xMin, const T* const xMax, int n, T* const x)
+	void GaussSeidel(
+		const T* const A, const T* const b, const T* const xMin, const T* const xMax, int n, T* const x,
+		const GaussSeidelConfig& config = GaussSeidelConfig(), GaussSeidelStats* stats = nullptr)
 	{
-		T* const invDiag = new T[n];
 		for (int i = 0; i < n; ++i)
 		{
 			x[i] = std::max(xMin[i], std::min(x[i], xMax[i]));
-			invDiag[i] = T(1.0) / A[n*i + i];
 		}
 
-		const int maxIter = n*n*n*n + 1024;
-		const T rrThresh(0.000001*0.000001);
+		const T rrThresh = T(config.tolerance*config.tolerance);
+		const T omega = T(config.relaxation);
 		T rr(88888888.0);
+		int nClamped = 0;
+		int iter = 0;
 
-		for (int iter = 0; (iter < maxIter) && (rr > rrThresh); ++iter)
+		for (; (iter < config.maxIterations) && (rr > rrThresh); ++iter)
 		{
 			rr = (T)0.0;
+			nClamped = 0;
 			for (int i = 0; i < n; ++i)
 			{
 				// Compute r_i : the change in A_ii*x_i (NOTE: not quite the same as the residual)
@@ -169,15 +213,17 @@ namespace MathUtils
 				// Update and clamp x_i to the limits. If the x_i hit the limits, we don't consider the ith
 				// component as part of the termination criteria, since we aren't free to vary it.
 
-				x[i] = (r_i + A[n*i + i] * x[i]) * invDiag[i];
+				x[i] += omega * r_i / A[n*i + i];
 
 				if (x[i] < xMin[i])
 				{
 					x[i] = xMin[i];
+					nClamped++;
 				}
 				else if (x[i] > xMax[i])
 				{
 					x[i] = xMax[i];
+					nClamped++;
 				}
 				else
 				{
@@ -185,7 +231,13 @@ namespace MathUtils
 				}
 			}
 		}
-		delete[] invDiag;
+
+		if (stats)
+		{
+			stats->iterations = iter;
+			stats->residual = sqrt((double)rr);
+			stats->nClamped = nClamped;
+		}
 	}
 
 //	typedef void(*dydt_func)(double t, const double y[], double yDot[]);
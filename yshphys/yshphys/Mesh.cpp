@@ -1,6 +1,53 @@
 #include "stdafx.h"
 #include "Mesh.h"
 #include "QuickHull.h"
+#include "MappedFile.h"
+
+namespace
+{
+	// A cooked mesh file is this header, followed by the arrays at the given byte offsets from the start of the file
+	struct CookedMeshHeader
+	{
+		char magic[4];
+		int version;
+
+		// To reject files written with a different layout
+		int halfEdgeSize;
+		int faceSize;
+		int vertSize;
+
+		int nHalfEdges;
+		int nFaces;
+		int nVerts;
+		int nVertEdges;
+		int nSupportMap;
+		int supportMapRes;
+
+		int halfEdgeOffset;
+		int faceOffset;
+		int vertOffset;
+		int vertEdgeOffset;
+		int supportMapOffset;
+
+		double volume;
+		dVec3 centerOfMass;
+		dMat33 unitInertia;
+		BoundingBox localOOBB;
+	};
+
+	const char g_cookedMagic[4] = { 'Y', 'S', 'H', 'M' };
+
+	int AlignCooked(int offset)
+	{
+		return (offset + MESH_COOKED_ALIGNMENT - 1) / MESH_COOKED_ALIGNMENT * MESH_COOKED_ALIGNMENT;
+	}
+
+	bool CookedArrayFits(int offset, int count, int elementSize, size_t fileSize)
+	{
+		return offset >= 0 && count >= 0 && offset % MESH_COOKED_ALIGNMENT == 0 &&
+			(size_t)offset + (size_t)count*(size_t)elementSize <= fileSize;
+	}
+}
 
 Mesh::Mesh() :
 	m_halfEdges(nullptr),
@@ -8,7 +55,11 @@ Mesh::Mesh() :
 	m_verts(nullptr),
 	m_nHalfEdges(0),
 	m_nFaces(0),
-	m_nVerts(0)
+	m_nVerts(0),
+	m_file(nullptr),
+	m_volume(0.0),
+	m_centerOfMass(0.0, 0.0, 0.0),
+	m_unitInertia(dMat33::Identity().Scale(0.0))
 {
 }
 
@@ -21,16 +72,34 @@ Mesh::Mesh(const fVec3* const pointCloud, int nPoints) : Mesh()
 
 Mesh::~Mesh()
 {
-	delete[] m_halfEdges;
-	delete[] m_faces;
-	delete[] m_verts;
+	FreeMesh();
+}
+
+void Mesh::FreeMesh()
+{
+	if (m_file != nullptr)
+	{
+		delete m_file;
+		m_file = nullptr;
+	}
+	else
+	{
+		delete[] m_halfEdges;
+		delete[] m_faces;
+		delete[] m_verts;
+	}
+
+	m_halfEdges = nullptr;
+	m_faces = nullptr;
+	m_verts = nullptr;
+	m_nHalfEdges = 0;
+	m_nFaces = 0;
+	m_nVerts = 0;
 }
 
 void Mesh::AllocateMesh(int nEdges, int nFaces, int nVerts)
 {
-	delete[] m_halfEdges;
-	delete[] m_faces;
-	delete[] m_verts;
+	FreeMesh();
 	
 	m_nHalfEdges = 2 * nEdges;
 	m_nFaces = nFaces;
@@ -41,6 +110,143 @@ void Mesh::AllocateMesh(int nEdges, int nFaces, int nVerts)
 	m_verts = new fVec3[m_nVerts];
 }
 
+bool Mesh::WriteCooked(const char* fileName) const
+{
+	CookedMeshHeader header;
+	std::memset(&header, 0, sizeof(header));
+
+	std::memcpy(header.magic, g_cookedMagic, sizeof(header.magic));
+	header.version = MESH_COOKED_VERSION;
+	header.halfEdgeSize = (int)sizeof(HalfEdge);
+	header.faceSize = (int)sizeof(Face);
+	header.vertSize = (int)sizeof(fVec3);
+
+	header.nHalfEdges = m_nHalfEdges;
+	header.nFaces = m_nFaces;
+	header.nVerts = m_nVerts;
+	header.nVertEdges = (int)m_iVertEdges.size();
+	header.nSupportMap = (int)m_iSupportMap.size();
+	header.supportMapRes = MESH_SUPPORT_MAP_RES;
+
+	header.halfEdgeOffset = AlignCooked((int)sizeof(header));
+	header.faceOffset = AlignCooked(header.halfEdgeOffset + m_nHalfEdges*(int)sizeof(HalfEdge));
+	header.vertOffset = AlignCooked(header.faceOffset + m_nFaces*(int)sizeof(Face));
+	header.vertEdgeOffset = AlignCooked(header.vertOffset + m_nVerts*(int)sizeof(fVec3));
+	header.supportMapOffset = AlignCooked(header.vertEdgeOffset + header.nVertEdges*(int)sizeof(int));
+
+	header.volume = m_volume;
+	header.centerOfMass = m_centerOfMass;
+	header.unitInertia = m_unitInertia;
+	header.localOOBB = m_localOOBB;
+
+	std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		return false;
+	}
+
+	int position = 0;
+	auto Write = [&](int offset, const void* data, int size)
+	{
+		static const char padding[MESH_COOKED_ALIGNMENT] = {};
+		file.write(padding, offset - position);
+		file.write((const char*)data, size);
+		position = offset + size;
+	};
+
+	Write(0, &header, (int)sizeof(header));
+	Write(header.halfEdgeOffset, m_halfEdges, m_nHalfEdges*(int)sizeof(HalfEdge));
+	Write(header.faceOffset, m_faces, m_nFaces*(int)sizeof(Face));
+	Write(header.vertOffset, m_verts, m_nVerts*(int)sizeof(fVec3));
+	Write(header.vertEdgeOffset, m_iVertEdges.data(), header.nVertEdges*(int)sizeof(int));
+	Write(header.supportMapOffset, m_iSupportMap.data(), header.nSupportMap*(int)sizeof(int));
+
+	return file.good();
+}
+
+bool Mesh::LoadCooked(const char* fileName)
+{
+	MappedFile* file = new MappedFile;
+	if (!file->Open(fileName) || file->GetSize() < sizeof(CookedMeshHeader))
+	{
+		delete file;
+		return false;
+	}
+
+	char* data = (char*)file->GetData();
+	const CookedMeshHeader& header = *(const CookedMeshHeader*)data;
+
+	if (std::memcmp(header.magic, g_cookedMagic, sizeof(header.magic)) != 0 ||
+		header.version != MESH_COOKED_VERSION ||
+		header.halfEdgeSize != (int)sizeof(HalfEdge) ||
+		header.faceSize != (int)sizeof(Face) ||
+		header.vertSize != (int)sizeof(fVec3) ||
+		!CookedArrayFits(header.halfEdgeOffset, header.nHalfEdges, (int)sizeof(HalfEdge), file->GetSize()) ||
+		!CookedArrayFits(header.faceOffset, header.nFaces, (int)sizeof(Face), file->GetSize()) ||
+		!CookedArrayFits(header.vertOffset, header.nVerts, (int)sizeof(fVec3), file->GetSize()) ||
+		!CookedArrayFits(header.vertEdgeOffset, header.nVertEdges, (int)sizeof(int), file->GetSize()) ||
+		!CookedArrayFits(header.supportMapOffset, header.nSupportMap, (int)sizeof(int), file->GetSize()))
+	{
+		delete file;
+		return false;
+	}
+
+	FreeMesh();
+
+	m_file = file;
+	m_halfEdges = (HalfEdge*)(data + header.halfEdgeOffset);
+	m_faces = (Face*)(data + header.faceOffset);
+	m_verts = (fVec3*)(data + header.vertOffset);
+	m_nHalfEdges = header.nHalfEdges;
+	m_nFaces = header.nFaces;
+	m_nVerts = header.nVerts;
+
+	m_volume = header.volume;
+	m_centerOfMass = header.centerOfMass;
+	m_unitInertia = header.unitInertia;
+	m_localOOBB = header.localOOBB;
+
+	// The support structures are only reused if they were cooked with the same configuration as ours
+
+	const int* iVertEdges = (const int*)(data + header.vertEdgeOffset);
+	const int* iSupportMap = (const int*)(data + header.supportMapOffset);
+
+	if (m_nVerts <= MESH_BRUTE_FORCE_MAX_VERTS && header.nVertEdges == m_nVerts)
+	{
+		m_iVertEdges.assign(iVertEdges, iVertEdges + header.nVertEdges);
+		m_iSupportMap.clear();
+		InitVertBatches();
+	}
+	else if (m_nVerts > MESH_BRUTE_FORCE_MAX_VERTS && header.supportMapRes == MESH_SUPPORT_MAP_RES &&
+		header.nSupportMap == 6 * MESH_SUPPORT_MAP_RES*MESH_SUPPORT_MAP_RES)
+	{
+		m_iSupportMap.assign(iSupportMap, iSupportMap + header.nSupportMap);
+		m_iVertEdges.clear();
+		m_vertBatches.clear();
+	}
+	else
+	{
+		InitSupport();
+	}
+
+	return true;
+}
+
+int Mesh::GetNumVerts() const
+{
+	return m_nVerts;
+}
+
+int Mesh::GetNumHalfEdges() const
+{
+	return m_nHalfEdges;
+}
+
+int Mesh::GetNumFaces() const
+{
+	return m_nFaces;
+}
+
 void Mesh::FaceList::AddFace(const fVec3* verts, const int nVerts, const dVec3& normal)
 {
 	FacePartition fp;
@@ -139,52 +345,238 @@ int Mesh::ISupportEdgeLocal(const dVec3& v, int i_) const
 	return i;
 }
 
-dVec3 Mesh::SupportLocal(const dVec3& v) const
+int Mesh::ISupportEdgeLocal(const dVec3& v) const
 {
-	int i = -1;
-	const dVec3 v_v = v.Times(v);
-	for (int dim = 0; dim < 3; dim++)
+	assert(m_nVerts > 0);
+
+	if (m_nVerts <= MESH_BRUTE_FORCE_MAX_VERTS)
+	{
+		return m_iVertEdges[ISupportVertBruteForce(v)];
+	}
+
+	int i = m_iSupportMap[SupportMapCell(v)];
+	const HalfEdge* e = &m_halfEdges[i];
+	const int j = e->iTwin;
+	const HalfEdge* t = &m_halfEdges[j];
+	const dVec3 B(m_verts[e->iVert]);
+	const dVec3 A(m_verts[t->iVert]);
+	if (v.Dot(B - A) < 0.0)
+	{
+		i = j;
+	}
+	return ISupportEdgeLocal(v, i);
+}
+
+int Mesh::ISupportVertBruteForce(const dVec3& v) const
+{
+	const Simd::Double4 vx = Simd::Splat(v.x);
+	const Simd::Double4 vy = Simd::Splat(v.y);
+	const Simd::Double4 vz = Simd::Splat(v.z);
+
+	// Each lane tracks the best vertex it has seen, by the index of its batch
+	Simd::Double4 dBest = Simd::Splat(-DBL_MAX);
+	Simd::Double4 iBest = Simd::Splat(0.0);
+
+	for (int i = 0; i < (int)m_vertBatches.size(); ++i)
+	{
+		const VertBatch& batch = m_vertBatches[i];
+		const Simd::Double4 d = batch.x*vx + batch.y*vy + batch.z*vz;
+		const Simd::Double4 better = Simd::Greater(d, dBest);
+		dBest = Simd::Select(better, d, dBest);
+		iBest = Simd::Select(better, Simd::Splat((double)i), iBest);
+	}
+
+	alignas(32) double d[4];
+	alignas(32) double iBatch[4];
+	Simd::Store(d, dBest);
+	Simd::Store(iBatch, iBest);
+
+	int lane = 0;
+	for (int j = 1; j < 4; ++j)
 	{
-		if (v_v[dim] >= v_v[(dim + 1) % 3] && v_v[dim] >= v_v[(dim + 2) % 3])
+		if (d[j] > d[lane])
 		{
-			i = (v[dim] < 0.0) ? m_iCardinalEdges[dim][0] : m_iCardinalEdges[dim][1];
-			const HalfEdge* e = &m_halfEdges[i];
-			const int j = e->iTwin;
-			const HalfEdge* t = &m_halfEdges[j];
-			const dVec3 B(m_verts[e->iVert]);
-			const dVec3 A(m_verts[t->iVert]);
-			if (v.Dot(B - A) < 0.0)
-			{
-				i = j;
-			}
-			break;
+			lane = j;
 		}
 	}
-	const int iSupportEdge = ISupportEdgeLocal(v, i);
+	return 4 * (int)iBatch[lane] + lane;
+}
+
+int Mesh::SupportMapCell(const dVec3& v) const
+{
+	// Project v onto the side of the cube it points through
+
+	const dVec3 a(abs(v.x), abs(v.y), abs(v.z));
+	const int dim = (a.x >= a.y && a.x >= a.z) ? 0 : (a.y >= a.z ? 1 : 2);
+	const int side = 2 * dim + (v[dim] < 0.0 ? 0 : 1);
+
+	if (a[dim] == 0.0)
+	{
+		return side*MESH_SUPPORT_MAP_RES*MESH_SUPPORT_MAP_RES;
+	}
+
+	const double scale = 0.5*(double)MESH_SUPPORT_MAP_RES / a[dim];
+	const int row = std::min((int)((v[(dim + 1) % 3] + a[dim])*scale), MESH_SUPPORT_MAP_RES - 1);
+	const int col = std::min((int)((v[(dim + 2) % 3] + a[dim])*scale), MESH_SUPPORT_MAP_RES - 1);
+
+	return (side*MESH_SUPPORT_MAP_RES + row)*MESH_SUPPORT_MAP_RES + col;
+}
+
+dVec3 Mesh::SupportLocal(const dVec3& v) const
+{
+	const int iSupportEdge = ISupportEdgeLocal(v);
 	const HalfEdge& supportEdge = m_halfEdges[iSupportEdge];
 	const int iSupportVert = supportEdge.iVert;
 	return dVec3(m_verts[iSupportVert]);
 }
 
-void Mesh::InitCardinalEdges()
+int Mesh::SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const
 {
-	m_iCardinalEdges[0][0] = ISupportEdgeLocal(dVec3(-1.0, 0.0, 0.0), 0);
+	// Of the faces incident to the support vertex, pick the one whose normal is most aligned with v.
+
+	const int iSupportEdge = ISupportEdgeLocal(v);
 
-	m_iCardinalEdges[1][0] = ISupportEdgeLocal(dVec3(0.0, -1.0, 0.0), m_iCardinalEdges[0][0]);
-	m_iCardinalEdges[1][1] = ISupportEdgeLocal(dVec3(0.0, 1.0, 0.0), m_iCardinalEdges[0][0]);
-	m_iCardinalEdges[2][0] = ISupportEdgeLocal(dVec3(0.0, 0.0, -1.0), m_iCardinalEdges[0][0]);
-	m_iCardinalEdges[2][1] = ISupportEdgeLocal(dVec3(0.0, 0.0, 1.0), m_iCardinalEdges[0][0]);
+	int iBestFace = -1;
+	double d_best = -DBL_MAX;
 
-	m_iCardinalEdges[0][1] = ISupportEdgeLocal(dVec3(1.0, 0.0, 0.0), m_iCardinalEdges[2][1]);
+	int i = iSupportEdge;
+	do
+	{
+		const HalfEdge& e = m_halfEdges[i];
+		const double d = m_faces[e.iFace].normal.Dot(v);
+		if (d > d_best)
+		{
+			iBestFace = e.iFace;
+			d_best = d;
+		}
+		i = m_halfEdges[e.iNext].iTwin; // the next edge pointing to the support vertex
+	} while (i != iSupportEdge);
+
+	const Face& face = m_faces[iBestFace];
+	int n = 0;
+	i = face.iEdge;
+	do
+	{
+		const HalfEdge& e = m_halfEdges[i];
+		if (n == maxVerts)
+		{
+			// The face has too many vertices to report; fall back to the support vertex alone.
+			verts[0] = dVec3(m_verts[m_halfEdges[iSupportEdge].iVert]);
+			return 1;
+		}
+		verts[n++] = dVec3(m_verts[e.iVert]);
+		i = e.iNext;
+	} while (i != face.iEdge);
+
+	return n;
+}
 
-	for (int dim = 0; dim < 3; ++dim)
+void Mesh::InitSupport()
+{
+	m_vertBatches.clear();
+	m_iVertEdges.clear();
+	m_iSupportMap.clear();
+
+	if (m_nVerts == 0)
 	{
-		m_localOOBB.min[dim] = m_verts[m_halfEdges[m_iCardinalEdges[dim][0]].iVert][dim];
-		m_localOOBB.max[dim] = m_verts[m_halfEdges[m_iCardinalEdges[dim][1]].iVert][dim];
+		return;
+	}
+
+	m_localOOBB.min = dVec3(m_verts[0]);
+	m_localOOBB.max = dVec3(m_verts[0]);
+	for (int i = 1; i < m_nVerts; ++i)
+	{
+		for (int dim = 0; dim < 3; ++dim)
+		{
+			m_localOOBB.min[dim] = std::min(m_localOOBB.min[dim], (double)m_verts[i][dim]);
+			m_localOOBB.max[dim] = std::max(m_localOOBB.max[dim], (double)m_verts[i][dim]);
+		}
+	}
+
+	if (m_nVerts <= MESH_BRUTE_FORCE_MAX_VERTS)
+	{
+		m_iVertEdges.resize(m_nVerts);
+		for (int i = 0; i < m_nHalfEdges; ++i)
+		{
+			m_iVertEdges[m_halfEdges[i].iVert] = i;
+		}
+
+		InitVertBatches();
+	}
+	else
+	{
+		// Neighbouring cells have nearby support vertices, so each cell's search starts from the previous one's result
+
+		m_iSupportMap.resize(6 * MESH_SUPPORT_MAP_RES*MESH_SUPPORT_MAP_RES);
+		int iEdge = 0;
+		for (int side = 0; side < 6; ++side)
+		{
+			const int dim = side / 2;
+			for (int row = 0; row < MESH_SUPPORT_MAP_RES; ++row)
+			{
+				for (int col = 0; col < MESH_SUPPORT_MAP_RES; ++col)
+				{
+					dVec3 v;
+					v[dim] = (side % 2 == 0) ? -1.0 : 1.0;
+					v[(dim + 1) % 3] = 2.0*((double)row + 0.5) / (double)MESH_SUPPORT_MAP_RES - 1.0;
+					v[(dim + 2) % 3] = 2.0*((double)col + 0.5) / (double)MESH_SUPPORT_MAP_RES - 1.0;
+
+					iEdge = ISupportEdgeLocal(v, iEdge);
+					m_iSupportMap[(side*MESH_SUPPORT_MAP_RES + row)*MESH_SUPPORT_MAP_RES + col] = iEdge;
+				}
+			}
+		}
 	}
 }
 
-dVec3 Mesh::CenterOfMassLocal_Solid(double& VOLUME) const
+void Mesh::InitVertBatches()
+{
+	m_vertBatches.resize((m_nVerts + 3) / 4);
+	for (int i = 0; i < (int)m_vertBatches.size(); ++i)
+	{
+		alignas(32) double x[4];
+		alignas(32) double y[4];
+		alignas(32) double z[4];
+		for (int j = 0; j < 4; ++j)
+		{
+			const int iVert = (4 * i + j < m_nVerts) ? 4 * i + j : 0;
+			x[j] = (double)m_verts[iVert].x;
+			y[j] = (double)m_verts[iVert].y;
+			z[j] = (double)m_verts[iVert].z;
+		}
+		m_vertBatches[i].x = Simd::Load(x);
+		m_vertBatches[i].y = Simd::Load(y);
+		m_vertBatches[i].z = Simd::Load(z);
+	}
+}
+
+void Mesh::InitMassProperties()
+{
+	if (m_nFaces == 0)
+	{
+		m_volume = 0.0;
+		m_centerOfMass = dVec3(0.0, 0.0, 0.0);
+		m_unitInertia = dMat33::Identity().Scale(0.0);
+		return;
+	}
+
+	m_centerOfMass = ComputeCenterOfMass_Solid(m_volume);
+	m_unitInertia = ComputeInertia_Solid(m_centerOfMass);
+}
+
+dVec3 Mesh::CenterOfMassLocal_Solid(double& volume) const
+{
+	volume = m_volume;
+	return m_centerOfMass;
+}
+
+dMat33 Mesh::InertiaLocal_Solid(double density, double& mass) const
+{
+	mass = density*m_volume;
+	return m_unitInertia.Scale(density);
+}
+
+dVec3 Mesh::ComputeCenterOfMass_Solid(double& VOLUME) const
 {
 	dVec3 o(0.0, 0.0, 0.0);
 	for (int i = 0; i < m_nVerts; ++i)
@@ -332,12 +724,8 @@ dMat33 TetrahedronInertia(const dVec3& v1, const dVec3& v2, const dVec3& v3, con
 	return I;
 }
 
-dMat33 Mesh::InertiaLocal_Solid(double density, double& mass) const
+dMat33 Mesh::ComputeInertia_Solid(const dVec3& o) const
 {
-	double volume;
-	dVec3 o = CenterOfMassLocal_Solid(volume);
-	mass = density*volume;
-
 	dMat33 I;
 	I(0, 0) = 0.0;
 	I(0, 1) = 0.0;
@@ -395,7 +783,7 @@ dMat33 Mesh::InertiaLocal_Solid(double density, double& mass) const
 			I = I + TetrahedronInertia(A, B, C, o);
 		}
 	}
-	return I.Scale(density);
+	return I;
 }
 
 void Mesh::ShiftToCenterOfMass_Solid()
@@ -406,6 +794,8 @@ void Mesh::ShiftToCenterOfMass_Solid()
 	{
 		m_verts[i] = m_verts[i] - com;
 	}
+	InitSupport();
+	InitMassProperties();
 
 	const dVec3 c = CenterOfMassLocal_Solid(v);
 	assert(c.Dot(c) < 0.0001);
@@ -1,7 +1,22 @@
 #pragma once
 #include "Geometry.h"
+#include "Simd.h"
 
 class QuickHull;
+class MappedFile;
+
+// Hulls with at most this many vertices find their support point by brute force, four vertices at a time.
+// Larger hulls hill-climb from the vertex that a cube map of directions (MESH_SUPPORT_MAP_RES^2 cells per side) precomputed
+// for the support direction, which is already close to the support point, so only a step or two remains.
+#define MESH_BRUTE_FORCE_MAX_VERTS 32
+#define MESH_SUPPORT_MAP_RES 8
+
+// Cooked meshes are written once offline (the hull, its support acceleration structures, its mass properties, and
+// its local OOBB), and loaded with a single memory map. The halfedges, faces, and vertices are already index-based,
+// so they're used in place without any fix-up. The format is specific to the platform (and build) that wrote it.
+#define MESH_COOKED_VERSION 1
+// Each array in a cooked mesh starts at a multiple of this many bytes
+#define MESH_COOKED_ALIGNMENT 16
 
 class Mesh :
 	public Geometry
@@ -45,8 +60,18 @@ public:
 
 	void AllocateMesh(int nEdges, int nFaces, int nVerts);
 
+	// Both return false on failure. LoadCooked leaves the mesh unchanged if so.
+	bool WriteCooked(const char* fileName) const;
+	bool LoadCooked(const char* fileName);
+
+	int GetNumVerts() const;
+	int GetNumHalfEdges() const;
+	int GetNumFaces() const;
+
 	virtual dVec3 SupportLocal(const dVec3& v) const;
+	virtual int SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const;
 
+	// Mass properties are computed when the hull is built (or loaded with a cooked mesh), so these are just lookups
 	dVec3 CenterOfMassLocal_Solid(double& volume) const;
 
 	dMat33 InertiaLocal_Solid(double kilogramPerCubicMeter, double& mass) const;
@@ -90,7 +115,22 @@ protected:
 	// entryEdge is the starting point of our steepest descent search.
 	// The returned HalfEdge's vert is the support point.
 	int ISupportEdgeLocal(const dVec3& v, int iEntryEdge) const;
-	void InitCardinalEdges();
+	// Same as above, but for small hulls by brute force, and for large hulls starting from the support map.
+	int ISupportEdgeLocal(const dVec3& v) const;
+	// The index of the vertex with the largest projection onto v, searching all the vertices
+	int ISupportVertBruteForce(const dVec3& v) const;
+	// The cell of the support map that v points through
+	int SupportMapCell(const dVec3& v) const;
+	// Builds the support acceleration structures and the local OOBB. Call whenever the vertices change.
+	void InitSupport();
+	void InitVertBatches();
+	// Computes the mass properties. Call whenever the vertices change.
+	void InitMassProperties();
+	dVec3 ComputeCenterOfMass_Solid(double& volume) const;
+	dMat33 ComputeInertia_Solid(const dVec3& centerOfMass) const;
+
+	// Releases the halfedges, faces, and vertices, whether allocated or mapped
+	void FreeMesh();
 
 	HalfEdge*	m_halfEdges;
 	int			m_nHalfEdges;
@@ -99,13 +139,24 @@ protected:
 	fVec3*		m_verts;
 	int			m_nVerts;
 
-	// m_iCardinalEdge[i][0] corresponds to the edge pointing to the vertex that is minimal in the ith-direction
-	// m_iCardinalEdge[i][1] corresponds to the edge pointing to the vertex that is maximal in the ith-direction
-	// i=0 corresponds to the x direction
-	// i=1 corresponds to the y direction
-	// i=2 corresponds to the z direction
-	// (This is to slightly accelerate the Support function)
+	// The cooked file that the halfedges, faces, and vertices point into, if the mesh was loaded from one
+	MappedFile*	m_file;
+
+	double		m_volume;
+	dVec3		m_centerOfMass;
+	dMat33		m_unitInertia; // about the center of mass, for a density of 1
+
+	// A copy of the vertices, four to a batch (structure of arrays), for the brute force support of small hulls.
+	// The last batch is padded with copies of vertex 0. The halfedge pointing to each vertex is kept in m_iVertEdges.
+	struct VertBatch
+	{
+		Simd::Double4 x, y, z;
+	};
+	std::vector<VertBatch, Simd::AlignedAllocator<VertBatch>> m_vertBatches;
+	std::vector<int> m_iVertEdges;
 
-	int			m_iCardinalEdges[3][2];
+	// The support map of large hulls. The cells of cube side s (the axis s/2, negative if s is even) are laid out
+	// row by row, and each holds the halfedge pointing to the support vertex of the direction through its center.
+	std::vector<int> m_iSupportMap;
 };
 
@@ -0,0 +1,14 @@
+#pragma once
+#include "YshMath.h"
+
+// Receives statistics from PhysicsScene::Step, so that the cost of a step can be monitored (and the solver
+// configuration tuned to bound it). Callbacks are made on the thread that steps the scene.
+
+class PhysicsInstrumentation
+{
+public:
+	virtual ~PhysicsInstrumentation() {}
+
+	// Called once per island per step, after its contacts have been solved. solveTime is in seconds.
+	virtual void OnIslandSolved(int nContacts, const MathUtils::GaussSeidelStats& stats, double solveTime) = 0;
+};
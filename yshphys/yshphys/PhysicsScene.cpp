@@ -1,14 +1,56 @@
 #include "stdafx.h"
 #include "PhysicsScene.h"
-#include "Force_Constant.h"
 #include "Material.h"
+#include "ContactManifold.h"
+#include "ContactSolver.h"
+#include "Triangle.h"
 
-#define COLINEAR_ANGLE_THRESH (dPI*0.25)
+namespace
+{
+	// The bounds, in the parent frame, of box in the frame at pos and rot
+	BoundingBox TransformBounds(const BoundingBox& box, const dVec3& pos, const dQuat& rot)
+	{
+		const dVec3 center = pos + rot.Transform((box.min + box.max).Scale(0.5));
+		const dVec3 span = dMat33(rot).Abs().Transform((box.max - box.min).Scale(0.5));
+		BoundingBox bounds;
+		bounds.min = center - span;
+		bounds.max = center + span;
+		return bounds;
+	}
+
+	// Extends box over its motion by sweep
+	void SweepBounds(BoundingBox& box, const dVec3& sweep)
+	{
+		for (int dim = 0; dim < 3; ++dim)
+		{
+			box.min[dim] += std::min(0.0, sweep[dim]);
+			box.max[dim] += std::max(0.0, sweep[dim]);
+		}
+	}
+
+	// The bounds of the world box in the frame at pos and rot, padded so as to catch the parts within contact range
+	BoundingBox LocalBounds(const BoundingBox& box, const dVec3& pos, const dQuat& rot)
+	{
+		BoundingBox bounds = TransformBounds(box, (-rot).Transform(-pos), -rot);
+		const dVec3 padding = dVec3(1.0, 1.0, 1.0).Scale(CONTACTMANIFOLD_SEPARATION_TOL);
+		bounds.min = bounds.min - padding;
+		bounds.max = bounds.max + padding;
+		return bounds;
+	}
+}
 
-PhysicsScene::PhysicsScene() : m_firstNode(nullptr), m_firstIsland(nullptr)
+PhysicsScene::PhysicsScene() :
+	m_firstNode(nullptr),
+	m_firstIsland(nullptr),
+	m_solverConfig(ContactSolver::DefaultConfig()),
+	m_instrumentation(nullptr),
+	m_threadPool(nullptr)
 {
 	Material::InitializeTables();
 
+	m_integratorConfig.integrator = INTEGRATOR_RK4;
+	m_integratorConfig.gyroscopic = true;
+
 	m_physicsNodes = new PhysicsNode[MAX_PHYSICS_NODES];
 
 	for (int i = 0; i < MAX_PHYSICS_NODES - 1; ++i)
@@ -176,6 +218,38 @@ const BVTree& PhysicsScene::GetBVTree() const
 	return m_bvTree;
 }
 
+void PhysicsScene::SetSolverConfig(const MathUtils::GaussSeidelConfig& config)
+{
+	assert(config.maxIterations >= 0);
+	assert(config.relaxation > 0.0 && config.relaxation < 2.0);
+	m_solverConfig = config;
+}
+
+const MathUtils::GaussSeidelConfig& PhysicsScene::GetSolverConfig() const
+{
+	return m_solverConfig;
+}
+
+void PhysicsScene::SetIntegratorConfig(const IntegratorConfig& config)
+{
+	m_integratorConfig = config;
+}
+
+const IntegratorConfig& PhysicsScene::GetIntegratorConfig() const
+{
+	return m_integratorConfig;
+}
+
+void PhysicsScene::SetInstrumentation(PhysicsInstrumentation* instrumentation)
+{
+	m_instrumentation = instrumentation;
+}
+
+void PhysicsScene::SetThreadPool(ThreadPool* threadPool)
+{
+	m_threadPool = threadPool;
+}
+
 void PhysicsScene::AddPhysicsObject(RigidBody* physicsObject)
 {
 	if (!m_freedNodeStack.empty())
@@ -217,34 +291,131 @@ void PhysicsScene::RemovePhysicsObject(RigidBody* physicsObject)
 
 		physicsObject->GetBVNode()->Detach();
 	}
+
+	auto it = m_manifolds.begin();
+	while (it != m_manifolds.end())
+	{
+		if (it->first.first.first == physicsObject || it->first.first.second == physicsObject)
+		{
+			it = m_manifolds.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
 }
 
-void CreateCoordinateSystem(dVec3& xAxis, dVec3& yAxis, const dVec3& zAxis)
+ContactManifold* PhysicsScene::UpdateManifold(const ManifoldKey& key,
+	const Geometry* geom0, const dVec3& pos0, const dQuat& rot0,
+	const Geometry* geom1, const dVec3& pos1, const dQuat& rot1,
+	bool parts)
 {
-	for (int i = 0; i < 3; ++i)
+	auto cached = m_manifolds.find(key);
+
+	// Pairs that have barely moved relative to each other skip the narrowphase, and just track their points
+
+	if (cached == m_manifolds.end() ||
+		!cached->second.manifold.IsReusable(pos0, rot0, pos1, rot1) ||
+		!cached->second.manifold.Refresh(pos0, rot0, pos1, rot1))
 	{
-		const int j = (i + 1) % 3;
-		const int k = (i + 2) % 3;
+		dVec3 x0, x1, n0, n1;
+		bool separated = false;
+
+		const bool fast = key.first.first->IsFast() || key.first.second->IsFast();
+		if (fast || parts)
+		{
+			// A fast body gets speculative contacts with what it's about to hit: the manifold of separated geometries is
+			// built between their closest points, and has negative depths. The solver lets the gaps close over the step,
+			// but no further. The sphere-sphere shortcut of Intersect is skipped, since it doesn't return closest points.
+			// Parts get the same within the separation tolerance: a shape resting on a mesh sits at zero depth, where GJK
+			// finds only some of the triangles under it touching, and a shape supported by some of its contacts tips over.
+			GJKSimplex simplex;
+			if (!Geometry::Intersect(geom0, pos0, rot0, x0, n0, geom1, pos1, rot1, x1, n1, simplex))
+			{
+				n0 = x1 - x0;
+				if (n0.Dot(n0) < DBL_EPSILON)
+				{
+					// Touching, which is where a speculative contact leaves a body that it stopped. GJK has no direction
+					// between the closest points, so the pair keeps the normal of its last manifold and touches at zero depth.
+					if (cached == m_manifolds.end())
+					{
+						return nullptr;
+					}
+					n0 = cached->second.manifold.n;
+				}
+				else if (!fast && n0.Dot(n0) > CONTACTMANIFOLD_SEPARATION_TOL*CONTACTMANIFOLD_SEPARATION_TOL)
+				{
+					return nullptr;
+				}
+				else
+				{
+					separated = true;
+				}
+			}
+		}
+		else if (!Geometry::Intersect(geom0, pos0, rot0, x0, n0, geom1, pos1, rot1, x1, n1))
+		{
+			return nullptr;
+		}
+		n0 = n0.Scale(1.0 / sqrt(n0.Dot(n0)));
 
-		if (abs(zAxis[i]) <= abs(zAxis[j]) && abs(zAxis[i]) <= abs(zAxis[k]))
+		// Against an internal edge of a triangle mesh, the normal is the face normal (see Triangle::CorrectInternalNormal),
+		// and the points are the deepest point of the other geometry along it and its projection onto the triangle.
+		for (int i = 0; i < 2; ++i)
 		{
-			yAxis;
-			yAxis[i] = 0.0;
-			yAxis[j] = zAxis[k];
-			yAxis[k] = -zAxis[j];
-			yAxis.Scale(1.0 / sqrt(zAxis[j] * zAxis[j] + zAxis[k] * zAxis[k]));
+			const Geometry* geom = i == 0 ? geom0 : geom1;
+			if (geom->GetType() != EGeomType::TRIANGLE)
+			{
+				continue;
+			}
+			const Triangle* tri = (const Triangle*)geom;
+			const dVec3& pos = i == 0 ? pos0 : pos1;
+			const dQuat& rot = i == 0 ? rot0 : rot1;
+			dVec3& xTri = i == 0 ? x0 : x1;
+			dVec3& xOther = i == 0 ? x1 : x0;
+
+			dVec3 nLocal = (-rot).Transform(i == 0 ? n0 : -n0);
+			if (tri->CorrectInternalNormal((-rot).Transform(xTri - pos), nLocal))
+			{
+				const dVec3 nTri = rot.Transform(nLocal);
+				xOther = i == 0 ? geom1->Support(pos1, rot1, -nTri) : geom0->Support(pos0, rot0, -nTri);
+				xTri = xOther + nTri.Scale((pos + rot.Transform(tri->GetVertex(0)) - xOther).Dot(nTri));
+				n0 = i == 0 ? nTri : -nTri;
+			}
+		}
+
+		const double maxSeparation = separated ?
+			CONTACTMANIFOLD_SEPARATION_TOL + std::max(0.0, (x1 - x0).Dot(n0)) :
+			CONTACTMANIFOLD_SEPARATION_TOL;
 
-			xAxis = yAxis.Cross(zAxis);
+		ContactManifold manifold;
+		manifold.Build(geom0, pos0, rot0, x0, geom1, pos1, rot1, x1, n0, maxSeparation);
 
-			return;
+		if (cached == m_manifolds.end())
+		{
+			cached = m_manifolds.insert(std::make_pair(key, CachedManifold())).first;
+		}
+		else
+		{
+			manifold.Merge(cached->second.manifold);
 		}
+		cached->second.manifold = manifold;
 	}
-	assert(false);
+	cached->second.active = true;
+
+	return &cached->second.manifold;
 }
 
 void PhysicsScene::ComputeContacts()
 {
 	assert(m_firstIsland == nullptr);
+
+	for (auto& entry : m_manifolds)
+	{
+		entry.second.active = false;
+	}
+
 	std::vector<BVNodePair> intersectingLeaves = m_bvTree.Root()->FindIntersectingLeaves();
 	for (BVNodePair pair : intersectingLeaves)
 	{
@@ -260,11 +431,17 @@ void PhysicsScene::ComputeContacts()
 			continue;
 		}
 
+		// The BVTree doesn't order its pairs consistently, but the manifold cache needs to
+		if (std::less<RigidBody*>()(body[1], body[0]))
+		{
+			std::swap(body[0], body[1]);
+		}
+
 		contact.body[0] = body[0];
 		contact.body[1] = body[1];
 
-		Geometry* geom0 = contact.body[0]->GetGeometry();
-		Geometry* geom1 = contact.body[1]->GetGeometry();
+		const Geometry* geom0 = contact.body[0]->GetGeometry();
+		const Geometry* geom1 = contact.body[1]->GetGeometry();
 
 		dVec3 pos0, pos1;
 		dQuat rot0, rot1;
@@ -272,160 +449,164 @@ void PhysicsScene::ComputeContacts()
 		contact.body[0]->GetGeometryGlobalTransform(pos0, rot0);
 		contact.body[1]->GetGeometryGlobalTransform(pos1, rot1);
 
-		dVec3 x0, x1, n0, n1;
+		const BodyPair key(body[0], body[1]);
 
-		if (Geometry::Intersect(geom0, pos0, rot0, x0, n0, geom1, pos1, rot1, x1, n1))
-		{
-//			assert(abs(n0.z) > 0.999);
-
-			const double k = 256.0;
-			double penetration = (x1 - x0).Dot(n1);
-			assert(penetration > 0.0);
-			penetration = std::min(0.05, penetration);
-			const dVec3 d = n1.Scale(penetration);
-
-			Force_Constant* penalty0 = new Force_Constant();
-			Force_Constant* penalty1 = new Force_Constant();
-			penalty0->offset = dVec3(0.0, 0.0, 0.0);
-			penalty1->offset = dVec3(0.0, 0.0, 0.0);
-			penalty0->F = d.Scale(contact.body[0]->GetMass()*k);
-			penalty1->F = -d.Scale(contact.body[1]->GetMass()*k);
-			contact.body[0]->ApplyBruteForce(penalty0);
-			contact.body[1]->ApplyBruteForce(penalty1);
-
-			assert(abs(penalty0->F.x) < 1000000.0f);
-			assert(abs(penalty0->F.y) < 1000000.0f);
-			assert(abs(penalty0->F.z) < 1000000.0f);
-			assert(abs(penalty1->F.x) < 1000000.0f);
-			assert(abs(penalty1->F.y) < 1000000.0f);
-			assert(abs(penalty1->F.z) < 1000000.0f);
-
-			contact.n[0] = -n0;
-			contact.n[1] = -n1;
-
-			dVec3 xHat, yHat;
-
-			CreateCoordinateSystem(xHat,yHat,n0);
-			dVec3 xPlane = (x0 + x1).Scale(0.5);
-
-			dMat33 RPlane0;
-			RPlane0.SetColumn(0, xHat);
-			RPlane0.SetColumn(1, yHat);
-			RPlane0.SetColumn(2, n0);
-
-			Polygon poly0 = geom0->IntersectPlane(pos0, rot0, xPlane, n0, xHat, yHat);
-			Polygon poly1 = geom1->IntersectPlane(pos1, rot1, xPlane, -n0, -xHat, yHat);
-			Polygon intersectionPoly;
-			int nVerts0, nVerts1;
-			const fVec2* verts0 = poly0.GetVertices(nVerts0);
-			const fVec2* verts1 = poly1.GetVertices(nVerts1);
-			if (nVerts0 == 1)
-			{
-				intersectionPoly = poly0;
-			}
-			else if (nVerts1 == 1)
-			{
-				intersectionPoly = poly1.ReflectX();
-			}
-			else
+		m_pairManifolds.clear();
+
+		if (!geom0->IsConcave() && !geom1->IsConcave())
+		{
+			if (ContactManifold* manifold = UpdateManifold(ManifoldKey(key, PartPair(0, 0)), geom0, pos0, rot0, geom1, pos1, rot1, false))
 			{
-				intersectionPoly = poly0.Intersect(poly1.ReflectX());
+				m_pairManifolds.push_back(manifold);
 			}
-			intersectionPoly = intersectionPoly.PruneColinearVertices(COLINEAR_ANGLE_THRESH);
-//			intersectionPoly = intersectionPoly.LimitVertices(3);
+		}
+		else
+		{
+			// Each part of geom0 near body 1 collides with each part of geom1 near it, with a manifold per pair of parts
+			// (a convex geometry being its own only part). The parts near a body or a part are those overlapping its AABB,
+			// swept over its motion relative to the other body (if either is fast), taken into the other geometry's frame.
 
-			int nVerts;
-			const fVec2* verts = intersectionPoly.GetVertices(nVerts);
+			const dVec3 sweep = body[0]->GetSweep() - body[1]->GetSweep();
 
-			Island* island[2];
-			island[0] = contact.body[0]->GetIsland();
-			island[1] = contact.body[1]->GetIsland();
+			BoundingBox aabb1 = body[1]->GetAABB(); // already swept over body 1's own motion
+			SweepBounds(aabb1, -body[0]->GetSweep());
 
-			auto CreateNewIsland = [&]()
+			geom0->ForEachPart(LocalBounds(aabb1, pos0, rot0),
+				[&](int iPart0, const Geometry* part0, const dVec3& partPos0, const dQuat& partRot0)
 			{
-				Island* newIsland = new Island();
-				if (m_firstIsland == nullptr)
+				const dQuat rotPart0 = rot0*partRot0;
+				const dVec3 posPart0 = pos0 + rot0.Transform(partPos0);
+
+				BoundingBox aabb0 = TransformBounds(part0->GetLocalOOBB(), posPart0, rotPart0);
+				SweepBounds(aabb0, sweep);
+
+				geom1->ForEachPart(LocalBounds(aabb0, pos1, rot1),
+					[&](int iPart1, const Geometry* part1, const dVec3& partPos1, const dQuat& partRot1)
 				{
-					m_firstIsland = newIsland;
-				}
-				// Add the new island to the end of the "ring"
-				newIsland->PrependTo(m_firstIsland);
-				return newIsland;
-			};
+					const dQuat rotPart1 = rot1*partRot1;
+					const dVec3 posPart1 = pos1 + rot1.Transform(partPos1);
+					if (ContactManifold* manifold = UpdateManifold(ManifoldKey(key, PartPair(iPart0, iPart1)),
+						part0, posPart0, rotPart0, part1, posPart1, rotPart1, true))
+					{
+						m_pairManifolds.push_back(manifold);
+					}
+				});
+			});
+		}
 
-			Island* isl = nullptr;
+		if (m_pairManifolds.empty())
+		{
+			continue;
+		}
+
+		Island* island[2];
+		island[0] = contact.body[0]->GetIsland();
+		island[1] = contact.body[1]->GetIsland();
 
-			if (body[0]->IsStatic())
+		auto CreateNewIsland = [&]()
+		{
+			Island* newIsland = new Island();
+			if (m_firstIsland == nullptr)
 			{
-				isl = (island[1] == nullptr) ? CreateNewIsland() : island[1];
+				m_firstIsland = newIsland;
 			}
-			else if (body[1]->IsStatic())
+			// Add the new island to the end of the "ring"
+			newIsland->PrependTo(m_firstIsland);
+			return newIsland;
+		};
+
+		Island* isl = nullptr;
+
+		if (body[0]->IsStatic())
+		{
+			isl = (island[1] == nullptr) ? CreateNewIsland() : island[1];
+		}
+		else if (body[1]->IsStatic())
+		{
+			isl = (island[0] == nullptr) ? CreateNewIsland() : island[0];
+		}
+		else // both bodies are nonstatic
+		{
+			if (island[0] == nullptr && island[1] == nullptr)
 			{
-				isl = (island[0] == nullptr) ? CreateNewIsland() : island[0];
+				isl = CreateNewIsland();
 			}
-			else // both bodies are nonstatic
+			else if (island[0] == nullptr)
 			{
-				if (island[0] == nullptr && island[1] == nullptr)
-				{
-					isl = CreateNewIsland();
-				}
-				else if (island[0] == nullptr)
-				{
-					isl = island[1];
-				}
-				else if (island[1] == nullptr)
-				{
-					isl = island[0];
-				}
-				else if (island[0] == island[1])
-				{
-					isl = island[0];
-				}
-				else // both bodies are already associated with different islands. Then we must merge the islands
+				isl = island[1];
+			}
+			else if (island[1] == nullptr)
+			{
+				isl = island[0];
+			}
+			else if (island[0] == island[1])
+			{
+				isl = island[0];
+			}
+			else // both bodies are already associated with different islands. Then we must merge the islands
+			{
+				if (m_firstIsland == island[1])
 				{
-					if (m_firstIsland == island[1])
-					{
-						assert(island[1]->m_next != island[1]);
-						m_firstIsland = island[1]->m_next;
-					}
-					isl = island[0]->Merge(island[1]);
+					assert(island[1]->m_next != island[1]);
+					m_firstIsland = island[1]->m_next;
 				}
+				isl = island[0]->Merge(island[1]);
 			}
+		}
 
-			if (m_firstIsland != nullptr)
+		if (m_firstIsland != nullptr)
+		{
+			int n0 = 0;
+			int n1 = 0;
+
+			Island* is = m_firstIsland;
+			do
 			{
-				int n0 = 0;
-				int n1 = 0;
+				is = is->m_next;
+				n0++;
+			} while (is != m_firstIsland);
 
-				Island* is = m_firstIsland;
-				do
-				{
-					is = is->m_next;
-					n0++;
-				} while (is != m_firstIsland);
+			is = m_firstIsland;
+			do
+			{
+				is = is->m_prev;
+				n1++;
+			} while (is != m_firstIsland);
 
-				is = m_firstIsland;
-				do
-				{
-					is = is->m_prev;
-					n1++;
-				} while (is != m_firstIsland);
+			assert(n0 == n1);
+		}
 
-				assert(n0 == n1);
-			}
+		for (ContactManifold* manifold : m_pairManifolds)
+		{
+			contact.n[0] = -manifold->n;
+			contact.n[1] = manifold->n;
 
-			for (int i = 0; i < nVerts; ++i)
+			for (int i = 0; i < manifold->nPoints; ++i)
 			{
-				dVec3 x = xPlane + RPlane0.Transform(xHat.Scale((double)verts[i].x) + yHat.Scale((double)verts[i].y));
-				contact.x[0] = x;
-				contact.x[1] = x;
-//				contact.x[0] = x0;
-//				contact.x[1] = x1;
+				contact.x[0] = manifold->points[i].x[0];
+				contact.x[1] = manifold->points[i].x[1];
+				contact.depth = manifold->points[i].depth;
+				contact.impulse = &manifold->points[i].impulse;
 
 				isl->AddContact(contact);
 			}
 		}
 	}
+
+	// Pairs that stopped touching lose their manifolds
+
+	auto it = m_manifolds.begin();
+	while (it != m_manifolds.end())
+	{
+		if (it->second.active)
+		{
+			++it;
+		}
+		else
+		{
+			it = m_manifolds.erase(it);
+		}
+	}
 //	if (m_firstIsland != nullptr)
 //	{
 //		int n0 = 0;
@@ -439,14 +620,21 @@ void PhysicsScene::ComputeContacts()
 //	}
 }
 
-void PhysicsScene::ResolveContacts() const
+void PhysicsScene::ResolveContacts(double dt) const
 {
 	if (m_firstIsland != nullptr)
 	{
 		Island* island = m_firstIsland;
 		do
 		{
-			island->ResolveContacts();
+			MathUtils::GaussSeidelStats stats;
+			const auto t0 = std::chrono::high_resolution_clock::now();
+			island->ResolveContacts(dt, m_solverConfig, m_threadPool, stats);
+			const auto t1 = std::chrono::high_resolution_clock::now();
+			if (m_instrumentation)
+			{
+				m_instrumentation->OnIslandSolved((int)island->m_contacts.size(), stats, std::chrono::duration<double>(t1 - t0).count());
+			}
 			island = island->m_next;
 
 		} while (island != m_firstIsland);
@@ -488,103 +676,41 @@ void PhysicsScene::Step(double dt)
 	{
 		RigidBody* body = ((RigidBody*)node->GetPhysicsObject());
 		body->ApplyForceAtCOM(dVec3(0.0, 0.0, -9.8).Scale(body->GetMass()));
+		body->UpdateSweep(dt);
 		node = node->GetNext();
 	}
 
 	ComputeContacts();
-	ResolveContacts();
+	ResolveContacts(dt);
 	ClearIslands();
 
 	node = m_firstNode;
-	while (node != nullptr)
+	if (m_integratorConfig.integrator == INTEGRATOR_SEMI_IMPLICIT_EULER)
 	{
-		RigidBody* body = ((RigidBody*)node->GetPhysicsObject());
-		node->GetPhysicsObject()->Step(dt);
-		node = node->GetNext();
+		// A single sweep over the bodies, without the virtual dispatch of Step
+		const bool gyroscopic = m_integratorConfig.gyroscopic;
+		while (node != nullptr)
+		{
+			((RigidBody*)node->GetPhysicsObject())->StepSemiImplicitEuler(dt, gyroscopic);
+			node = node->GetNext();
+		}
+	}
+	else
+	{
+		while (node != nullptr)
+		{
+			node->GetPhysicsObject()->Step(dt);
+			node = node->GetNext();
+		}
 	}
 }
 
 void PhysicsScene::DebugDraw(DebugRenderer* renderer) const
 {
 #if 1 
-	std::vector<BVNodePair> intersectingLeaves = m_bvTree.Root()->FindIntersectingLeaves();
-	for (BVNodePair pair : intersectingLeaves)
+	for (const auto& entry : m_manifolds)
 	{
-		RigidBody* body0 = (RigidBody*)pair.nodes[0]->GetContent();
-		RigidBody* body1 = (RigidBody*)pair.nodes[1]->GetContent();
-
-		Geometry* geom0 = body0->GetGeometry();
-		Geometry* geom1 = body1->GetGeometry();
-
-		dVec3 pos0, pos1;
-		dQuat rot0, rot1;
-
-		body0->GetGeometryGlobalTransform(pos0, rot0);
-		body1->GetGeometryGlobalTransform(pos1, rot1);
-
-		dVec3 x0, x1, n0, n1;
-
-		if (Geometry::Intersect(geom0, pos0, rot0, x0, n0, geom1, pos1, rot1, x1, n1))
-		{
-			dVec3 xHat, yHat;
-
-			CreateCoordinateSystem(xHat, yHat, n0);
-			dVec3 xPlane = (x0 + x1).Scale(0.5);
-
-			dMat33 RPlane0;
-			RPlane0.SetColumn(0, xHat);
-			RPlane0.SetColumn(1, yHat);
-			RPlane0.SetColumn(2, n0);
-
-			Polygon poly0 = geom0->IntersectPlane(pos0, rot0, xPlane, n0, xHat, yHat);
-			Polygon poly1 = geom1->IntersectPlane(pos1, rot1, xPlane, -n0, -xHat, yHat);
-			Polygon intersectionPoly;
-			int nVerts0, nVerts1;
-			const fVec2* verts0 = poly0.GetVertices(nVerts0);
-			const fVec2* verts1 = poly1.GetVertices(nVerts1);
-			if (nVerts0 == 1)
-			{
-				intersectionPoly = poly0;
-			}
-			else if (nVerts1 == 1)
-			{
-				intersectionPoly = poly1.ReflectX();
-			}
-			else
-			{
-				intersectionPoly = poly0.Intersect(poly1.ReflectX());
-			}
-			intersectionPoly = intersectionPoly.PruneColinearVertices(COLINEAR_ANGLE_THRESH);
-//			intersectionPoly = intersectionPoly.LimitVertices(3);
-
-			int nVerts;
-			const fVec2* verts = intersectionPoly.GetVertices(nVerts);
-//			assert(nVerts > 0);
-
-			const float k = 0.05f;
-//			for (Polygon poly : { intersectionPoly })
-//			{
-//				verts = poly.GetVertices(nVerts);
-//				for (int i = 0; i < nVerts; ++i)
-//				{
-//					const fVec3 x(xPlane + xHat.Scale((double)verts[i].x) + yHat.Scale((double)verts[i].y));
-//					const fVec3 y(xPlane + xHat.Scale((double)verts[(i + 1) % nVerts].x) + yHat.Scale((double)verts[(i + 1) % nVerts].y));
-//					renderer->DrawBox(k, k, k, x, dQuat::Identity(), fVec3(1.0f, 0.0f, 0.0f), false, false);
-//					renderer->DrawLine(x, y, fVec3(1.0f, 0.0f, 0.0f));
-//				}
-//			}
-			for (Polygon poly : {poly0, poly1.ReflectX()})
-			{
-				verts = poly.GetVertices(nVerts);
-				for (int i = 0; i < nVerts; ++i)
-				{
-					const fVec3 x(xPlane + xHat.Scale((double)verts[i].x) + yHat.Scale((double)verts[i].y));
-					const fVec3 y(xPlane + xHat.Scale((double)verts[(i + 1) % nVerts].x) + yHat.Scale((double)verts[(i + 1) % nVerts].y));
-					renderer->DrawLine(x, y, fVec3(0.0f, 1.0f, 0.0f));
-					renderer->DrawBox(k, k, k, x, dQuat::Identity(), fVec3(0.0f, 1.0f, 0.0f), false, false);
-				}
-			}
-		}
+		entry.second.manifold.DebugDraw(renderer);
 	}
 
 #else
@@ -594,8 +720,8 @@ void PhysicsScene::DebugDraw(DebugRenderer* renderer) const
 		RigidBody* rb0 = (RigidBody*)pair.nodes[0]->GetContent();
 		RigidBody* rb1 = (RigidBody*)pair.nodes[1]->GetContent();
 
-		Geometry* geom0 = rb0->GetGeometry();
-		Geometry* geom1 = rb1->GetGeometry();
+		const Geometry* geom0 = rb0->GetGeometry();
+		const Geometry* geom1 = rb1->GetGeometry();
 
 		dVec3 pos0, pos1;
 		dQuat rot0, rot1;
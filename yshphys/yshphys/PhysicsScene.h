@@ -6,6 +6,9 @@
 #include "DebugRenderer.h"
 #include "Ray.h"
 #include "Island.h"
+#include "ContactManifold.h"
+#include "PhysicsInstrumentation.h"
+#include "ThreadPool.h"
 
 #define MAX_PHYSICS_NODES 1024
 
@@ -30,11 +33,23 @@ public:
 
 	void Step(double dt);
 
+	void SetSolverConfig(const MathUtils::GaussSeidelConfig& config);
+	const MathUtils::GaussSeidelConfig& GetSolverConfig() const;
+
+	// RK4 by default
+	void SetIntegratorConfig(const IntegratorConfig& config);
+	const IntegratorConfig& GetIntegratorConfig() const;
+
+	// Not owned by the scene. May be null.
+	void SetInstrumentation(PhysicsInstrumentation* instrumentation);
+	// Not owned by the scene. May be null, in which case everything runs on the thread calling Step.
+	void SetThreadPool(ThreadPool* threadPool);
+
 	void DebugDraw(DebugRenderer* renderer) const;
 
 protected:
 	void ComputeContacts();
-	void ResolveContacts() const;
+	void ResolveContacts(double dt) const;
 	void ClearIslands();
 
 	std::stack<FreedPhysicsNode> m_freedNodeStack;
@@ -44,5 +59,31 @@ protected:
 	BVTree m_bvTree;
 
 	Island* m_firstIsland;
+
+	// Contact manifolds persist across steps, keyed by body pair (ordered by address) and by the pair of parts of the
+	// bodies' geometries that the manifold is between (see Geometry::ForEachPart; a convex geometry is its own part 0)
+	typedef std::pair<RigidBody*, RigidBody*> BodyPair;
+	typedef std::pair<int, int> PartPair;
+	typedef std::pair<BodyPair, PartPair> ManifoldKey;
+	struct CachedManifold
+	{
+		ContactManifold manifold;
+		bool active; // whether the pair was in contact during the current step
+	};
+	std::map<ManifoldKey, CachedManifold> m_manifolds;
+
+	// Tracks or rebuilds the manifold of two convex geometries (of the bodies of the key). Returns null if they don't touch.
+	// If the geometries are parts (of a concave geometry), they count as touching within CONTACTMANIFOLD_SEPARATION_TOL.
+	ContactManifold* UpdateManifold(const ManifoldKey& key,
+		const Geometry* geom0, const dVec3& pos0, const dQuat& rot0,
+		const Geometry* geom1, const dVec3& pos1, const dQuat& rot1,
+		bool parts);
+
+	std::vector<ContactManifold*> m_pairManifolds; // scratch space for ComputeContacts
+
+	MathUtils::GaussSeidelConfig m_solverConfig;
+	IntegratorConfig m_integratorConfig;
+	PhysicsInstrumentation* m_instrumentation;
+	ThreadPool* m_threadPool;
 };
 
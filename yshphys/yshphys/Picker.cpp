@@ -1,9 +1,7 @@
 #include "stdafx.h"
 #include "Picker.h"
-#include "Force_Spring.h"
-#include "Force_Constant.h"
 
-Picker::Picker() : m_depth(1.0f)
+Picker::Picker() : m_depth(1.0f), m_pickedObject(nullptr), m_springHandle(-1)
 {
 	m_mappedKeys[PICK] = YSH_INPUT_LMOUSEBUTTON;
 
@@ -13,6 +11,17 @@ Picker::Picker() : m_depth(1.0f)
 
 Picker::~Picker()
 {
+	Release();
+}
+
+void Picker::Release()
+{
+	if (m_springHandle >= 0)
+	{
+		m_pickedObject->RemoveForce(m_springHandle);
+		m_springHandle = -1;
+	}
+	m_pickedObject = nullptr;
 }
 
 unsigned int Picker::GetNumMappedKeys() const
@@ -39,44 +48,53 @@ dVec3 Picker::GetPosition() const
 void Picker::ProcessInput(const MouseState& mouseState, KeyState* keyStates, int dt_ms)
 {
 	const KeyState& keyState = keyStates[PICK];
+	const bool pressed = keyState.m_state == KeyState::State::PRESSED;
+	const bool justPressed = pressed && keyState.m_duration == 0;
+
+	const Viewport& viewport = m_game->m_renderScene.m_viewport;
+	const fVec3 viewDir = viewport.GetViewDir();
+	const Ray ray = viewport.UnProject(mouseState.m_x, mouseState.m_y, mouseState.m_windowSpanX, mouseState.m_windowSpanY);
 
-	if (keyState.m_state == KeyState::State::RELEASED)
+	// The viewport belongs to the render loop, and the picked object to physics (see Game::SetPipelined)
+	m_game->RunPhysicsCommand([this, pressed, justPressed, viewDir, ray]()
 	{
-		m_pickedObject = nullptr;
-	}
-	if (keyState.m_state == KeyState::State::PRESSED)
+		Pick(pressed, justPressed, viewDir, ray);
+	});
+}
+
+void Picker::Pick(bool pressed, bool justPressed, const fVec3& viewDir, const Ray& ray)
+{
+	if (!pressed)
 	{
-		const Viewport& viewport = m_game->m_renderScene.m_viewport;
-		const fVec3 viewDir = viewport.GetViewDir();
-		const Ray ray = viewport.UnProject(mouseState.m_x, mouseState.m_y, mouseState.m_windowSpanX, mouseState.m_windowSpanY);
+		Release();
+		return;
+	}
 
-		const fVec3 rayDir = ray.GetDirection();
+	const fVec3 rayDir = ray.GetDirection();
 
-		if (keyState.m_duration == 0)
-		{
-			PhysicsRayCastHit hit = m_game->m_physicsScene.RayCast(ray);
-			if (m_pickedObject = hit.body)
-			{
-				m_grabOffset = hit.offset;
-				dVec3 x = m_pickedObject->GetPosition() + m_pickedObject->GetRotation().Transform(m_grabOffset);
-				m_depth = fVec3(x - ray.GetOrigin()).Dot(viewDir);
-
-				m_pos = ray.GetOrigin() + rayDir.Scale(m_depth / rayDir.Dot(viewDir));
-			}
-		}
-		else if (m_pickedObject != nullptr)
+	if (justPressed)
+	{
+		PhysicsRayCastHit hit = m_game->m_physicsScene.RayCast(ray);
+		if (m_pickedObject = hit.body)
 		{
-			double m = m_pickedObject->GetMass();
+			m_grabOffset = hit.offset;
+			dVec3 x = m_pickedObject->GetPosition() + m_pickedObject->GetRotation().Transform(m_grabOffset);
+			m_depth = fVec3(x - ray.GetOrigin()).Dot(viewDir);
 
 			m_pos = ray.GetOrigin() + rayDir.Scale(m_depth / rayDir.Dot(viewDir));
 
-			Force_Spring* force = new Force_Spring();
-			force->length = 0.0;
-			force->offset = m_grabOffset;
-			force->anchor = m_pos;
-			force->k = m_springCoeff.k*m;
-			force->b = m_springCoeff.b*m;
-			m_pickedObject->ApplyBruteForce(force);
+			const double m = m_pickedObject->GetMass();
+			m_spring.length = 0.0;
+			m_spring.offset = m_grabOffset;
+			m_spring.anchor = m_pos;
+			m_spring.k = m_springCoeff.k*m;
+			m_spring.b = m_springCoeff.b*m;
+			m_springHandle = m_pickedObject->AddForce(&m_spring);
 		}
 	}
+	else if (m_pickedObject != nullptr)
+	{
+		m_pos = ray.GetOrigin() + rayDir.Scale(m_depth / rayDir.Dot(viewDir));
+		m_spring.anchor = m_pos;
+	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "InputHandler.h"
 #include "RigidBody.h"
+#include "Force_Spring.h"
 #include "Game.h"
 
 class Picker :
@@ -29,6 +30,10 @@ private:
 
 	virtual unsigned int GetNumMappedKeys() const;
 
+	void Release();
+	// Applies the input to the physics scene (on the physics thread, if the game is pipelined)
+	void Pick(bool pressed, bool justPressed, const fVec3& viewDir, const Ray& ray);
+
 	float m_depth;
 
 	DampedOscillatorCoefficients m_springCoeff; // assuming a unit mass
@@ -36,6 +41,10 @@ private:
 	RigidBody* m_pickedObject;
 	dVec3 m_grabOffset;
 
+	// Registered with the picked object for as long as it's held
+	Force_Spring m_spring;
+	int m_springHandle;
+
 	dVec3 m_pos;
 };
 
@@ -1,83 +1,183 @@
 #include "stdafx.h"
 #include "QuickHull.h"
 
-void QuickHull::FaceFIFO::Push(QuickHull::Face* face)
+void QuickHull::FaceHeap::HeapifyUp(int index)
 {
-	face->FIFO = this;
+	int i = index;
+	int j = (i + 1) / 2 - 1; // index of i's parent
 
-	if (m_iStart == m_iEnd)
+	while (i > 0 && m_faces[i]->dFarthestConflict > m_faces[j]->dFarthestConflict)
 	{
-		face->iFIFO = m_iEnd;
-		m_queue[m_iEnd].face = face;
-		m_queue[m_iEnd].valid = true;
-		m_iEnd = (m_iEnd + 1) % QUICKHULL_FACEFIFO_MAXSIZE;
+		Face* swp = m_faces[i];
+		m_faces[i] = m_faces[j];
+		m_faces[j] = swp;
+
+		m_faces[i]->iHeap = i;
+		m_faces[j]->iHeap = j;
+
+		i = j;
+		j = (i + 1) / 2 - 1;
 	}
-	else
+}
+void QuickHull::FaceHeap::HeapifyDown(int index)
+{
+	int i = index;
+
+	while (true)
 	{
-		while (m_iStart != m_iEnd)
+		const int nFaces = (int)m_faces.size();
+		int iLeft = 2 * (i + 1) - 1;
+		int iRight = iLeft + 1;
+		if (iRight > nFaces)
+		{
+			break;
+		}
+		else
 		{
-			int iLast = (m_iEnd - 1 + QUICKHULL_FACEFIFO_MAXSIZE) % QUICKHULL_FACEFIFO_MAXSIZE;
-			if (m_queue[iLast].valid)
+			int j;
+			if (iRight == nFaces)
 			{
-				face->iFIFO = m_iEnd;
-				m_queue[m_iEnd].face = face;
-				m_queue[m_iEnd].valid = true;
-				m_iEnd = (m_iEnd + 1) % QUICKHULL_FACEFIFO_MAXSIZE;
-				break;
+				j = iLeft;
 			}
 			else
 			{
-				m_queue[iLast].face = nullptr;
-				m_iEnd = iLast;
+				j = (m_faces[iLeft]->dFarthestConflict >= m_faces[iRight]->dFarthestConflict) ? iLeft : iRight;
+			}
+
+			if (m_faces[j]->dFarthestConflict > m_faces[i]->dFarthestConflict)
+			{
+				Face* swp = m_faces[i];
+				m_faces[i] = m_faces[j];
+				m_faces[j] = swp;
+
+				m_faces[i]->iHeap = i;
+				m_faces[j]->iHeap = j;
+
+				i = j;
+			}
+			else
+			{
+				break;
 			}
 		}
 	}
 }
-QuickHull::Face* QuickHull::FaceFIFO::Pop()
+void QuickHull::FaceHeap::RemoveFaceFromHeap(Face* face)
 {
-	while (m_iStart != m_iEnd)
+	RemoveFaceFromHeap(face->iHeap);
+}
+void QuickHull::FaceHeap::RemoveFaceFromHeap(int i)
+{
+	m_faces[i]->iHeap = -1;
+	m_faces[i] = m_faces.back();
+	m_faces.pop_back();
+	if (i < (int)m_faces.size())
 	{
-		if (m_queue[m_iStart].valid)
-		{
-			m_queue[m_iStart].valid = false;
-			const int i = m_iStart;
-			m_iStart = (m_iStart + 1) % QUICKHULL_FACEFIFO_MAXSIZE;
-			m_queue[i].face->FIFO = nullptr;
-			m_queue[i].face->iFIFO = -1;
-			return m_queue[i].face;
-		}
-		else
-		{
-			m_queue[m_iStart].face = nullptr;
-			m_iStart = (m_iStart + 1) % QUICKHULL_FACEFIFO_MAXSIZE;
-		}
+		m_faces[i]->iHeap = i;
+		HeapifyUp(i);
+		HeapifyDown(m_faces[i]->iHeap);
 	}
-	return nullptr;
 }
-int QuickHull::FaceFIFO::Size()
+void QuickHull::FaceHeap::Push(Face* face)
+{
+	face->iHeap = (int)m_faces.size();
+	m_faces.push_back(face);
+	HeapifyUp(face->iHeap);
+}
+void QuickHull::FaceHeap::Pop()
+{
+	RemoveFaceFromHeap((int)0);
+}
+QuickHull::Face* QuickHull::FaceHeap::Top() const
 {
-	return (m_iStart - m_iEnd + QUICKHULL_FACEFIFO_MAXSIZE) % QUICKHULL_FACEFIFO_MAXSIZE;
+	return m_faces[0];
 }
 
 QuickHull::QuickHull(const fVec3* verts, int nVerts, double dSlack) :
 	m_verts(verts),
 	m_nVerts(nVerts),
-	m_nHorizonEdges(0),
 	m_entryEdge(nullptr),
-	m_dSlack(dSlack)
+	m_nextConflict(nVerts, -1),
+	m_dPrecision(0.0),
+	m_dTolerance(dSlack)
 {
+	m_stats.iterations = 0;
+	m_stats.droppedPoints = 0;
+	m_stats.initMilliseconds = 0.0;
+	m_stats.carveMilliseconds = 0.0;
+	m_stats.patchMilliseconds = 0.0;
+
+	const std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
 	InitTetrahedron();
+	const std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	m_stats.initMilliseconds = std::chrono::duration<double, std::milli>(t1 - t0).count();
 }
 
 QuickHull::~QuickHull()
 {
-	for (HalfEdge* e : m_allocatedEdges)
+}
+
+const QuickHull::Stats& QuickHull::GetStats() const
+{
+	return m_stats;
+}
+
+QuickHull::HalfEdge* QuickHull::NewEdge()
+{
+	HalfEdge* e = m_edges.Allocate();
+	*e = HalfEdge();
+	e->id = m_edges.Size() - 1;
+	return e;
+}
+
+QuickHull::Face* QuickHull::NewFace()
+{
+	Face* f = m_faces.Allocate();
+	*f = Face();
+	f->id = m_faces.Size() - 1;
+	return f;
+}
+
+void QuickHull::AssignConflict(int iVert, Face* const* faces, int nFaces)
+{
+	const dVec3 v(m_verts[iVert]);
+
+	Face* face = nullptr;
+	double d = 0.0;
+
+	for (int i = 0; i < nFaces; ++i)
+	{
+		const double di = faces[i]->normal.Dot(v - dVec3(*faces[i]->edge->vert));
+		if (di > m_dTolerance)
+		{
+			face = faces[i];
+			d = di;
+			break;
+		}
+		if (di > m_dPrecision && face == nullptr)
+		{
+			face = faces[i];
+			d = di;
+		}
+	}
+
+	if (face != nullptr)
 	{
-		delete e;
+		m_nextConflict[iVert] = face->iFirstConflict;
+		face->iFirstConflict = iVert;
+		if (face->iFarthestConflict < 0 || d > face->dFarthestConflict)
+		{
+			face->iFarthestConflict = iVert;
+			face->dFarthestConflict = d;
+		}
 	}
-	for (Face* f : m_allocatedFaces)
+}
+
+void QuickHull::PushIfExpandable(Face* face)
+{
+	if (face->iFirstConflict >= 0 && face->dFarthestConflict > m_dTolerance)
 	{
-		delete f;
+		m_faceHeap.Push(face);
 	}
 }
 
@@ -107,35 +207,82 @@ void QuickHull::InitTetrahedron()
 		}
 	}
 
-	float maxVolume = 0.0f;
+	// The initial tetrahedron is spanned by the pair of extreme points farthest apart, the point farthest from the line
+	// through them, and the point farthest from the plane through those three. If there is no such tetrahedron
+	// (fewer than four points, or they're all coplanar), there is no hull.
+
+	if (m_nVerts < 4)
+	{
+		return;
+	}
+
+	// Rounding errors grow with the extent of the points, and a point as close to a face as the precision of its coordinates
+	// might as well be in it
+
+	for (int dim = 0; dim < 3; ++dim)
+	{
+		m_dPrecision = std::max(m_dPrecision, (double)FLT_EPSILON*((double)max[dim] - (double)min[dim]));
+	}
+	m_dTolerance = std::max(m_dTolerance, m_dPrecision);
+
 	const fVec3* vOptimal[4] = { nullptr, nullptr, nullptr, nullptr };
 
+	double dMax = 0.0;
 	for (int iA = 0; iA < 6; ++iA)
 	{
 		for (int iB = iA + 1; iB < 6; ++iB)
 		{
-			for (int iC = iB + 1; iC < 6; ++iC)
+			const dVec3 AB = dVec3(*v[iB]) - dVec3(*v[iA]);
+			const double d = AB.Dot(AB);
+			if (d > dMax)
 			{
-				for (int iD = iC + 1; iD < 6; ++iD)
-				{
-					const fVec3* A = v[iA];
-					const fVec3* B = v[iB];
-					const fVec3* C = v[iC];
-					const fVec3* D = v[iD];
-
-					float volume = fabs((*B - *A).Cross(*C - *A).Dot(*D - *A));
-					if (volume > maxVolume)
-					{
-						maxVolume = volume;
-						vOptimal[0] = A;
-						vOptimal[1] = B;
-						vOptimal[2] = C;
-						vOptimal[3] = D;
-					}
-				}
+				dMax = d;
+				vOptimal[0] = v[iA];
+				vOptimal[1] = v[iB];
 			}
 		}
 	}
+	if (vOptimal[0] == nullptr)
+	{
+		return;
+	}
+
+	const dVec3 O(*vOptimal[0]);
+	const dVec3 axis = dVec3(*vOptimal[1]) - O;
+
+	dMax = 0.0;
+	for (int i = 0; i < m_nVerts; ++i)
+	{
+		const dVec3 cross = axis.Cross(dVec3(m_verts[i]) - O);
+		const double d = cross.Dot(cross);
+		if (d > dMax)
+		{
+			dMax = d;
+			vOptimal[2] = &m_verts[i];
+		}
+	}
+	if (vOptimal[2] == nullptr)
+	{
+		return;
+	}
+
+	dVec3 normal = axis.Cross(dVec3(*vOptimal[2]) - O);
+	normal = normal.Scale(1.0 / sqrt(normal.Dot(normal)));
+
+	dMax = m_dTolerance;
+	for (int i = 0; i < m_nVerts; ++i)
+	{
+		const double d = abs(normal.Dot(dVec3(m_verts[i]) - O));
+		if (d > dMax)
+		{
+			dMax = d;
+			vOptimal[3] = &m_verts[i];
+		}
+	}
+	if (vOptimal[3] == nullptr)
+	{
+		return;
+	}
 
 	HalfEdge* edges[4][4];
 
@@ -143,17 +290,14 @@ void QuickHull::InitTetrahedron()
 	{
 		for (int j = 0; j < i; ++j)
 		{
-			edges[i][j] = new HalfEdge;
+			edges[i][j] = NewEdge();
 			edges[i][j]->vert = vOptimal[j];
 
-			edges[j][i] = new HalfEdge;
+			edges[j][i] = NewEdge();
 			edges[j][i]->vert = vOptimal[i];
 
 			edges[i][j]->twin = edges[j][i];
 			edges[j][i]->twin = edges[i][j];
-
-			m_allocatedEdges.push_back(edges[i][j]);
-			m_allocatedEdges.push_back(edges[j][i]);
 		}
 	}
 
@@ -176,9 +320,8 @@ void QuickHull::InitTetrahedron()
 		assert(n.Dot(n) > FLT_MIN);
 		n = n.Scale(1.0 / sqrt(n.Dot(n)));
 
-		Face* face = new Face;
+		Face* face = NewFace();
 		tetraFaces[f] = face;
-		m_faceFIFO.Push(face);
 
 		HalfEdge* e[3];
 
@@ -207,97 +350,50 @@ void QuickHull::InitTetrahedron()
 		face->normal = n;
 	}
 
-	int iOptimal[4] =
-	{
-		(int)(vOptimal[0] - m_verts) / (int)sizeof(fVec3*),
-		(int)(vOptimal[1] - m_verts) / (int)sizeof(fVec3*),
-		(int)(vOptimal[2] - m_verts) / (int)sizeof(fVec3*),
-		(int)(vOptimal[3] - m_verts) / (int)sizeof(fVec3*)
-	};
-	std::sort(iOptimal, iOptimal + 4);
-
-	auto AssignVertToFace = [&](const fVec3* v)
-	{
-		for (Face* face : tetraFaces)
-		{
-			const double d = (*v - *face->edge->vert).Dot(face->normal);
-			if (d > m_dSlack)
-			{
-				face->vertSet.push_back(v);
-				break;
-			}
-		}
-	};
-
-	for (int i = 0; i < iOptimal[0]; ++i)
-	{
-		AssignVertToFace(&m_verts[i]);
-	}
-	for (int i = iOptimal[0]; i < iOptimal[1]; ++i)
-	{
-		AssignVertToFace(&m_verts[i]);
-	}
-	for (int i = iOptimal[1]; i < iOptimal[2]; ++i)
-	{
-		AssignVertToFace(&m_verts[i]);
-	}
-	for (int i = iOptimal[2]; i < iOptimal[3]; ++i)
+	for (int i = 0; i < m_nVerts; ++i)
 	{
-		AssignVertToFace(&m_verts[i]);
+		AssignConflict(i, tetraFaces, 4);
 	}
-	for (int i = iOptimal[3]; i < m_nVerts; ++i)
+	for (Face* face : tetraFaces)
 	{
-		AssignVertToFace(&m_verts[i]);
+		PushIfExpandable(face);
 	}
 }
 
-void QuickHull::CarveHorizon(const fVec3& fEye, Face* visibleFace)
+bool QuickHull::CarveHorizon(const fVec3& fEye, Face* visibleFace)
 {
 	const dVec3 dEye(fEye);
 
-	for (int i = 0; i < m_nHorizonEdges; ++i)
+	for (HalfEdge* edge : m_horizonEdges)
 	{
-		m_horizonEdges[i]->isHorizon = false;
+		edge->isHorizon = false;
 	}
-	m_nHorizonEdges = 0;
+	m_horizonEdges.clear();
 
 	m_orphanedVerts.clear();
+	m_edgeStack.clear();
+	m_visitedFaces.clear();
 
-	struct EdgeStack
-	{
-	public:
-		void Push(HalfEdge* edge) { e[n++] = edge; }
-		HalfEdge* Pop() { return e[--n]; }
-		bool Empty() const { return n == 0; }
-	private:
-		HalfEdge* e[1024];
-		int n = 0;
-	}
-	edgeStack;
-
-	std::vector<Face*> visitedFaces;
 	auto MarkFaceAsVisited = [&](Face* face)
 	{
-		visitedFaces.push_back(face);
+		m_visitedFaces.push_back(face);
 		face->visited = true;
 	};
 
 	for (HalfEdge* e : { visibleFace->edge, visibleFace->edge->prev, visibleFace->edge->next })
 	{
-		edgeStack.Push(e);
+		m_edgeStack.push_back(e);
 		MarkFaceAsVisited(e->twin->face);
 	}
 	MarkFaceAsVisited(visibleFace);
 	visibleFace->visible = true;
 
-	int nFreedEdges = 0;
-	std::vector<HalfEdge*> internalEdges;
-
 	HalfEdge* horizonStart = nullptr;
 
-	while (!edgeStack.Empty())
+	while (!m_edgeStack.empty())
 	{
-		HalfEdge* edge = edgeStack.Pop();
+		HalfEdge* edge = m_edgeStack.back();
+		m_edgeStack.pop_back();
 		HalfEdge* twin = edge->twin;
 
 		Face* opposingFace = twin->face;
@@ -306,22 +402,18 @@ void QuickHull::CarveHorizon(const fVec3& fEye, Face* visibleFace)
 		const dVec3 x(*edge->vert);
 		const double dot = (dEye - x).Dot(n);
 
-		//		assert(abs(dot) > 8.0*FLT_MIN);
-
-		if ((float)dot > 0.0f)
+		if (dot > m_dPrecision)
 		{
 			if (!twin->prev->twin->face->visited)
 			{
-				edgeStack.Push(twin->prev);
+				m_edgeStack.push_back(twin->prev);
 				MarkFaceAsVisited(twin->prev->twin->face);
 			}
 			if (!twin->next->twin->face->visited)
 			{
-				edgeStack.Push(twin->next);
+				m_edgeStack.push_back(twin->next);
 				MarkFaceAsVisited(twin->next->twin->face);
 			}
-			internalEdges.push_back(edge);
-			internalEdges.push_back(twin);
 
 			opposingFace->visible = true;
 		}
@@ -331,11 +423,15 @@ void QuickHull::CarveHorizon(const fVec3& fEye, Face* visibleFace)
 		}
 	}
 
+	if (horizonStart == nullptr)
+	{
+		return false;
+	}
+
 	HalfEdge* edge = horizonStart;
 	do
 	{
-		assert(m_nHorizonEdges < QUICKHULL_MAXHORIZONEDGES);
-		m_horizonEdges[m_nHorizonEdges++] = edge;
+		m_horizonEdges.push_back(edge);
 		edge->isHorizon = true;
 
 		HalfEdge* e0 = edge;
@@ -346,83 +442,156 @@ void QuickHull::CarveHorizon(const fVec3& fEye, Face* visibleFace)
 
 		} while (edge->face->visible);
 
-		/////////////////////////////////////////
-		// Make sure the horizon is not "pinched"
+		// The horizon is "pinched" if the visible faces around its vertex aren't contiguous
 		HalfEdge* e = edge;
 		while (e != e0)
 		{
-			assert(!e->face->visible);
+			if (e->face->visible)
+			{
+				return false;
+			}
 			e = e->next->twin;
 		}
-		/////////////////////////////////////////
 
 		edge = edge->twin;
 
 	} while (edge != horizonStart);
 
-	std::vector<Face*> visibleFaces;
-	for (Face* face : visitedFaces)
+	// The loop has to take in every edge between a visible and a hidden face. It doesn't if the visible faces surround
+	// hidden ones.
+
+	int nHorizonEdges = 0;
+	for (const Face* face : m_visitedFaces)
 	{
 		if (face->visible)
 		{
-			visibleFaces.push_back(face);
+			const HalfEdge* e = face->edge;
+			do
+			{
+				nHorizonEdges += e->twin->face->visible ? 0 : 1;
+				e = e->next;
+			} while (e != face->edge);
+		}
+	}
+	return nHorizonEdges == (int)m_horizonEdges.size();
+}
 
-			m_orphanedVerts.insert(m_orphanedVerts.end(), face->vertSet.begin(), face->vertSet.end());
+bool QuickHull::CanPatchHorizon(const fVec3* eye) const
+{
+	// The face connecting the eye to a horizon edge is degenerate if the eye is (nearly) on the line through the edge.
+	// Its normal would be noise, and the faces around it could fold over.
 
-			m_faceFIFO.InvalidateElement(face->iFIFO);
+	const double eps2 = (double)FLT_EPSILON*(double)FLT_EPSILON;
+	const dVec3 D(*eye);
+	for (const HalfEdge* edge : m_horizonEdges)
+	{
+		const dVec3 DA = dVec3(*edge->twin->vert) - D;
+		const dVec3 DB = dVec3(*edge->vert) - D;
+		const dVec3 n = DA.Cross(DB);
+		if (n.Dot(n) <= eps2*DA.Dot(DA)*DB.Dot(DB))
+		{
+			return false;
 		}
+	}
+	return true;
+}
 
+void QuickHull::ClearVisitedFaces()
+{
+	for (Face* face : m_visitedFaces)
+	{
 		face->visible = false;
 		face->visited = false;
 	}
+	m_visitedFaces.clear();
+}
 
-	for (HalfEdge* edge : internalEdges)
-	{
-//		delete edge;
-	}
-	for (Face* face : visibleFaces)
+void QuickHull::DropConflict(Face* face, int iVert)
+{
+	// The conflict list is singly linked, so it's rebuilt without the point, and its farthest point is found again
+
+	const int iFirst = face->iFirstConflict;
+	face->iFirstConflict = -1;
+	face->iFarthestConflict = -1;
+	face->dFarthestConflict = 0.0;
+
+	int iLast = -1;
+	for (int i = iFirst; i >= 0; )
 	{
-//		delete face;
+		const int iNext = m_nextConflict[i];
+		if (i != iVert)
+		{
+			m_nextConflict[i] = -1;
+			if (iLast < 0)
+			{
+				face->iFirstConflict = i;
+			}
+			else
+			{
+				m_nextConflict[iLast] = i;
+			}
+			iLast = i;
+
+			const double d = face->normal.Dot(dVec3(m_verts[i]) - dVec3(*face->edge->vert));
+			if (face->iFarthestConflict < 0 || d > face->dFarthestConflict)
+			{
+				face->iFarthestConflict = i;
+				face->dFarthestConflict = d;
+			}
+		}
+		i = iNext;
 	}
+	m_nextConflict[iVert] = -1;
 }
 
 
-bool QuickHull::PatchHorizon(const fVec3* eye)
+void QuickHull::PatchHorizon(const fVec3* eye)
 {
-	if (m_nHorizonEdges > 0)
+	// The visible faces are carved off (but not freed), and their conflict points are orphaned
+
+	for (Face* face : m_visitedFaces)
+	{
+		if (face->visible)
+		{
+			for (int i = face->iFirstConflict; i >= 0; i = m_nextConflict[i])
+			{
+				m_orphanedVerts.push_back(i);
+			}
+			face->iFirstConflict = -1;
+
+			if (face->iHeap >= 0)
+			{
+				m_faceHeap.RemoveFaceFromHeap(face);
+			}
+		}
+	}
+	ClearVisitedFaces();
+
+	const int nHorizonEdges = (int)m_horizonEdges.size();
+
+	if (nHorizonEdges > 0)
 	{
 		m_entryEdge = m_horizonEdges[0];
 	}
 
-	for (int i = 0; i < m_nHorizonEdges; ++i)
+	for (int i = 0; i < nHorizonEdges; ++i)
 	{
 		HalfEdge* curr = m_horizonEdges[i];
 
-		HalfEdge* prev = new HalfEdge;
-		HalfEdge* next = new HalfEdge;
-		m_allocatedEdges.push_back(prev);
-		m_allocatedEdges.push_back(next);
+		HalfEdge* prev = NewEdge();
+		HalfEdge* next = NewEdge();
 
-		Face* face = new Face();
-		m_allocatedFaces.push_back(face);
-		m_faceFIFO.Push(face);
+		Face* face = NewFace();
 
 		face->edge = curr;
 		const dVec3 B(*(curr->vert));
 		const dVec3 A(*(curr->twin->vert));
 		const dVec3 D(*eye);
 		dVec3 n = (A - D).Cross(B - D);
-//		assert(n.Dot(n) > FLT_MIN);
-		if (n.Dot(n) < FLT_MIN)
-		{
-			return false;
-		}
+		assert(n.Dot(n) > 0.0);
 		n = n.Scale(1.0 / sqrt(n.Dot(n)));
-		const double d = D.Dot(n);
 		face->normal = n;
 
-//		assert(d >= 0.0);
-
 		prev->face = face;
 		curr->face = face;
 		next->face = face;
@@ -439,134 +608,62 @@ bool QuickHull::PatchHorizon(const fVec3* eye)
 		next->prev = curr;
 	}
 
-	for (int i = 0; i < m_nHorizonEdges; ++i)
+	for (int i = 0; i < nHorizonEdges; ++i)
 	{
-		m_horizonEdges[i]->next->twin = m_horizonEdges[(i + 1) % m_nHorizonEdges]->prev;
-		m_horizonEdges[i]->prev->twin = m_horizonEdges[(i - 1 + m_nHorizonEdges) % m_nHorizonEdges]->next;
+		m_horizonEdges[i]->next->twin = m_horizonEdges[(i + 1) % nHorizonEdges]->prev;
+		m_horizonEdges[i]->prev->twin = m_horizonEdges[(i - 1 + nHorizonEdges) % nHorizonEdges]->next;
 	}
 
-	for (int i = 0; i < m_nHorizonEdges; ++i)
+	// The new faces are gathered in m_visitedFaces, which is free until the next carve
+	for (HalfEdge* edge : m_horizonEdges)
 	{
-		Face* f = m_horizonEdges[i]->face;
-		assert(f->vertSet.empty());
+		m_visitedFaces.push_back(edge->face);
 	}
-	for (const fVec3* vert : m_orphanedVerts)
+	for (int iVert : m_orphanedVerts)
 	{
-		for (int i = 0; i < m_nHorizonEdges; ++i)
-		{
-			Face* f = m_horizonEdges[i]->face;
-			dVec3 n = f->normal;
-
-			if (n.Dot(dVec3(*vert) - dVec3(*eye)) > m_dSlack)
-			{
-				f->vertSet.push_back(vert);
-				break;
-			}
-		}
+		AssignConflict(iVert, m_visitedFaces.data(), nHorizonEdges);
 	}
-	return true;
+	for (Face* face : m_visitedFaces)
+	{
+		PushIfExpandable(face);
+	}
+	m_visitedFaces.clear();
 }
 
 bool QuickHull::Expand()
 {
-	while (m_faceFIFO.Size() > 0)
+	if (m_faceHeap.Empty())
 	{
-		Face* f = m_faceFIFO.Pop();
-
-		/////////////////////////////////////////////////
-
-		if (m_entryEdge != nullptr)
-		{
-			Face* entryFace = m_entryEdge->face;
-
-			std::stack<Face*> faceStack;
-			std::vector<Face*> visitedFaces;
-			auto MarkFaceAsVisited = [&](Face* face)
-			{
-				visitedFaces.push_back(face);
-				face->visited = true;
-			};
-
-			faceStack.push(entryFace);
-			MarkFaceAsVisited(entryFace);
-
-			bool foundFace = false;
-
-			while (!faceStack.empty())
-			{
-				Face* face = faceStack.top();
-				faceStack.pop();
-				
-				if (face == f)
-				{
-					foundFace = true;
-					break;
-				}
-
-				HalfEdge* es[3];
-
-				es[0] = face->edge;
-				es[1] = face->edge->next;
-				es[2] = face->edge->prev;
-
-				for (HalfEdge* edge : es)
-				{
-					if (!edge->twin->face->visited)
-					{
-						faceStack.push(edge->twin->face);
-						MarkFaceAsVisited(edge->twin->face);
-					}
-				}
-			}
-			for (Face* face : visitedFaces)
-			{
-				face->visited = false;
-			}
-			assert(foundFace);
-		}
+		return false;
+	}
 
-		/////////////////////////////////////////////////
+	Face* f = m_faceHeap.Top();
+	m_faceHeap.Pop();
 
-		const dVec3 n(f->normal);
-		std::vector<const fVec3*>& vSet = f->vertSet;
-		if (!vSet.empty())
-		{
-			const fVec3* vFarthest = nullptr;
-			double dFarthest = 0.0;
+	const fVec3* eye = &m_verts[f->iFarthestConflict];
 
-			for (const fVec3* v : vSet)
-			{
-				const double d = n.Dot(dVec3(*v) - dVec3(*(f->edge->vert)));
-				if (d > dFarthest)
-				{
-					vFarthest = v;
-					dFarthest = d;
-				}
-			}
-			assert(vFarthest != nullptr);
+	const std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+	const bool patchable = CarveHorizon(*eye, f) && CanPatchHorizon(eye);
+	const std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	m_stats.carveMilliseconds += std::chrono::duration<double, std::milli>(t1 - t0).count();
 
-			if (vFarthest != nullptr)
-			{
-				CarveHorizon(*vFarthest, f);
-
-				if (!PatchHorizon(vFarthest))
-				{
-					assert(false);
-					return false;
-				}
+	if (!patchable)
+	{
+		// The hull is left as it is, and the eye is given up on. It's within the precision of an edge of the hull, or of faces
+		// it doesn't see, so the hull misses it by about as much.
+		ClearVisitedFaces();
+		DropConflict(f, f->iFarthestConflict);
+		PushIfExpandable(f);
+		m_stats.droppedPoints++;
+		return true;
+	}
 
-				//			SanityCheck();
+	PatchHorizon(eye);
+	const std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+	m_stats.patchMilliseconds += std::chrono::duration<double, std::milli>(t2 - t1).count();
 
-				return true;
-			}
-			else
-			{
-				assert(false);
-				return false;
-			}
-		}
-	}
-	return false;
+	m_stats.iterations++;
+	return true;
 }
 
 void QuickHull::BuildHull()
@@ -581,70 +678,57 @@ void QuickHull::ExportConvexMesh(Mesh& mesh) const
 	if (m_entryEdge == nullptr)
 	{
 		mesh.AllocateMesh(0, 0, 0);
+		mesh.InitSupport();
+		mesh.InitMassProperties();
+		return;
 	}
 
-	std::stack<Face*> faceStack;
-	std::vector<Face*> visitedFaces;
-
-	auto MarkFaceAsVisited = [&](Face* face)
-	{
-		visitedFaces.push_back(face);
-		face->visited = true;
-	};
+	// The faces and edges that were carved off are still allocated, so the hull is found by walking it from the entry edge.
+	// The ids of its faces and edges (and the offsets of its vertices into m_verts) index flat tables of their Mesh indices.
+	// The face list doubles as the queue of the walk.
 
-	Face* entryFace = m_entryEdge->face;
-	faceStack.push(entryFace);
-	MarkFaceAsVisited(entryFace);
+	std::vector<int> iFaces(m_faces.Size(), -1);
+	std::vector<int> iEdges(m_edges.Size(), -1);
+	std::vector<int> iVerts(m_nVerts, -1);
 
-	std::map<const Face*, int> f_i;
-	std::map<int, const Face*> i_f;
+	std::vector<const Face*> faces;
+	std::vector<const HalfEdge*> edges;
+	std::vector<const fVec3*> verts;
 
-	std::map<const HalfEdge*, int> e_i;
-	std::map<int, const HalfEdge*> i_e;
+	const Face* entryFace = m_entryEdge->face;
+	iFaces[entryFace->id] = 0;
+	faces.push_back(entryFace);
 
-	std::map<const fVec3*, int> v_i;
-	std::map<int, const fVec3*> i_v;
-
-	int nFaces = 0;
-	int nEdges = 0;
-	int nVerts = 0;
-
-	while (!faceStack.empty())
+	for (int i = 0; i < (int)faces.size(); ++i)
 	{
-		Face* face = faceStack.top();
-		faceStack.pop();
-
-		f_i[face] = nFaces;
-		i_f[nFaces] = face;
-		nFaces++;
-
-		HalfEdge* e = face->edge;
-		HalfEdge* e0 = e;
+		const HalfEdge* e = faces[i]->edge;
+		const HalfEdge* e0 = e;
 		do
 		{
-			e_i[e] = nEdges;
-			i_e[nEdges] = e;
-			nEdges++;
-			std::map<const fVec3*, int>::const_iterator it = v_i.find(e->vert);
-			if (it == v_i.end())
+			iEdges[e->id] = (int)edges.size();
+			edges.push_back(e);
+
+			const int iVert = (int)(e->vert - m_verts);
+			if (iVerts[iVert] < 0)
 			{
-				v_i[e->vert] = nVerts;
-				i_v[nVerts] = e->vert;
-				nVerts++;
+				iVerts[iVert] = (int)verts.size();
+				verts.push_back(e->vert);
 			}
-			if (!e->twin->face->visited)
+
+			const Face* neighbour = e->twin->face;
+			if (iFaces[neighbour->id] < 0)
 			{
-				faceStack.push(e->twin->face);
-				MarkFaceAsVisited(e->twin->face);
+				iFaces[neighbour->id] = (int)faces.size();
+				faces.push_back(neighbour);
 			}
 			e = e->next;
 
 		} while (e != e0);
 	}
-	for (Face* face : visitedFaces)
-	{
-		face->visited = false;
-	}
+
+	const int nFaces = (int)faces.size();
+	const int nEdges = (int)edges.size();
+	const int nVerts = (int)verts.size();
 
 	assert(nEdges % 2 == 0);
 
@@ -653,26 +737,27 @@ void QuickHull::ExportConvexMesh(Mesh& mesh) const
 	for (int i = 0; i < nEdges; ++i)
 	{
 		Mesh::HalfEdge& e_out = mesh.m_halfEdges[i];
-		const HalfEdge* e = i_e[i];
-		e_out.iFace = f_i[e->face];
-		e_out.iNext = e_i[e->next];
-		e_out.iPrev = e_i[e->prev];
-		e_out.iTwin = e_i[e->twin];
-		e_out.iVert = v_i[e->vert];
+		const HalfEdge* e = edges[i];
+		e_out.iFace = iFaces[e->face->id];
+		e_out.iNext = iEdges[e->next->id];
+		e_out.iPrev = iEdges[e->prev->id];
+		e_out.iTwin = iEdges[e->twin->id];
+		e_out.iVert = iVerts[e->vert - m_verts];
 	}
 	for (int i = 0; i < nFaces; ++i)
 	{
 		Mesh::Face& f_out = mesh.m_faces[i];
-		const Face* f = i_f[i];
-		f_out.iEdge = e_i[f->edge];
+		const Face* f = faces[i];
+		f_out.iEdge = iEdges[f->edge->id];
 		f_out.normal = f->normal;
 	}
 	for (int i = 0; i < nVerts; ++i)
 	{
-		mesh.m_verts[i] = *i_v[i];
+		mesh.m_verts[i] = *verts[i];
 	}
 
-	mesh.InitCardinalEdges();
+	mesh.InitSupport();
+	mesh.InitMassProperties();
 }
 
 void QuickHull::DebugDraw(DebugRenderer* renderer) const
@@ -736,8 +821,9 @@ void QuickHull::DebugDraw(DebugRenderer* renderer) const
 			const fVec3 faceCenter = (ABC[0] + ABC[1] + ABC[2]).Scale(1.0f / 3.0f);
 			renderer->DrawBox(edgeWidth, edgeWidth, len, faceCenter + n.Scale(len), rot, fVec3(1.0f, 1.0f, 1.0f), false, true);
 
-			for (const fVec3* vert : face->vertSet)
+			for (int i = face->iFirstConflict; i >= 0; i = m_nextConflict[i])
 			{
+				const fVec3* vert = &m_verts[i];
 //				renderer->DrawLine(*vert, faceCenter, fVec3(1.0f, 0.0f, 0.0f));
 				renderer->DrawBox(k, k, k, *vert, fQuat::Identity(), fVec3(1.0f, 0.0f, 0.0f), false, false);
 			}
@@ -756,9 +842,8 @@ void QuickHull::DebugDraw(DebugRenderer* renderer) const
 			face->visited = false;
 		}
 	}
-	for (int i = 0; i < m_nHorizonEdges; ++i)
+	for (const HalfEdge* edge : m_horizonEdges)
 	{
-		const HalfEdge* edge = m_horizonEdges[i];
 		fVec3 color(0.0f, 0.0f, 0.0f);
 		float kWidth = 0.01f;
 
@@ -2,24 +2,30 @@
 #include "YshMath.h"
 #include "DebugRenderer.h"
 #include "Mesh.h"
+#include "ChunkedPool.h"
 
-#define QUICKHULL_MAXHORIZONEDGES 16
-#define QUICKHULL_MAXINTERNALEDGES 64
-#define QUICKHULL_MAXINTERNALFACES 32
-
-#define QUICKHULL_MAXFACES 1024
-#define QUICKHULL_MAXEDGES 1024
-
-#define QUICKHULL_FACEFIFO_MAXSIZE (2 * QUICKHULL_MAXFACES)
+#define QUICKHULL_CHUNKSIZE 256
 
 // Contrast with EPAHull:
-//   For EPAHull, we try to do everything with stack memory, since we construct EPAHulls every frame (which complicates the code with all this freelist mumbo jumbo)
-//   QuickHull is for constructing the convex hull of a point cloud, which is a one-time ordeal, so we just use heap memory and keep it simple.
-//   QuickHull is further simplified by the fact that we don't have to maintain a face heap.
+//   For EPAHull, we reuse a per-thread workspace with pooled memory, since we run EPA every frame (which complicates the code with all this freelist mumbo jumbo)
+//   QuickHull is for constructing the convex hull of a point cloud, which is a one-time ordeal, so nothing is ever freed until the QuickHull is destroyed.
+//   Still, it has to scale to the 100k+ point clouds of collision cooking, so nothing has a fixed capacity, halfedges and faces come from chunked pools,
+//   and the conflict lists (the points outside each face) are linked lists threaded through a single array with one entry per input point.
+//   Each step expands the hull to the farthest conflict point of the face whose farthest point is the farthest of all (a max heap of faces).
 
 class QuickHull
 {
 public:
+	// Accumulated over the build
+	struct Stats
+	{
+		int iterations; // the number of points added to the hull
+		int droppedPoints; // the points left out, because they'd only have added degenerate faces (see Expand)
+		double initMilliseconds; // the initial tetrahedron, and sorting the points into its conflict lists
+		double carveMilliseconds; // finding the faces visible to the new point, and their horizon
+		double patchMilliseconds; // connecting the new point to the horizon, and redistributing the orphaned conflict points
+	};
+
 	QuickHull(const fVec3* verts, int nVerts, double dSlack);
 	virtual ~QuickHull();
 
@@ -28,12 +34,13 @@ public:
 
 	void ExportConvexMesh(Mesh& mesh) const;
 
+	const Stats& GetStats() const;
+
 	void DebugDraw(DebugRenderer* renderer) const;
 
 private:
 	struct HalfEdge;
 	struct Face;
-	struct FaceFIFO;
 
 	struct HalfEdge
 	{
@@ -43,73 +50,99 @@ private:
 		HalfEdge*		twin;
 		Face*			face;
 
+		int				id; // the index in m_edges
+
 		mutable bool			isHorizon;
 
-		HalfEdge() : vert(nullptr), next(nullptr), prev(nullptr), twin(nullptr), face(nullptr), isHorizon(false) {}
+		HalfEdge() : vert(nullptr), next(nullptr), prev(nullptr), twin(nullptr), face(nullptr), id(-1), isHorizon(false) {}
 	};
 	struct Face
 	{
 		dVec3						normal;
 		HalfEdge*					edge;
 
-		std::vector<const fVec3*>	vertSet;
+		// The conflict list: the first point (an index into m_verts, or -1 if the list is empty), and the farthest one
+		int							iFirstConflict;
+		int							iFarthestConflict;
+		double						dFarthestConflict;
 
-		FaceFIFO*					FIFO;
-		int							iFIFO;
+		int							iHeap;
+		int							id; // the index in m_faces
 
 		mutable bool	visited;
 		mutable bool	visible;
 
-		Face() : normal(0.0, 0.0, 0.0), vertSet(), edge(nullptr), visited(false), visible(false), iFIFO(-1) {}
-		~Face() {}
-//		~Face() { FIFO->InvalidateElement(iFIFO); }
-		void Reset() { normal.x = 0.0; normal.y = 0.0; normal.z = 0.0; vertSet.clear(); edge = nullptr; visited = false; visible = false; }
+		Face() : normal(0.0, 0.0, 0.0), edge(nullptr), iFirstConflict(-1), iFarthestConflict(-1), dFarthestConflict(0.0), iHeap(-1), id(-1), visited(false), visible(false) {}
 	};
-	struct FaceFIFO
+
+	// The faces with conflict points outside the slack, with the face whose farthest conflict point is the farthest on top
+	struct FaceHeap
 	{
 	public:
-		FaceFIFO() : m_iStart(0), m_iEnd(0) {}
-
+		void RemoveFaceFromHeap(Face* face);
 		void Push(Face* face);
-		QuickHull::Face* Pop();
-
-		int Size();
-
-		void InvalidateElement(int iFace) { m_queue[iFace].valid = false; }
-
+		void Pop();
+		Face* Top() const;
+		bool Empty() const { return m_faces.empty(); }
 	private:
-		struct ValidatedFace 
-		{
-			ValidatedFace() : face(nullptr), valid(false) {}
-			QuickHull::Face*	face;
-			bool				valid;
-		};
-		ValidatedFace m_queue[QUICKHULL_FACEFIFO_MAXSIZE];
-
-		int m_iStart;
-		int m_iEnd;
-	};
+		std::vector<Face*> m_faces;
 
-	FaceFIFO m_faceFIFO;
+		void HeapifyUp(int index);
+		void HeapifyDown(int index);
+		void RemoveFaceFromHeap(int index);
+	}
+	m_faceHeap;
 
 	HalfEdge* m_entryEdge; // an entrypoint into the mesh
 
-	HalfEdge* m_horizonEdges[QUICKHULL_MAXHORIZONEDGES];
-	int m_nHorizonEdges;
+	std::vector<HalfEdge*> m_horizonEdges;
 
-	std::vector<HalfEdge*> m_allocatedEdges;
-	std::vector<Face*> m_allocatedFaces;
+	ChunkedPool<HalfEdge, QUICKHULL_CHUNKSIZE> m_edges;
+	ChunkedPool<Face, QUICKHULL_CHUNKSIZE> m_faces;
 
 	const fVec3* m_verts;
 	int m_nVerts;
 
-	std::vector<const fVec3*> m_orphanedVerts;
+	// m_nextConflict[i] is the point after m_verts[i] in the conflict list it's in (or -1)
+	std::vector<int> m_nextConflict;
+	std::vector<int> m_orphanedVerts;
+
+	// Scratch space for CarveHorizon, kept to avoid reallocating on every step
+	std::vector<HalfEdge*> m_edgeStack;
+	std::vector<Face*> m_visitedFaces;
 
-	double m_dSlack;
+	// The precision of the points' coordinates, over the extent of the cloud. A point closer to a face than this might as well
+	// be in its plane, so the eye only sees faces it's further above (CarveHorizon); otherwise rounding decides which coplanar
+	// faces it sees.
+	double m_dPrecision;
+	// The slack, or the precision if that's larger. Points closer to a face than this don't expand the hull (AssignConflict).
+	// It can't decide what the eye sees, though: a face the eye is above but doesn't see folds against the new ones,
+	// by more the wider it is.
+	double m_dTolerance;
+
+	Stats m_stats;
+
+	HalfEdge* NewEdge();
+	Face* NewFace();
+
+	// Adds the point to the conflict list of the first of the faces that it's outside of (further than m_dTolerance), or failing
+	// that, the first it's just outside of (further than m_dPrecision). The points within the slack are never added to the hull,
+	// but they're kept track of, since the faces that replace theirs might leave them further out.
+	void AssignConflict(int iVert, Face* const* faces, int nFaces);
+	// Pushes the face onto the heap if its farthest conflict point is outside the slack
+	void PushIfExpandable(Face* face);
 
 	void InitTetrahedron();
 
-	void CarveHorizon(const fVec3& eye, Face* visibleFace);
-	bool PatchHorizon(const fVec3* eye);
+	// Finds the faces visible to the eye and the horizon around them, without changing the hull.
+	// Returns false if the horizon isn't a single loop, which the eye can't be connected to.
+	bool CarveHorizon(const fVec3& eye, Face* visibleFace);
+	// True if none of the faces connecting the eye to the horizon would be degenerate
+	bool CanPatchHorizon(const fVec3* eye) const;
+	// Replaces the visible faces with the faces connecting the eye to the horizon, and redistributes their conflict points
+	void PatchHorizon(const fVec3* eye);
+	// Clears the marks CarveHorizon left on the faces it visited
+	void ClearVisitedFaces();
+	// Removes the point from the face's conflict list, leaving it out of the hull
+	void DropConflict(Face* face, int iVert);
 };
-
@@ -5,7 +5,10 @@
 #define VERTEX_NORMAL_DIM 3
 #define VERTEX_COLOR_DIM 3
 
-RenderMesh::RenderMesh() : m_VAO(0), m_VBO_positions(0), m_VBO_normals(0), m_VBO_diffuse(0), m_VBO_specular(0), m_IBO(0)
+RenderMesh::RenderMesh() :
+	m_nVertices(0), m_nTriangles(0),
+	m_positions(nullptr), m_normals(nullptr), m_diffuse(nullptr), m_specular(nullptr), m_triangles(nullptr),
+	m_VAO(0), m_VBO_positions(0), m_VBO_normals(0), m_VBO_diffuse(0), m_VBO_specular(0), m_IBO(0), m_refCount(0)
 {
 }
 
@@ -15,6 +18,22 @@ RenderMesh::~RenderMesh()
 	ClearGLBufferObjects();
 }
 
+void RenderMesh::AddRef()
+{
+	m_refCount++;
+}
+
+void RenderMesh::Release()
+{
+	assert(m_refCount > 0);
+	m_refCount--;
+}
+
+int RenderMesh::GetRefCount() const
+{
+	return m_refCount;
+}
+
 unsigned int RenderMesh::GetNTriangles() const
 {
 	return m_nTriangles;
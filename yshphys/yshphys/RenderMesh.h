@@ -12,6 +12,11 @@ public:
 	RenderMesh();
 	virtual ~RenderMesh();
 
+	// Counts the render objects drawing this mesh (see RenderMeshLibrary). Like Geometry's, the count never frees the mesh itself.
+	void AddRef();
+	void Release();
+	int GetRefCount() const;
+
 	unsigned int GetNTriangles() const;
 	GLuint GetVAO() const;
 	GLuint GetIBO() const;
@@ -65,4 +70,6 @@ private:
 	GLuint m_VBO_diffuse;
 	GLuint m_VBO_specular;
 	GLuint m_IBO;
+
+	int m_refCount;
 };
@@ -0,0 +1,138 @@
+#include "stdafx.h"
+#include "RenderMeshLibrary.h"
+
+RenderMeshLibrary::Key::Key(Shape shape_, const float* dims, int nDims, const fVec3& diffuse, const fVec3& specular) : shape(shape_)
+{
+	assert(nDims <= 6);
+	for (int i = 0; i < 6; ++i)
+	{
+		params[i] = (i < nDims) ? dims[i] : 0.0f;
+	}
+	params[6] = diffuse.x;
+	params[7] = diffuse.y;
+	params[8] = diffuse.z;
+	params[9] = specular.x;
+	params[10] = specular.y;
+	params[11] = specular.z;
+}
+
+bool RenderMeshLibrary::Key::operator < (const Key& key) const
+{
+	if (shape != key.shape)
+	{
+		return shape < key.shape;
+	}
+	return std::lexicographical_compare(params, params + 12, key.params, key.params + 12);
+}
+
+RenderMeshLibrary::RenderMeshLibrary()
+{
+}
+
+RenderMeshLibrary::~RenderMeshLibrary()
+{
+	for (auto& entry : m_meshes)
+	{
+		delete entry.second;
+	}
+}
+
+RenderMesh* RenderMeshLibrary::Find(const Key& key) const
+{
+	auto it = m_meshes.find(key);
+	return (it != m_meshes.end()) ? it->second : nullptr;
+}
+
+RenderMesh* RenderMeshLibrary::GetBox(
+	float halfDimX, float halfDimY, float halfDimZ,
+	unsigned int divisionsX, unsigned int divisionsY, unsigned int divisionsZ,
+	const fVec3& diffuse, const fVec3& specular
+)
+{
+	const float dims[6] = { halfDimX, halfDimY, halfDimZ, (float)divisionsX, (float)divisionsY, (float)divisionsZ };
+	const Key key(SHAPE_BOX, dims, 6, diffuse, specular);
+	if (RenderMesh* mesh = Find(key))
+	{
+		return mesh;
+	}
+	RenderMesh* mesh = new RenderMesh;
+	mesh->CreateBox(halfDimX, halfDimY, halfDimZ, divisionsX, divisionsY, divisionsZ, diffuse, specular);
+	m_meshes[key] = mesh;
+	return mesh;
+}
+
+RenderMesh* RenderMeshLibrary::GetSphere(float radius, const fVec3& diffuse, const fVec3& specular)
+{
+	const Key key(SHAPE_SPHERE, &radius, 1, diffuse, specular);
+	if (RenderMesh* mesh = Find(key))
+	{
+		return mesh;
+	}
+	RenderMesh* mesh = new RenderMesh;
+	mesh->CreateSphere(radius, diffuse, specular);
+	m_meshes[key] = mesh;
+	return mesh;
+}
+
+RenderMesh* RenderMeshLibrary::GetCylinder(float radius, float halfHeight, const fVec3& diffuse, const fVec3& specular)
+{
+	const float dims[2] = { radius, halfHeight };
+	const Key key(SHAPE_CYLINDER, dims, 2, diffuse, specular);
+	if (RenderMesh* mesh = Find(key))
+	{
+		return mesh;
+	}
+	RenderMesh* mesh = new RenderMesh;
+	mesh->CreateCylinder(radius, halfHeight, diffuse, specular);
+	m_meshes[key] = mesh;
+	return mesh;
+}
+
+RenderMesh* RenderMeshLibrary::GetCapsule(float radius, float halfHeight, const fVec3& diffuse, const fVec3& specular)
+{
+	const float dims[2] = { radius, halfHeight };
+	const Key key(SHAPE_CAPSULE, dims, 2, diffuse, specular);
+	if (RenderMesh* mesh = Find(key))
+	{
+		return mesh;
+	}
+	RenderMesh* mesh = new RenderMesh;
+	mesh->CreateCapsule(radius, halfHeight, diffuse, specular);
+	m_meshes[key] = mesh;
+	return mesh;
+}
+
+RenderMesh* RenderMeshLibrary::GetCone(float radius, float height, const fVec3& diffuse, const fVec3& specular)
+{
+	const float dims[2] = { radius, height };
+	const Key key(SHAPE_CONE, dims, 2, diffuse, specular);
+	if (RenderMesh* mesh = Find(key))
+	{
+		return mesh;
+	}
+	RenderMesh* mesh = new RenderMesh;
+	mesh->CreateCone(radius, height, diffuse, specular);
+	m_meshes[key] = mesh;
+	return mesh;
+}
+
+void RenderMeshLibrary::PurgeUnused()
+{
+	for (auto it = m_meshes.begin(); it != m_meshes.end();)
+	{
+		if (it->second->GetRefCount() == 0)
+		{
+			delete it->second;
+			it = m_meshes.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+int RenderMeshLibrary::GetNMeshes() const
+{
+	return (int)m_meshes.size();
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "RenderMesh.h"
+
+// The rendering counterpart of GeometryLibrary: one RenderMesh (and one set of GL buffers) per shape, dimensions, and colours,
+// drawn by every render object that asks for it. The library owns the meshes, which are never modified once they're handed out.
+
+class RenderMeshLibrary
+{
+public:
+	RenderMeshLibrary();
+	~RenderMeshLibrary();
+
+	RenderMeshLibrary(const RenderMeshLibrary&) = delete;
+	RenderMeshLibrary& operator = (const RenderMeshLibrary&) = delete;
+
+	RenderMesh* GetBox(
+		float halfDimX, float halfDimY, float halfDimZ,
+		unsigned int divisionsX, unsigned int divisionsY, unsigned int divisionsZ,
+		const fVec3& diffuse, const fVec3& specular
+	);
+	RenderMesh* GetSphere(float radius, const fVec3& diffuse, const fVec3& specular);
+	RenderMesh* GetCylinder(float radius, float halfHeight, const fVec3& diffuse, const fVec3& specular);
+	RenderMesh* GetCapsule(float radius, float halfHeight, const fVec3& diffuse, const fVec3& specular);
+	RenderMesh* GetCone(float radius, float height, const fVec3& diffuse, const fVec3& specular);
+
+	// Frees the meshes that no render object references anymore
+	void PurgeUnused();
+
+	int GetNMeshes() const;
+
+private:
+	enum Shape
+	{
+		SHAPE_BOX = 0,
+		SHAPE_SPHERE,
+		SHAPE_CYLINDER,
+		SHAPE_CAPSULE,
+		SHAPE_CONE
+	};
+
+	// The dimensions (padded with zeros), followed by the diffuse and specular colours
+	struct Key
+	{
+		Key(Shape shape, const float* dims, int nDims, const fVec3& diffuse, const fVec3& specular);
+		bool operator < (const Key& key) const;
+
+		Shape shape;
+		float params[12];
+	};
+
+	RenderMesh* Find(const Key& key) const;
+
+	std::map<Key, RenderMesh*> m_meshes;
+};
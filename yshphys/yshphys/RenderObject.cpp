@@ -5,12 +5,18 @@
 RenderObject::RenderObject() :
 	m_node(nullptr),
 	m_pos(0.0f, 0.0f, 0.0f),
-	m_rot(0.0f, 0.0f, 0.0f, 1.0f)
+	m_rot(0.0f, 0.0f, 0.0f, 1.0f),
+	m_mesh(nullptr),
+	m_shader(nullptr)
 {
 }
 
 RenderObject::~RenderObject()
 {
+	if (m_mesh != nullptr)
+	{
+		m_mesh->Release();
+	}
 }
 
 RenderMesh* RenderObject::GetRenderMesh() const
@@ -43,6 +49,14 @@ void RenderObject::SetRotation(const fQuat& rot)
 }
 void RenderObject::SetRenderMesh(RenderMesh* mesh)
 {
+	if (mesh != nullptr)
+	{
+		mesh->AddRef();
+	}
+	if (m_mesh != nullptr)
+	{
+		m_mesh->Release();
+	}
 	m_mesh = mesh;
 }
 void RenderObject::SetShader(Shader* shader)
@@ -51,9 +65,7 @@ void RenderObject::SetShader(Shader* shader)
 }
 fMat44 RenderObject::CreateModelMatrix() const
 {
-	const fMat44 T(fHomogeneousTransformation::CreateTranslation(m_pos));
-	const fMat44 R(fHomogeneousTransformation::CreateRotation(m_rot));
-	return T*R;
+	return fHomogeneousTransformation::CreateRigidTransform(m_rot, m_pos);
 }
 
 void RenderObject::Draw(const fMat44& projectionMatrix, const fMat44& viewMatrix) const
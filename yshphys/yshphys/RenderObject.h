@@ -14,6 +14,10 @@ public:
 	RenderObject();
 	virtual ~RenderObject();
 
+	// The object holds a reference to its mesh (see RenderMesh::AddRef), which a copy would release twice
+	RenderObject(const RenderObject&) = delete;
+	RenderObject& operator = (const RenderObject&) = delete;
+
 	fVec3 GetPosition() const;
 	fQuat GetRotation() const;
 
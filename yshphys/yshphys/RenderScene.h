@@ -99,7 +99,7 @@ protected:
 	RenderNode* m_renderNodes;
 	RenderNode* m_firstNode;
 
-	DebugRenderer m_debugRenderer;
+	DebugRenderer_GL m_debugRenderer;
 
 	std::vector<PointLight> m_pointLights;
 
@@ -18,7 +18,6 @@ void QuantizeAABB(AABB& aabb)
 }
 
 RigidBody::RigidBody() :
-	m_nForces(0),
 	m_island(nullptr)
 {
 	m_geometry.geom = nullptr;
@@ -34,6 +33,16 @@ RigidBody::RigidBody() :
 	m_v = dVec3(0.0, 0.0, 0.0);
 	m_w = dVec3(0.0, 0.0, 0.0);
 
+	m_dP = dVec3(0.0, 0.0, 0.0);
+	m_dL = dVec3(0.0, 0.0, 0.0);
+	m_dPpseudo = dVec3(0.0, 0.0, 0.0);
+	m_dLpseudo = dVec3(0.0, 0.0, 0.0);
+
+	m_F = dVec3(0.0, 0.0, 0.0);
+	m_T = dVec3(0.0, 0.0, 0.0);
+
+	m_sweep = dVec3(0.0, 0.0, 0.0);
+
 	m_inertia.m = 0.0;
 	m_inertia.minv = 0.0;
 
@@ -52,6 +61,10 @@ RigidBody::RigidBody() :
 
 RigidBody::~RigidBody()
 {
+	if (m_geometry.geom != nullptr)
+	{
+		m_geometry.geom->Release();
+	}
 }
 
 double RigidBody::GetMass() const
@@ -91,10 +104,18 @@ dVec3 RigidBody::GetAngularVelocity() const
 {
 	return m_w;
 }
-Geometry* RigidBody::GetGeometry() const
+const Geometry* RigidBody::GetGeometry() const
 {
 	return m_geometry.geom;
 }
+bool RigidBody::IsFast() const
+{
+	return m_sweep.x != 0.0 || m_sweep.y != 0.0 || m_sweep.z != 0.0;
+}
+dVec3 RigidBody::GetSweep() const
+{
+	return m_sweep;
+}
 void RigidBody::GetGeometryLocalTransform(dVec3& pos, dQuat& rot) const
 {
 	pos = m_geometry.pos;
@@ -116,6 +137,8 @@ Material::Type RigidBody::GetMaterial(const dVec3& xWorldFrame) const
 void RigidBody::SetPosition(const dVec3& x)
 {
 	m_state.x = x;
+	// A teleport isn't motion. The next step sweeps the body from here.
+	m_sweep = dVec3(0.0, 0.0, 0.0);
 	UpdateAABB();
 }
 void RigidBody::SetRotation(const dQuat& q)
@@ -124,8 +147,16 @@ void RigidBody::SetRotation(const dQuat& q)
 	UpdateDependentStateVariables();
 	UpdateAABB();
 }
-void RigidBody::SetGeometry(Geometry* geometry, const dVec3& pos, const dQuat& rot)
+void RigidBody::SetGeometry(const Geometry* geometry, const dVec3& pos, const dQuat& rot)
 {
+	if (geometry != nullptr)
+	{
+		geometry->AddRef();
+	}
+	if (m_geometry.geom != nullptr)
+	{
+		m_geometry.geom->Release();
+	}
 	m_geometry.geom = geometry;
 	m_geometry.pos = pos;
 	m_geometry.rot = rot;
@@ -202,9 +233,39 @@ void RigidBody::SetInertia(const dQuat& principleAxes, const dVec3& inertia)
 	SetInertia(R.Transpose()*I*R);
 }
 
-void RigidBody::ApplyBruteForce(Force* force)
+int RigidBody::AddForce(Force* force)
+{
+	assert(force != nullptr);
+	for (int i = 0; i < (int)m_forces.size(); ++i)
+	{
+		if (m_forces[i] == nullptr)
+		{
+			m_forces[i] = force;
+			return i;
+		}
+	}
+	m_forces.push_back(force);
+	return (int)m_forces.size() - 1;
+}
+void RigidBody::RemoveForce(int handle)
+{
+	assert(handle >= 0 && handle < (int)m_forces.size() && m_forces[handle] != nullptr);
+	m_forces[handle] = nullptr;
+}
+void RigidBody::ComputeForceGenerators(const RigidBody::State& state, dVec3& F, dVec3& T) const
 {
-	m_forces[m_nForces++] = force;
+	F = dVec3(0.0, 0.0, 0.0);
+	T = dVec3(0.0, 0.0, 0.0);
+	for (const Force* force : m_forces)
+	{
+		if (force != nullptr)
+		{
+			dVec3 Fi, Ti;
+			force->ComputeForceAndTorque(m_inertia, state, Fi, Ti);
+			F = F + Fi;
+			T = T + Ti;
+		}
+	}
 }
 void RigidBody::ApplyForce(const dVec3& force, const dVec3& worldPos)
 {
@@ -248,6 +309,13 @@ void RigidBody::UpdateAABB()
 	m_AABB.min = aabbCenter - aabbSpan;
 	m_AABB.max = aabbCenter + aabbSpan;
 
+	m_AABB.min.x += std::min(0.0, m_sweep.x);
+	m_AABB.min.y += std::min(0.0, m_sweep.y);
+	m_AABB.min.z += std::min(0.0, m_sweep.z);
+	m_AABB.max.x += std::max(0.0, m_sweep.x);
+	m_AABB.max.y += std::max(0.0, m_sweep.y);
+	m_AABB.max.z += std::max(0.0, m_sweep.z);
+
 	QuantizeAABB(m_AABB);
 
 	if (m_bvNode != nullptr)
@@ -354,19 +422,13 @@ void RigidBody::ResolveForces(double dt)
 		RigidBody::State& stateDerivative = stateDerivatives[i];
 		ZeroState(stateDerivative);
 
-		stateDerivative.P = m_F;
-		stateDerivative.L = m_T;
-
 		Compute_xDot(state.P, stateDerivative.x);
 		Compute_qDot(state.q, state.L, stateDerivative.q);
 
-		for (int j = 0; j < m_nForces; ++j)
-		{
-			dVec3 F, T;
-			m_forces[j]->ComputeForceAndTorque(m_inertia, m_state, F, T);
-			stateDerivative.P = stateDerivative.P + F;
-			stateDerivative.L = stateDerivative.L + T;
-		}
+		dVec3 F, T;
+		ComputeForceGenerators(state, F, T);
+		stateDerivative.P = m_F + F;
+		stateDerivative.L = m_T + T;
 
 		if (i == 3)
 		{
@@ -394,16 +456,128 @@ void RigidBody::ResolveForces(double dt)
 
 	UpdateAABB();
 
-	for (int i = 0; i < m_nForces; ++i)
+	m_F = dVec3(0.0, 0.0, 0.0);
+	m_T = dVec3(0.0, 0.0, 0.0);
+}
+
+void RigidBody::ResolveForcesSemiImplicitEuler(double dt, bool gyroscopic)
+{
+	dVec3 F, T;
+	ComputeForceGenerators(m_state, F, T);
+	F = F + m_F;
+	T = T + m_T;
+
+	// Velocities first...
+
+	m_state.P = m_state.P + F.Scale(dt);
+	m_state.L = m_state.L + T.Scale(dt);
+
+	const dMat33 R(m_state.q);
+	dVec3 w = (R*m_inertia.Ibodyinv*R.Transpose()).Transform(m_state.L);
+
+	const dMat33& Ibinv = m_inertia.Ibodyinv;
+	if (gyroscopic && Ibinv(0, 0) != 0.0 && Ibinv(1, 1) != 0.0 && Ibinv(2, 2) != 0.0)
 	{
-		delete m_forces[i];
+		// Solve Ib*(wb' - wb) + dt*(wb' x Ib*wb') = 0 for the new angular velocity wb' in the body frame,
+		// with one Newton iteration from wb. Bodies that can't rotate about some axis are skipped (Ib is singular).
+		auto Skew = [](const dVec3& v)
+		{
+			dMat33 S;
+			S.SetRow(0, dVec3(0.0, -v.z, v.y));
+			S.SetRow(1, dVec3(v.z, 0.0, -v.x));
+			S.SetRow(2, dVec3(-v.y, v.x, 0.0));
+			return S;
+		};
+
+		const dMat33& Ib = m_inertia.Ibody;
+		const dVec3 wb = R.Transpose().Transform(w);
+		const dVec3 Lb = Ib.Transform(wb);
+		const dVec3 f = wb.Cross(Lb).Scale(dt);
+		const dMat33 J = Ib + (Skew(wb)*Ib + Skew(Lb).Scale(-1.0)).Scale(dt);
+		w = R.Transform(wb - J.Inverse().Transform(f));
 	}
-	m_nForces = 0;
+
+	// ...then the position and orientation
+
+	m_state.x = m_state.x + m_state.P.Scale(m_inertia.minv*dt);
+
+	dQuat wQuat;
+	wQuat.x = w.x;
+	wQuat.y = w.y;
+	wQuat.z = w.z;
+	wQuat.w = 0.0;
+
+	const dQuat qDot = wQuat*m_state.q;
+	m_state.q.x += 0.5*dt*qDot.x;
+	m_state.q.y += 0.5*dt*qDot.y;
+	m_state.q.z += 0.5*dt*qDot.z;
+	m_state.q.w += 0.5*dt*qDot.w;
+	m_state.q = m_state.q.Normalize();
+
+	// The angular velocity is the integrated quantity, so the momentum follows the rotated inertia
+	const dMat33 Rnew(m_state.q);
+	m_state.L = (Rnew*m_inertia.Ibody*Rnew.Transpose()).Transform(w);
+
+	UpdateDependentStateVariables();
+
+	UpdateAABB();
 
 	m_F = dVec3(0.0, 0.0, 0.0);
 	m_T = dVec3(0.0, 0.0, 0.0);
 }
 
+void RigidBody::UpdateSweep(double dt)
+{
+	// The velocity the body will be integrated with: its pending impulses and forces are applied first. Force generators
+	// are left out, since they're evaluated at every stage of the integrator.
+
+	const dVec3 motion = (m_state.P + m_dP + m_F.Scale(dt)).Scale(m_inertia.minv*dt);
+
+	const BoundingBox oobb = m_geometry.geom->GetLocalOOBB();
+	const dVec3 halfExtent = (oobb.max - oobb.min).Scale(0.5);
+	const double threshold = RIGIDBODY_CCD_THRESHOLD*std::min(halfExtent.x, std::min(halfExtent.y, halfExtent.z));
+
+	const dVec3 sweep = (motion.Dot(motion) > threshold*threshold) ? motion : dVec3(0.0, 0.0, 0.0);
+	if (sweep != m_sweep)
+	{
+		m_sweep = sweep;
+		UpdateAABB();
+	}
+}
+
+void RigidBody::ResolvePseudoImpulses(double dt)
+{
+	if (m_dPpseudo == dVec3(0.0, 0.0, 0.0) && m_dLpseudo == dVec3(0.0, 0.0, 0.0))
+	{
+		return;
+	}
+
+	// Move the body with the pseudo velocities for one step
+
+	const dVec3 v = m_dPpseudo.Scale(m_inertia.minv);
+	const dVec3 w = m_Iinv.Transform(m_dLpseudo);
+
+	m_state.x = m_state.x + v.Scale(dt);
+
+	dQuat wQuat;
+	wQuat.x = w.x;
+	wQuat.y = w.y;
+	wQuat.z = w.z;
+	wQuat.w = 0.0;
+
+	const dQuat qDot = wQuat*m_state.q;
+	m_state.q.x += 0.5*dt*qDot.x;
+	m_state.q.y += 0.5*dt*qDot.y;
+	m_state.q.z += 0.5*dt*qDot.z;
+	m_state.q.w += 0.5*dt*qDot.w;
+	m_state.q = m_state.q.Normalize();
+
+	m_dPpseudo = dVec3(0.0, 0.0, 0.0);
+	m_dLpseudo = dVec3(0.0, 0.0, 0.0);
+
+	// ResolveForces follows, and updates the dependent state variables and the AABB
+}
+
 void RigidBody::Damp(double dt)
 {
 	const double attenuationPerSec_P = 0.2;
@@ -422,8 +596,21 @@ void RigidBody::Step(double dt)
 		return;
 	}
 	ResolveImpulses();
+	ResolvePseudoImpulses(dt);
 	ResolveForces(dt);
 	Damp(dt);
 }
 
+void RigidBody::StepSemiImplicitEuler(double dt, bool gyroscopic)
+{
+	if (!m_awake)
+	{
+		return;
+	}
+	ResolveImpulses();
+	ResolvePseudoImpulses(dt);
+	ResolveForcesSemiImplicitEuler(dt, gyroscopic);
+	Damp(dt);
+}
+
 
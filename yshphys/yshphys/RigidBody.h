@@ -7,6 +7,10 @@
 class Force;
 class Island;
 
+// Bodies that move further than this fraction of their smallest half extent in a step are fast: their AABBs are swept
+// over their motion, and they get speculative contacts with whatever they're about to hit (continuous collision detection)
+#define RIGIDBODY_CCD_THRESHOLD 0.5
+
 // See http://www.cs.cmu.edu/~baraff/sigcourse/notesd1.pdf
 // and http://www.cs.cmu.edu/~baraff/sigcourse/notesd2.pdf
 
@@ -17,9 +21,23 @@ struct DampedOscillatorCoefficients
 	float b;
 };
 
+enum Integrator
+{
+	INTEGRATOR_RK4, // fourth order Runge-Kutta on the momenta, position, and orientation. Forces are evaluated four times a step.
+	INTEGRATOR_SEMI_IMPLICIT_EULER // symplectic Euler: the velocities are updated first, then move the body. Forces are evaluated once.
+};
+
+struct IntegratorConfig
+{
+	Integrator integrator;
+	// Semi-implicit Euler only. If set, the gyroscopic torque (-w x Iw) is integrated implicitly, so that tumbling
+	// bodies precess without gaining energy. Otherwise the angular velocity is carried across the step unchanged.
+	bool gyroscopic;
+};
+
 struct CollisionGeometry
 {
-	Geometry* geom;
+	const Geometry* geom; // possibly shared with other bodies, so it's never modified through the body
 	dVec3 pos;
 	dQuat rot;
 };
@@ -47,6 +65,10 @@ public:
 	RigidBody();
 	virtual ~RigidBody();
 
+	// The body holds a reference to its geometry (see Geometry::AddRef), which a copy would release twice
+	RigidBody(const RigidBody&) = delete;
+	RigidBody& operator = (const RigidBody&) = delete;
+
 	double GetMass() const;
 	double GetInverseMass() const;
 	dMat33 GetInverseInertia() const;
@@ -57,7 +79,9 @@ public:
 	dQuat GetRotation() const;
 	dVec3 GetLinearVelocity() const;
 	dVec3 GetAngularVelocity() const;
-	Geometry* GetGeometry() const;
+	const Geometry* GetGeometry() const;
+	bool IsFast() const;
+	dVec3 GetSweep() const;
 	void GetGeometryLocalTransform(dVec3& pos, dQuat& rot) const;
 	void GetGeometryGlobalTransform(dVec3& pos, dQuat& rot) const;
 
@@ -65,24 +89,41 @@ public:
 
 	void SetPosition(const dVec3& x);
 	void SetRotation(const dQuat& q);
-	void SetGeometry(Geometry* geometry, const dVec3& relativePos, const dQuat& relativeRot);
+	void SetGeometry(const Geometry* geometry, const dVec3& relativePos, const dQuat& relativeRot);
 	void SetMass(double m);
 	void SetInertia(const dMat33& Ibody);
 	void SetInertia(const dQuat& principleAxes, const dVec3& inertia);
 
-	void ApplyBruteForce(Force* force);
+	// Force generators are evaluated every step (at every stage of the integrator) until they're removed.
+	// They're owned by the caller and must outlive their registration. Returns a handle for RemoveForce.
+	// There's no limit to how many are registered. Registering may allocate, stepping never does.
+	int AddForce(Force* force);
+	void RemoveForce(int handle);
 
+	// Transient forces are accumulated, and cleared once the body has been stepped
 	void ApplyForce(const dVec3& force, const dVec3& worldPos);
 	void ApplyImpulse(const dVec3& impulse, const dVec3& worldPos);
 
 	void ApplyLinImpulse(const dVec3& linImpulse) { m_dP = m_dP + linImpulse; }
 	void ApplyAngImpulse(const dVec3& angImpulse) { m_dL = m_dL + angImpulse; }
 
+	// Pseudo impulses only correct the position and orientation: they change the body's velocity for the current step
+	// and are then discarded, so that resolving penetration doesn't add kinetic energy
+	void ApplyLinPseudoImpulse(const dVec3& linImpulse) { m_dPpseudo = m_dPpseudo + linImpulse; }
+	void ApplyAngPseudoImpulse(const dVec3& angImpulse) { m_dLpseudo = m_dLpseudo + angImpulse; }
+
 	void ApplyForceAtCOM(const dVec3& force) { m_F = m_F + force; }
+	void ApplyTorque(const dVec3& torque) { m_T = m_T + torque; }
 	void ApplyImpulseAtCOM(const dVec3& impulse) { m_dP = m_dP + impulse; }
 
 	dVec3 GetForce() const { return m_F; }
 	dVec3 GetTorque() const { return m_T; }
+	dVec3 GetLinImpulse() const { return m_dP; }
+	dVec3 GetAngImpulse() const { return m_dL; }
+
+	// Extends the AABB over the motion of the coming step, if the body is fast enough to skip past a contact.
+	// Called once the step's forces and impulses are applied, and before its broadphase.
+	void UpdateSweep(double dt);
 
 	void SetIsland(Island* island)
 	{
@@ -95,7 +136,9 @@ public:
 
 	virtual void UpdateAABB();
 
+	// Integrates with RK4
 	virtual void Step(double dt);
+	void StepSemiImplicitEuler(double dt, bool gyroscopic);
 
 protected:
 
@@ -107,9 +150,14 @@ protected:
 	dVec3 m_dP; // linear impulse
 	dVec3 m_dL; // angular impulse
 
+	dVec3 m_dPpseudo; // linear pseudo impulse
+	dVec3 m_dLpseudo; // angular pseudo impulse
+
 	dVec3 m_F;
 	dVec3 m_T;
 
+	dVec3 m_sweep; // the motion the AABB is swept over (zero unless the body is fast)
+
 	// DERIVED STATE VARIABLES
 	dMat33 m_Iinv;
 	dVec3 m_v; // linear  velocity
@@ -134,8 +182,7 @@ protected:
 		assert(m_Iinv.Transpose() == m_Iinv);
 	}
 
-	Force* m_forces[64];
-	int m_nForces;
+	std::vector<Force*> m_forces; // null for free slots, which are reused
 
 	// m_island should be null for static objects, since static objects should be able to appear in multiple islands
 	Island* m_island;
@@ -145,6 +192,9 @@ protected:
 
 	void ResolveImpulses();
 	void ResolveForces(double dt);
+	void ResolveForcesSemiImplicitEuler(double dt, bool gyroscopic);
+	void ComputeForceGenerators(const RigidBody::State& state, dVec3& F, dVec3& T) const;
+	void ResolvePseudoImpulses(double dt);
 
 	void Damp(double dt);
 };
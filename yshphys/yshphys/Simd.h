@@ -0,0 +1,230 @@
+#pragma once
+
+// Compile-time selection of the SIMD backend used by the <float> math specializations.
+// YSH_SIMD_SSE is on for any x64 build (SSE2 is part of the baseline) and YSH_SIMD_AVX follows /arch:AVX.
+// Define YSH_SIMD_DISABLE to force the portable scalar code everywhere.
+
+#if !defined(YSH_SIMD_DISABLE)
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YSH_SIMD_SSE 1
+#endif
+#if defined(__AVX__)
+#define YSH_SIMD_AVX 1
+#endif
+#endif
+
+#ifndef YSH_SIMD_SSE
+#define YSH_SIMD_SSE 0
+#endif
+#ifndef YSH_SIMD_AVX
+#define YSH_SIMD_AVX 0
+#endif
+
+#include <cstdint>
+
+#if YSH_SIMD_AVX
+#include <immintrin.h>
+#elif YSH_SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Simd
+{
+	// Row-major 4x4 matrix times column vector. The <float> overload below takes over when SSE is available.
+	template <class T>
+	inline void Mat44Transform(const T* M, const T* v, T* out)
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			out[i] = M[4 * i] * v[0] + M[4 * i + 1] * v[1] + M[4 * i + 2] * v[2] + M[4 * i + 3] * v[3];
+		}
+	}
+}
+
+#if YSH_SIMD_SSE
+
+// _mm_shuffle_ps with the lane selectors written in x, y, z, w order
+#define YSH_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps((a), (b), _MM_SHUFFLE((w), (z), (y), (x)))
+#define YSH_SWIZZLE(v, x, y, z, w) YSH_SHUFFLE(v, v, x, y, z, w)
+
+namespace Simd
+{
+	inline __m128 Load(const float* p) { return _mm_loadu_ps(p); }
+	inline void Store(float* p, __m128 v) { _mm_storeu_ps(p, v); }
+
+	// Returns the sum of all four lanes, broadcast to every lane
+	inline __m128 HorizontalSum(__m128 v)
+	{
+		const __m128 s = _mm_add_ps(v, YSH_SWIZZLE(v, 1, 0, 3, 2));
+		return _mm_add_ps(s, YSH_SWIZZLE(s, 2, 3, 0, 1));
+	}
+
+	inline __m128 MultiplyAdd(__m128 a, __m128 b, __m128 c)
+	{
+#if YSH_SIMD_AVX && defined(__FMA__)
+		return _mm_fmadd_ps(a, b, c);
+#else
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+	}
+
+	inline void Mat44Transform(const float* M, const float* v, float* out)
+	{
+		// Multiply each row by v, then transpose the partial products so that one vertical add finishes all four dots
+		const __m128 x = Load(v);
+		__m128 p0 = _mm_mul_ps(Load(M), x);
+		__m128 p1 = _mm_mul_ps(Load(M + 4), x);
+		__m128 p2 = _mm_mul_ps(Load(M + 8), x);
+		__m128 p3 = _mm_mul_ps(Load(M + 12), x);
+		_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+		const __m128 product = _mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3));
+		Store(out, product);
+	}
+}
+
+#endif
+
+namespace Simd
+{
+	// Four doubles operated on together: one AVX register, a pair of SSE2 registers, or a plain array.
+	// Comparisons return a Double4 whose lanes have all bits set where the comparison holds.
+	struct alignas(32) Double4
+	{
+#if YSH_SIMD_AVX
+		__m256d v;
+#elif YSH_SIMD_SSE
+		__m128d lo, hi;
+#else
+		double v[4];
+#endif
+	};
+
+#if YSH_SIMD_AVX
+
+	inline Double4 Make(__m256d v) { Double4 a; a.v = v; return a; }
+
+	inline Double4 Splat(double x) { return Make(_mm256_set1_pd(x)); }
+	inline Double4 Set(double x0, double x1, double x2, double x3) { return Make(_mm256_setr_pd(x0, x1, x2, x3)); }
+	inline Double4 Load(const double* p) { return Make(_mm256_load_pd(p)); }
+	inline void Store(double* p, const Double4& a) { _mm256_store_pd(p, a.v); }
+
+	inline Double4 operator + (const Double4& a, const Double4& b) { return Make(_mm256_add_pd(a.v, b.v)); }
+	inline Double4 operator - (const Double4& a, const Double4& b) { return Make(_mm256_sub_pd(a.v, b.v)); }
+	inline Double4 operator * (const Double4& a, const Double4& b) { return Make(_mm256_mul_pd(a.v, b.v)); }
+	inline Double4 operator / (const Double4& a, const Double4& b) { return Make(_mm256_div_pd(a.v, b.v)); }
+
+	inline Double4 Min(const Double4& a, const Double4& b) { return Make(_mm256_min_pd(a.v, b.v)); }
+	inline Double4 Max(const Double4& a, const Double4& b) { return Make(_mm256_max_pd(a.v, b.v)); }
+	inline Double4 Abs(const Double4& a) { return Make(_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)); }
+	inline Double4 Sqrt(const Double4& a) { return Make(_mm256_sqrt_pd(a.v)); }
+
+	inline Double4 Greater(const Double4& a, const Double4& b) { return Make(_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)); }
+	inline Double4 And(const Double4& mask, const Double4& a) { return Make(_mm256_and_pd(mask.v, a.v)); }
+	inline Double4 AndNot(const Double4& mask, const Double4& a) { return Make(_mm256_andnot_pd(mask.v, a.v)); }
+	// mask ? a : b, per lane
+	inline Double4 Select(const Double4& mask, const Double4& a, const Double4& b) { return Make(_mm256_blendv_pd(b.v, a.v, mask.v)); }
+	// Bit i is set if lane i of the mask is set
+	inline int MaskBits(const Double4& mask) { return _mm256_movemask_pd(mask.v); }
+
+#elif YSH_SIMD_SSE
+
+	inline Double4 Make(__m128d lo, __m128d hi) { Double4 a; a.lo = lo; a.hi = hi; return a; }
+
+	inline Double4 Splat(double x) { return Make(_mm_set1_pd(x), _mm_set1_pd(x)); }
+	inline Double4 Set(double x0, double x1, double x2, double x3) { return Make(_mm_setr_pd(x0, x1), _mm_setr_pd(x2, x3)); }
+	inline Double4 Load(const double* p) { return Make(_mm_load_pd(p), _mm_load_pd(p + 2)); }
+	inline void Store(double* p, const Double4& a) { _mm_store_pd(p, a.lo); _mm_store_pd(p + 2, a.hi); }
+
+	inline Double4 operator + (const Double4& a, const Double4& b) { return Make(_mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi)); }
+	inline Double4 operator - (const Double4& a, const Double4& b) { return Make(_mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi)); }
+	inline Double4 operator * (const Double4& a, const Double4& b) { return Make(_mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi)); }
+	inline Double4 operator / (const Double4& a, const Double4& b) { return Make(_mm_div_pd(a.lo, b.lo), _mm_div_pd(a.hi, b.hi)); }
+
+	inline Double4 Min(const Double4& a, const Double4& b) { return Make(_mm_min_pd(a.lo, b.lo), _mm_min_pd(a.hi, b.hi)); }
+	inline Double4 Max(const Double4& a, const Double4& b) { return Make(_mm_max_pd(a.lo, b.lo), _mm_max_pd(a.hi, b.hi)); }
+	inline Double4 Abs(const Double4& a)
+	{
+		const __m128d sign = _mm_set1_pd(-0.0);
+		return Make(_mm_andnot_pd(sign, a.lo), _mm_andnot_pd(sign, a.hi));
+	}
+	inline Double4 Sqrt(const Double4& a) { return Make(_mm_sqrt_pd(a.lo), _mm_sqrt_pd(a.hi)); }
+
+	inline Double4 Greater(const Double4& a, const Double4& b) { return Make(_mm_cmpgt_pd(a.lo, b.lo), _mm_cmpgt_pd(a.hi, b.hi)); }
+	inline Double4 And(const Double4& mask, const Double4& a) { return Make(_mm_and_pd(mask.lo, a.lo), _mm_and_pd(mask.hi, a.hi)); }
+	inline Double4 AndNot(const Double4& mask, const Double4& a) { return Make(_mm_andnot_pd(mask.lo, a.lo), _mm_andnot_pd(mask.hi, a.hi)); }
+	inline Double4 Select(const Double4& mask, const Double4& a, const Double4& b)
+	{
+		return Make(
+			_mm_or_pd(_mm_and_pd(mask.lo, a.lo), _mm_andnot_pd(mask.lo, b.lo)),
+			_mm_or_pd(_mm_and_pd(mask.hi, a.hi), _mm_andnot_pd(mask.hi, b.hi)));
+	}
+	inline int MaskBits(const Double4& mask) { return _mm_movemask_pd(mask.lo) | (_mm_movemask_pd(mask.hi) << 2); }
+
+#else
+
+	inline Double4 Splat(double x) { Double4 a; for (int i = 0; i < 4; ++i) { a.v[i] = x; } return a; }
+	inline Double4 Set(double x0, double x1, double x2, double x3) { Double4 a; a.v[0] = x0; a.v[1] = x1; a.v[2] = x2; a.v[3] = x3; return a; }
+	inline Double4 Load(const double* p) { Double4 a; for (int i = 0; i < 4; ++i) { a.v[i] = p[i]; } return a; }
+	inline void Store(double* p, const Double4& a) { for (int i = 0; i < 4; ++i) { p[i] = a.v[i]; } }
+
+	inline Double4 operator + (const Double4& a, const Double4& b) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = a.v[i] + b.v[i]; } return c; }
+	inline Double4 operator - (const Double4& a, const Double4& b) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = a.v[i] - b.v[i]; } return c; }
+	inline Double4 operator * (const Double4& a, const Double4& b) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = a.v[i] * b.v[i]; } return c; }
+	inline Double4 operator / (const Double4& a, const Double4& b) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = a.v[i] / b.v[i]; } return c; }
+
+	inline Double4 Min(const Double4& a, const Double4& b) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; } return c; }
+	inline Double4 Max(const Double4& a, const Double4& b) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; } return c; }
+	inline Double4 Abs(const Double4& a) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = a.v[i] < 0.0 ? -a.v[i] : a.v[i]; } return c; }
+	inline Double4 Sqrt(const Double4& a) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = sqrt(a.v[i]); } return c; }
+
+	// Mask lanes are stored as doubles so that the layout matches the SIMD versions, but only their bits are used
+	inline double MaskLane(bool set) { unsigned long long bits = set ? ~0ull : 0ull; double x; std::memcpy(&x, &bits, sizeof(x)); return x; }
+	inline bool IsSet(double lane) { unsigned long long bits; std::memcpy(&bits, &lane, sizeof(bits)); return bits != 0; }
+
+	inline Double4 Greater(const Double4& a, const Double4& b) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = MaskLane(a.v[i] > b.v[i]); } return c; }
+	inline Double4 And(const Double4& mask, const Double4& a) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = IsSet(mask.v[i]) ? a.v[i] : 0.0; } return c; }
+	inline Double4 AndNot(const Double4& mask, const Double4& a) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = IsSet(mask.v[i]) ? 0.0 : a.v[i]; } return c; }
+	inline Double4 Select(const Double4& mask, const Double4& a, const Double4& b) { Double4 c; for (int i = 0; i < 4; ++i) { c.v[i] = IsSet(mask.v[i]) ? a.v[i] : b.v[i]; } return c; }
+	inline int MaskBits(const Double4& mask) { int bits = 0; for (int i = 0; i < 4; ++i) { bits |= IsSet(mask.v[i]) ? (1 << i) : 0; } return bits; }
+
+#endif
+
+	inline double HorizontalMax(const Double4& a)
+	{
+		alignas(32) double x[4];
+		Store(x, a);
+		return std::max(std::max(x[0], x[1]), std::max(x[2], x[3]));
+	}
+
+	// An allocator for containers of Double4s (or of structs holding them). Before C++17, new ignores an alignment over
+	// 16 bytes, which the AVX loads and stores would fault on. Each block keeps the pointer that was really allocated
+	// just before the aligned storage.
+	template <class T>
+	struct AlignedAllocator
+	{
+		typedef T value_type;
+
+		AlignedAllocator() {}
+		template <class U>
+		AlignedAllocator(const AlignedAllocator<U>&) {}
+
+		T* allocate(std::size_t n)
+		{
+			const std::size_t alignment = alignof(T) < 32 ? 32 : alignof(T);
+			char* block = static_cast<char*>(::operator new(n * sizeof(T) + alignment + sizeof(void*)));
+			const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(block + sizeof(void*));
+			void** aligned = reinterpret_cast<void**>((start + alignment - 1) & ~(std::uintptr_t)(alignment - 1));
+			aligned[-1] = block;
+			return reinterpret_cast<T*>(aligned);
+		}
+		void deallocate(T* p, std::size_t)
+		{
+			::operator delete(reinterpret_cast<void**>(p)[-1]);
+		}
+
+		template <class U>
+		bool operator == (const AlignedAllocator<U>&) const { return true; }
+		template <class U>
+		bool operator != (const AlignedAllocator<U>&) const { return false; }
+	};
+}
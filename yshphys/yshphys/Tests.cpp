@@ -8,14 +8,12 @@
 #include "Sphere.h"
 #include "Cone.h"
 #include "Box.h"
+#include "TriangleMesh.h"
 
 void Tests::CreateCylinder(Game* game, double r, double h, double m, const dVec3& pos, const dQuat& rot, const fVec3& diffuse, const fVec3& specular)
 {
-	Cylinder* geom = new Cylinder;
-	geom->SetRadius(r);
-	geom->SetHalfHeight(h);
-	RenderMesh* mesh = new RenderMesh;
-	mesh->CreateCylinder((float)r, (float)h, diffuse, specular);
+	const Cylinder* geom = game->m_geometryLibrary.GetCylinder(r, h);
+	RenderMesh* mesh = game->m_renderMeshLibrary.GetCylinder((float)r, (float)h, diffuse, specular);
 	RenderObject* renderObj = new RenderObject;
 	renderObj->SetRenderMesh(mesh);
 	renderObj->SetShader(nullptr);
@@ -38,11 +36,8 @@ void Tests::CreateCylinder(Game* game, double r, double h, double m, const dVec3
 }
 void Tests::CreateCapsule(Game* game, double r, double h, double m, const dVec3& pos, const dQuat& rot, const fVec3& diffuse, const fVec3& specular)
 {
-	Capsule* geom = new Capsule;
-	geom->SetRadius(r);
-	geom->SetHalfHeight(h);
-	RenderMesh* mesh = new RenderMesh;
-	mesh->CreateCapsule((float)r, (float)h, diffuse, specular);
+	const Capsule* geom = game->m_geometryLibrary.GetCapsule(r, h);
+	RenderMesh* mesh = game->m_renderMeshLibrary.GetCapsule((float)r, (float)h, diffuse, specular);
 	RenderObject* renderObj = new RenderObject;
 	renderObj->SetRenderMesh(mesh);
 	renderObj->SetShader(nullptr);
@@ -65,11 +60,8 @@ void Tests::CreateCapsule(Game* game, double r, double h, double m, const dVec3&
 }
 void Tests::CreateCone(Game* game, double r, double h, double m, const dVec3& pos, const dQuat& rot, const fVec3& diffuse, const fVec3& specular)
 {
-	Cone* geom = new Cone;
-	geom->SetRadius(r);
-	geom->SetHeight(h);
-	RenderMesh* mesh = new RenderMesh;
-	mesh->CreateCone((float)r, (float)h, diffuse, specular);
+	const Cone* geom = game->m_geometryLibrary.GetCone(r, h);
+	RenderMesh* mesh = game->m_renderMeshLibrary.GetCone((float)r, (float)h, diffuse, specular);
 	RenderObject* renderObj = new RenderObject;
 	renderObj->SetRenderMesh(mesh);
 	renderObj->SetShader(nullptr);
@@ -91,12 +83,10 @@ void Tests::CreateCone(Game* game, double r, double h, double m, const dVec3& po
 	gameObject->m_renderPosOffset = fVec3(0.0f, 0.0f, -(float)h*0.25f);
 	game->AddGameObject(gameObject);
 }
-void Tests::CreateSphere(Game* game, double r, double m, const dVec3& pos, const dQuat& rot, const fVec3& diffuse, const fVec3& specular)
+RigidBody* Tests::CreateSphere(Game* game, double r, double m, const dVec3& pos, const dQuat& rot, const fVec3& diffuse, const fVec3& specular)
 {
-	Sphere* geom = new Sphere;
-	geom->SetRadius(r);
-	RenderMesh* mesh = new RenderMesh;
-	mesh->CreateSphere((float)r, diffuse, specular);
+	const Sphere* geom = game->m_geometryLibrary.GetSphere(r);
+	RenderMesh* mesh = game->m_renderMeshLibrary.GetSphere((float)r, diffuse, specular);
 	RenderObject* renderObj = new RenderObject;
 	renderObj->SetRenderMesh(mesh);
 	renderObj->SetShader(nullptr);
@@ -113,13 +103,13 @@ void Tests::CreateSphere(Game* game, double r, double m, const dVec3& pos, const
 	gameObject->SetPhysicsObject(body);
 	gameObject->SetRenderObject(renderObj);
 	game->AddGameObject(gameObject);
+
+	return body;
 }
-void Tests::CreateBox(Game* game, const fVec3& halfDim, double m, const dVec3& pos, const dQuat& rot, const fVec3& diffuse, const fVec3& specular)
+RigidBody* Tests::CreateBox(Game* game, const fVec3& halfDim, double m, const dVec3& pos, const dQuat& rot, const fVec3& diffuse, const fVec3& specular)
 {
-	Box* geom = new Box;
-	geom->SetDimensions(halfDim.x, halfDim.y, halfDim.z);
-	RenderMesh* mesh = new RenderMesh;
-	mesh->CreateBox(halfDim.x, halfDim.y, halfDim.z, 2, 2, 2, diffuse, specular);
+	const Box* geom = game->m_geometryLibrary.GetBox(halfDim.x, halfDim.y, halfDim.z);
+	RenderMesh* mesh = game->m_renderMeshLibrary.GetBox(halfDim.x, halfDim.y, halfDim.z, 2, 2, 2, diffuse, specular);
 	RenderObject* renderObj = new RenderObject;
 	renderObj->SetRenderMesh(mesh);
 	renderObj->SetShader(nullptr);
@@ -139,6 +129,8 @@ void Tests::CreateBox(Game* game, const fVec3& halfDim, double m, const dVec3& p
 	gameObject->SetPhysicsObject(body);
 	gameObject->SetRenderObject(renderObj);
 	game->AddGameObject(gameObject);
+
+	return body;
 }
 
 void Tests::CreateStackTest(Game* game)
@@ -160,6 +152,90 @@ void Tests::CreateStackTest(Game* game)
 	CreateSphere(game, 1.0, 1.0, dVec3(0.0, 0.0, -0.08), dQuat::Identity(), fVec3(1.0f, 0.0f, 0.0f), fVec3(1.0f, 0.0f, 0.0f));
 }
 
+void Tests::CreateTriangleMeshTest(Game* game)
+{
+	// A 32 x 32 floor tessellated into 0.25 x 0.25 quads (32768 triangles), with its top at the height of the other tests'
+	// floors. It's drawn as a thin box just under it.
+
+	const int nQuads = 128;
+	const float quadSize = 0.25f;
+	const float halfSize = 0.5f*quadSize*(float)nQuads;
+
+	std::vector<fVec3> verts;
+	verts.reserve((nQuads + 1)*(nQuads + 1));
+	for (int i = 0; i <= nQuads; ++i)
+	{
+		for (int j = 0; j <= nQuads; ++j)
+		{
+			verts.push_back(fVec3(quadSize*(float)i - halfSize, quadSize*(float)j - halfSize, 0.0f));
+		}
+	}
+	std::vector<int> indices;
+	indices.reserve(6 * nQuads*nQuads);
+	for (int i = 0; i < nQuads; ++i)
+	{
+		for (int j = 0; j < nQuads; ++j)
+		{
+			const int v00 = i*(nQuads + 1) + j;
+			const int v10 = v00 + nQuads + 1;
+			const int quad[6] = { v00, v10, v10 + 1, v00, v10 + 1, v00 + 1 };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+
+	TriangleMesh* geom = new TriangleMesh;
+	geom->Create(verts.data(), (int)verts.size(), indices.data(), (int)indices.size() / 3);
+
+	RenderObject* renderObj = new RenderObject;
+	renderObj->SetRenderMesh(game->m_renderMeshLibrary.GetBox(halfSize, halfSize, 0.5f, 2, 2, 2, fVec3(1.0f, 1.0f, 1.0f), fVec3(1.0f, 1.0f, 1.0f)));
+	renderObj->SetShader(nullptr);
+
+	RigidBody* body = new RigidBody;
+	body->SetGeometry(geom, dVec3(0.0, 0.0, 0.0), dQuat::Identity());
+	body->SetMass(0.0);
+	body->SetInertia(dMat33::Identity().Scale(0.0));
+	body->SetPosition(dVec3(0.0, 0.0, -15.0));
+	body->SetRotation(dQuat::Identity());
+
+	GameObject* gameObject = new GameObject;
+	gameObject->SetPhysicsObject(body);
+	gameObject->SetRenderObject(renderObj);
+	gameObject->m_renderPosOffset = fVec3(0.0f, 0.0f, -0.5f);
+	game->AddGameObject(gameObject);
+
+	// Boxes pushed across the grid lines, straight and at an angle, a sphere rolling across them, and a box at rest
+
+	RigidBody* box = CreateBox(game, fVec3(0.5f, 0.5f, 0.5f), 1.0, dVec3(-15.3, -5.2, -14.5), dQuat::Identity(), fVec3(1.0f, 0.0f, 0.0f), fVec3(1.0f, 0.0f, 0.0f));
+	box->ApplyImpulseAtCOM(dVec3(8.0, 0.0, 0.0));
+	box = CreateBox(game, fVec3(0.5f, 0.5f, 0.5f), 1.0, dVec3(-15.3, -12.2, -14.5), dQuat(dVec3(0.0, 0.0, 1.0), 0.3), fVec3(1.0f, 0.0f, 0.0f), fVec3(1.0f, 0.0f, 0.0f));
+	box->ApplyImpulseAtCOM(dVec3(7.0, 3.5, 0.0));
+
+	RigidBody* sphere = CreateSphere(game, 0.5, 1.0, dVec3(-15.3, 5.2, -14.5), dQuat::Identity(), fVec3(1.0f, 0.0f, 0.0f), fVec3(1.0f, 0.0f, 0.0f));
+	sphere->ApplyImpulseAtCOM(dVec3(6.0, 0.7, 0.0));
+	CreateBox(game, fVec3(0.5f, 0.5f, 0.5f), 1.0, dVec3(3.0, 3.0, -14.4), dQuat::Identity(), fVec3(1.0f, 0.0f, 0.0f), fVec3(1.0f, 0.0f, 0.0f));
+}
+
+void Tests::CreateThinWallTest(Game* game)
+{
+	CreateBox(game, fVec3(32.0, 32.0, 1.0), 0.0, dVec3(0.0, 0.0, -16.0), dQuat::Identity(), fVec3(1.0f, 1.0f, 1.0f), fVec3(1.0f, 1.0f, 1.0f));
+	CreateBox(game, fVec3(0.05f, 8.0f, 4.0f), 0.0, dVec3(0.0, 0.0, -11.0), dQuat::Identity(), fVec3(1.0f, 1.0f, 1.0f), fVec3(1.0f, 1.0f, 1.0f));
+
+	const double speeds[2] = { 300.0, 1000.0 };
+	const double starts[2] = { -3.0, -40.0 };
+	double y = -6.0;
+	for (int i = 0; i < 2; ++i)
+	{
+		for (int j = 0; j < 2; ++j)
+		{
+			RigidBody* sphere = CreateSphere(game, 0.1, 1.0, dVec3(starts[j], y, -12.0), dQuat::Identity(), fVec3(1.0f, 0.0f, 0.0f), fVec3(1.0f, 0.0f, 0.0f));
+			sphere->ApplyImpulseAtCOM(dVec3(speeds[i], 0.0, 0.0));
+			RigidBody* box = CreateBox(game, fVec3(0.1f, 0.1f, 0.1f), 1.0, dVec3(starts[j], y + 1.5, -12.0), dQuat::Identity(), fVec3(1.0f, 0.0f, 0.0f), fVec3(1.0f, 0.0f, 0.0f));
+			box->ApplyImpulseAtCOM(dVec3(speeds[i], 0.0, 0.0));
+			y += 3.0;
+		}
+	}
+}
+
 void Tests::CreateBVTest(Game* game)
 {
 	dVec3 sceneCenter = dVec3(0.0, 0.0, 0.0);
@@ -254,9 +330,7 @@ void Tests::CreateBVTest(Game* game)
 void Tests::CreateGJKTest(Game* game)
 {
 	Shader_Default* shader = new Shader_Default;
-	Capsule* geometry = new Capsule;
-	geometry->SetRadius(1.0);
-	geometry->SetHalfHeight(1.0);
+	const Capsule* geometry = game->m_geometryLibrary.GetCapsule(1.0, 1.0);
 //	Box* geometry = new Box;
 //	geometry->SetDimensions(1.0, 1.0, 1.0);
 
@@ -269,8 +343,7 @@ void Tests::CreateGJKTest(Game* game)
 	
 	for (int i = 0; i < 2; ++i)
 	{
-		RenderMesh* mesh = new RenderMesh;
-		mesh->CreateCapsule(1.0f, 1.0f, fVec3(1.0f, 1.0f, 1.0f), fVec3(1.0f, 1.0f, 1.0f));
+		RenderMesh* mesh = game->m_renderMeshLibrary.GetCapsule(1.0f, 1.0f, fVec3(1.0f, 1.0f, 1.0f), fVec3(1.0f, 1.0f, 1.0f));
 //		mesh->CreateBox(1.0f, 1.0f, 1.0f, 0, 0, 0, fVec3(1.0f, 1.0f, 1.0f));
 		RenderObject* renderObj = new RenderObject;
 		renderObj->SetRenderMesh(mesh);
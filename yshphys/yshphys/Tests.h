@@ -6,10 +6,17 @@ namespace Tests
 	void CreateCylinder(Game* game, double radius, double halfHeight, double mass, const dVec3& position, const dQuat& rotation, const fVec3& diffuse, const fVec3& specular);
 	void CreateCapsule(Game* game, double radius, double halfHeight, double mass, const dVec3& position, const dQuat& rotation, const fVec3& diffuse, const fVec3& specular);
 	void CreateCone(Game* game, double radius, double height, double mass, const dVec3& position, const dQuat& rotation, const fVec3& diffuse, const fVec3& specular);
-	void CreateSphere(Game* game, double radius, double mass, const dVec3& position, const dQuat& rotation, const fVec3& diffuse, const fVec3& specular);
-	void CreateBox(Game* game, const fVec3& halfDim, double mass, const dVec3& position, const dQuat& rotation, const fVec3& diffuse, const fVec3& specular);
+	RigidBody* CreateSphere(Game* game, double radius, double mass, const dVec3& position, const dQuat& rotation, const fVec3& diffuse, const fVec3& specular);
+	RigidBody* CreateBox(Game* game, const fVec3& halfDim, double mass, const dVec3& position, const dQuat& rotation, const fVec3& diffuse, const fVec3& specular);
 
 	void CreateBVTest(Game* game);
 	void CreateGJKTest(Game* game);
 	void CreateStackTest(Game* game);
+	// Boxes sliding and a sphere rolling across a finely tessellated TriangleMesh floor. With the internal edges of the
+	// floor corrected (see Triangle::CorrectInternalNormal), the sliding boxes shouldn't snag on its edges and tumble.
+	void CreateTriangleMeshTest(Game* game);
+	// Small spheres and boxes fired at a 0.1 thick wall at up to 1000 m/s, some from a few metres away and some from a long
+	// run-up. They move many times their own size and the wall's thickness per step, so each should be stopped against
+	// the near face of the wall by a speculative contact, and none should end up in or behind it.
+	void CreateThinWallTest(Game* game);
 };
\ No newline at end of file
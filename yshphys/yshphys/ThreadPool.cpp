@@ -0,0 +1,101 @@
+#include "stdafx.h"
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int nWorkers) :
+	m_task(nullptr),
+	m_nTasks(0),
+	m_nextTask(0),
+	m_nBusyWorkers(0),
+	m_generation(0),
+	m_quit(false)
+{
+	assert(nWorkers >= 0);
+	m_workers.reserve(nWorkers);
+	for (int i = 0; i < nWorkers; ++i)
+	{
+		m_workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+int ThreadPool::GetNumThreads() const
+{
+	return (int)m_workers.size() + 1;
+}
+
+void ThreadPool::RunTasks()
+{
+	int iTask;
+	while ((iTask = m_nextTask.fetch_add(1)) < m_nTasks)
+	{
+		(*m_task)(iTask);
+	}
+}
+
+void ThreadPool::WorkerLoop()
+{
+	unsigned int generation = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [&]() { return m_quit || m_generation != generation; });
+			if (m_quit)
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+
+		RunTasks();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (--m_nBusyWorkers == 0)
+			{
+				m_done.notify_one();
+			}
+		}
+	}
+}
+
+void ThreadPool::ParallelFor(int nTasks, const std::function<void(int iTask)>& task)
+{
+	if (m_workers.empty() || nTasks <= 1)
+	{
+		for (int i = 0; i < nTasks; ++i)
+		{
+			task(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		assert(m_nBusyWorkers == 0);
+		m_task = &task;
+		m_nTasks = nTasks;
+		m_nextTask = 0;
+		m_nBusyWorkers = (int)m_workers.size();
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	RunTasks();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [&]() { return m_nBusyWorkers == 0; });
+	m_task = nullptr;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// A fixed set of worker threads for data-parallel loops. ParallelFor hands out task indices to the workers and
+// to the calling thread, and returns once every task has run. Only one ParallelFor may run at a time.
+
+class ThreadPool
+{
+public:
+	// nWorkers threads are created in addition to the calling thread. With 0 workers, everything runs on the caller.
+	explicit ThreadPool(int nWorkers);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator = (const ThreadPool&) = delete;
+
+	// The number of threads that run tasks, including the calling thread
+	int GetNumThreads() const;
+
+	void ParallelFor(int nTasks, const std::function<void(int iTask)>& task);
+
+private:
+	void WorkerLoop();
+	void RunTasks();
+
+	std::vector<std::thread> m_workers;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+
+	const std::function<void(int)>* m_task;
+	int m_nTasks;
+	std::atomic<int> m_nextTask;
+	int m_nBusyWorkers;
+	unsigned int m_generation; // incremented by every ParallelFor, so that sleeping workers know there's new work
+	bool m_quit;
+};
@@ -0,0 +1,192 @@
+#include "stdafx.h"
+#include "Triangle.h"
+#include "Ray.h"
+
+Triangle::Triangle() : m_normal(0.0, 0.0, 1.0), m_internalEdges(0)
+{
+	m_verts[0] = dVec3(0.0, 0.0, 0.0);
+	m_verts[1] = dVec3(0.0, 0.0, 0.0);
+	m_verts[2] = dVec3(0.0, 0.0, 0.0);
+}
+
+Triangle::~Triangle()
+{
+}
+
+void Triangle::SetVertices(const dVec3& a, const dVec3& b, const dVec3& c, unsigned int internalEdges)
+{
+	m_verts[0] = a;
+	m_verts[1] = b;
+	m_verts[2] = c;
+	m_internalEdges = internalEdges;
+
+	const dVec3 n = (b - a).Cross(c - a);
+	const double nn = n.Dot(n);
+	assert(nn > 0.0);
+	m_normal = n.Scale(1.0 / sqrt(nn));
+
+	for (int dim = 0; dim < 3; ++dim)
+	{
+		m_localOOBB.min[dim] = std::min(a[dim], std::min(b[dim], c[dim]));
+		m_localOOBB.max[dim] = std::max(a[dim], std::max(b[dim], c[dim]));
+	}
+}
+
+bool Triangle::IsInternalEdge(const dVec3& a, const dVec3& b, const dVec3& c, const dVec3& w)
+{
+	const dVec3 nt = (b - a).Cross(c - a);
+	const dVec3 nu = (a - b).Cross(w - b);
+	const double cosAngle = nt.Dot(nu) / sqrt(nt.Dot(nt)*nu.Dot(nu));
+	if (cosAngle > TRIANGLE_FLAT_EDGE_COS)
+	{
+		return true;
+	}
+	// The neighbour bends up above the front of abc at a concave edge
+	return (w - a).Dot(nt) > 0.0;
+}
+
+const dVec3& Triangle::GetVertex(int i) const
+{
+	return m_verts[i];
+}
+
+const dVec3& Triangle::GetNormal() const
+{
+	return m_normal;
+}
+
+dVec3 Triangle::SupportLocal(const dVec3& v) const
+{
+	const double d0 = m_verts[0].Dot(v);
+	const double d1 = m_verts[1].Dot(v);
+	const double d2 = m_verts[2].Dot(v);
+	if (d0 >= d1 && d0 >= d2)
+	{
+		return m_verts[0];
+	}
+	return d1 >= d2 ? m_verts[1] : m_verts[2];
+}
+
+int Triangle::SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const
+{
+	if (maxVerts < 3)
+	{
+		return Geometry::SupportFeatureLocal(v, verts, maxVerts);
+	}
+
+	const double vLength = sqrt(v.Dot(v));
+
+	// Either side of the triangle is its face. The contact clipping decides whether it's aligned well enough to be used.
+	if (abs(v.Dot(m_normal)) >= SUPPORTFEATURE_PARALLEL_TOL*vLength)
+	{
+		verts[0] = m_verts[0];
+		verts[1] = m_verts[1];
+		verts[2] = m_verts[2];
+		return 3;
+	}
+
+	// Seen edge-on: the two most extreme vertices form the support edge if they're (nearly) level along v
+	double d[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		d[i] = m_verts[i].Dot(v);
+	}
+	int i0 = 0;
+	if (d[1] > d[i0]) { i0 = 1; }
+	if (d[2] > d[i0]) { i0 = 2; }
+	const int j = (i0 + 1) % 3;
+	const int k = (i0 + 2) % 3;
+	const int i1 = d[j] > d[k] ? j : k;
+
+	verts[0] = m_verts[i0];
+	const dVec3 e = m_verts[i1] - m_verts[i0];
+	if (d[i0] - d[i1] <= SUPPORTFEATURE_PARALLEL_TOL*vLength*sqrt(e.Dot(e)))
+	{
+		verts[1] = m_verts[i1];
+		return 2;
+	}
+	return 1;
+}
+
+bool Triangle::RayIntersect(const dVec3& pos, const dQuat& rot, const Ray& ray, dVec3& hit) const
+{
+	// Moller-Trumbore, in the local frame
+	const dVec3 o = (-rot).Transform(ray.GetOrigin() - pos);
+	const dVec3 dir = (-rot).Transform(ray.GetDirection());
+
+	const dVec3 e0 = m_verts[1] - m_verts[0];
+	const dVec3 e1 = m_verts[2] - m_verts[0];
+	const dVec3 p = dir.Cross(e1);
+	const double det = e0.Dot(p);
+	if (abs(det) < DBL_EPSILON)
+	{
+		return false;
+	}
+	const double detInv = 1.0 / det;
+
+	const dVec3 s = o - m_verts[0];
+	const double u = s.Dot(p)*detInv;
+	if (u < 0.0 || u > 1.0)
+	{
+		return false;
+	}
+	const dVec3 q = s.Cross(e0);
+	const double v = dir.Dot(q)*detInv;
+	if (v < 0.0 || u + v > 1.0)
+	{
+		return false;
+	}
+	const double t = e1.Dot(q)*detInv;
+	if (t < 0.0 || t > ray.GetLength())
+	{
+		return false;
+	}
+	hit = ray.GetOrigin() + ray.GetDirection().Scale(t);
+	return true;
+}
+
+bool Triangle::CorrectInternalNormal(const dVec3& x, dVec3& n) const
+{
+	if (m_internalEdges == 0 || n.Dot(m_normal) < 0.0)
+	{
+		return false;
+	}
+
+	const dVec3 e0 = m_verts[1] - m_verts[0];
+	const dVec3 e1 = m_verts[2] - m_verts[0];
+	const dVec3 d = x - m_verts[0];
+	const double d00 = e0.Dot(e0);
+	const double d01 = e0.Dot(e1);
+	const double d11 = e1.Dot(e1);
+	const double d20 = d.Dot(e0);
+	const double d21 = d.Dot(e1);
+	const double denom = d00*d11 - d01*d01;
+	if (denom <= 0.0)
+	{
+		return false;
+	}
+
+	double bary[3];
+	bary[1] = (d11*d20 - d01*d21) / denom;
+	bary[2] = (d00*d21 - d01*d20) / denom;
+	bary[0] = 1.0 - bary[1] - bary[2];
+
+	// Edge i is opposite vertex i + 2
+	int nEdges = 0;
+	bool internal = true;
+	for (int i = 0; i < 3; ++i)
+	{
+		if (bary[(i + 2) % 3] < TRIANGLE_FEATURE_TOL)
+		{
+			nEdges++;
+			internal = internal && (m_internalEdges & (1 << i)) != 0;
+		}
+	}
+	if (nEdges == 0 || !internal)
+	{
+		return false;
+	}
+
+	n = m_normal;
+	return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Geometry.h"
+
+// Barycentric coordinates below this are on the boundary of the triangle (see CorrectInternalNormal)
+#define TRIANGLE_FEATURE_TOL 0.001
+// The edge between two triangles whose normals are within this cosine of each other is flat
+#define TRIANGLE_FLAT_EDGE_COS 0.9998
+
+// A single (two-sided) triangle. On its own it's a convex geometry like any other; the triangles of a TriangleMesh are
+// handed to the narrowphase one at a time as Triangles, along with which of their edges are internal to the mesh.
+
+class Triangle :
+	public Geometry
+{
+public:
+	Triangle();
+	virtual ~Triangle();
+
+	// The front of the triangle is the side from which its vertices are counterclockwise. Edge i runs from vertex i to
+	// vertex i + 1, and bit i of internalEdges is set if it's shared with a neighbour that continues the surface
+	// without a convex corner, as seen from the front (the two are coplanar, or the neighbour bends up into a concave edge).
+	void SetVertices(const dVec3& a, const dVec3& b, const dVec3& c, unsigned int internalEdges = 0);
+
+	// Whether the edge from a to b of the (counterclockwise) triangle abc is internal, given the vertex w of the neighbour
+	// across it (the neighbour being the counterclockwise triangle baw)
+	static bool IsInternalEdge(const dVec3& a, const dVec3& b, const dVec3& c, const dVec3& w);
+
+	const dVec3& GetVertex(int i) const;
+	const dVec3& GetNormal() const;
+
+	virtual dVec3 SupportLocal(const dVec3& v) const;
+	virtual int SupportFeatureLocal(const dVec3& v, dVec3* verts, int maxVerts) const;
+
+	virtual bool RayIntersect(const dVec3& pos, const dQuat& rot, const Ray& ray, dVec3& hitPt) const;
+
+	// A shape resting across an internal edge of a mesh touches the edge itself, and GJK/EPA report a normal that's tilted
+	// towards the edge, which snags sliding shapes and bumps rolling ones. If x (local frame, on the triangle) lies on an
+	// internal edge, or on a vertex whose edges are both internal, and n (local frame, pointing out of the triangle) points
+	// out of the front, n is replaced by the face normal. Returns true if n was changed.
+	bool CorrectInternalNormal(const dVec3& x, dVec3& n) const;
+
+	virtual EGeomType GetType() const { return EGeomType::TRIANGLE; }
+
+protected:
+	dVec3 m_verts[3];
+	dVec3 m_normal;
+	unsigned int m_internalEdges;
+};
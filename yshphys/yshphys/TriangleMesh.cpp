@@ -0,0 +1,347 @@
+#include "stdafx.h"
+#include "TriangleMesh.h"
+#include "Ray.h"
+
+namespace
+{
+	bool Overlaps(const fVec3& min, const fVec3& max, const BoundingBox& box)
+	{
+		return
+			min.x <= box.max.x && max.x >= box.min.x &&
+			min.y <= box.max.y && max.y >= box.min.y &&
+			min.z <= box.max.z && max.z >= box.min.z;
+	}
+
+	fVec3 Min(const fVec3& a, const fVec3& b)
+	{
+		return fVec3(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z));
+	}
+
+	fVec3 Max(const fVec3& a, const fVec3& b)
+	{
+		return fVec3(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z));
+	}
+}
+
+TriangleMesh::TriangleMesh()
+{
+	m_localOOBB.min = dVec3(0.0, 0.0, 0.0);
+	m_localOOBB.max = dVec3(0.0, 0.0, 0.0);
+}
+
+TriangleMesh::~TriangleMesh()
+{
+}
+
+void TriangleMesh::Create(const fVec3* verts, int nVerts, const int* indices, int nTriangles)
+{
+	m_verts.assign(verts, verts + nVerts);
+	m_triangles.clear();
+	m_nodes.clear();
+
+	for (int i = 0; i < nTriangles; ++i)
+	{
+		Tri tri;
+		tri.internalEdges = 0;
+		for (int j = 0; j < 3; ++j)
+		{
+			tri.v[j] = indices[3 * i + j];
+			assert(tri.v[j] >= 0 && tri.v[j] < nVerts);
+		}
+		const dVec3 a(m_verts[tri.v[0]]);
+		const dVec3 n = (dVec3(m_verts[tri.v[1]]) - a).Cross(dVec3(m_verts[tri.v[2]]) - a);
+		if (n.Dot(n) > 0.0)
+		{
+			m_triangles.push_back(tri);
+		}
+	}
+
+	if (m_triangles.empty())
+	{
+		m_localOOBB.min = dVec3(0.0, 0.0, 0.0);
+		m_localOOBB.max = dVec3(0.0, 0.0, 0.0);
+		return;
+	}
+
+	FindInternalEdges();
+
+	std::vector<fVec3> centroids(m_triangles.size());
+	std::vector<int> order(m_triangles.size());
+	for (int i = 0; i < (int)m_triangles.size(); ++i)
+	{
+		const Tri& tri = m_triangles[i];
+		centroids[i] = (m_verts[tri.v[0]] + m_verts[tri.v[1]] + m_verts[tri.v[2]]).Scale(1.0f / 3.0f);
+		order[i] = i;
+	}
+
+	m_nodes.reserve(2 * m_triangles.size() / TRIANGLEMESH_BVH_LEAF_SIZE + 1);
+	BuildNode(0, (int)m_triangles.size(), order, centroids);
+
+	std::vector<Tri> sorted(m_triangles.size());
+	for (int i = 0; i < (int)order.size(); ++i)
+	{
+		sorted[i] = m_triangles[order[i]];
+	}
+	m_triangles.swap(sorted);
+
+	m_localOOBB.min = dVec3(m_nodes[0].min);
+	m_localOOBB.max = dVec3(m_nodes[0].max);
+}
+
+void TriangleMesh::FindInternalEdges()
+{
+	// Pair up the triangles sharing each edge by sorting the edges by their (unordered) vertices
+
+	struct EdgeRef
+	{
+		int a, b; // a < b
+		int iTri;
+		int iEdge;
+		bool operator < (const EdgeRef& e) const { return a < e.a || (a == e.a && b < e.b); }
+	};
+
+	std::vector<EdgeRef> edges;
+	edges.reserve(3 * m_triangles.size());
+	for (int i = 0; i < (int)m_triangles.size(); ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			const int a = m_triangles[i].v[j];
+			const int b = m_triangles[i].v[(j + 1) % 3];
+			EdgeRef e;
+			e.a = std::min(a, b);
+			e.b = std::max(a, b);
+			e.iTri = i;
+			e.iEdge = j;
+			edges.push_back(e);
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+
+	// Whether the edge of t is internal, given the neighbour u across it
+	auto IsInternal = [&](const EdgeRef& et, const EdgeRef& eu)
+	{
+		const Tri& t = m_triangles[et.iTri];
+		const Tri& u = m_triangles[eu.iTri];
+		return Triangle::IsInternalEdge(
+			dVec3(m_verts[t.v[et.iEdge]]), dVec3(m_verts[t.v[(et.iEdge + 1) % 3]]), dVec3(m_verts[t.v[(et.iEdge + 2) % 3]]),
+			dVec3(m_verts[u.v[(eu.iEdge + 2) % 3]]));
+	};
+
+	for (int i = 0; i < (int)edges.size();)
+	{
+		int j = i + 1;
+		while (j < (int)edges.size() && edges[j].a == edges[i].a && edges[j].b == edges[i].b)
+		{
+			j++;
+		}
+		// Edges shared by more than two triangles (or by two that are wound inconsistently) are left alone
+		if (j - i == 2 && m_triangles[edges[i].iTri].v[edges[i].iEdge] != m_triangles[edges[i + 1].iTri].v[edges[i + 1].iEdge])
+		{
+			if (IsInternal(edges[i], edges[i + 1]))
+			{
+				m_triangles[edges[i].iTri].internalEdges |= 1 << edges[i].iEdge;
+			}
+			if (IsInternal(edges[i + 1], edges[i]))
+			{
+				m_triangles[edges[i + 1].iTri].internalEdges |= 1 << edges[i + 1].iEdge;
+			}
+		}
+		i = j;
+	}
+}
+
+int TriangleMesh::BuildNode(int iFirst, int n, std::vector<int>& order, const std::vector<fVec3>& centroids)
+{
+	const int iNode = (int)m_nodes.size();
+	m_nodes.push_back(BVHNode());
+
+	BVHNode node;
+	node.min = m_verts[m_triangles[order[iFirst]].v[0]];
+	node.max = node.min;
+	fVec3 cMin = centroids[order[iFirst]];
+	fVec3 cMax = cMin;
+	for (int i = iFirst; i < iFirst + n; ++i)
+	{
+		const Tri& tri = m_triangles[order[i]];
+		for (int j = 0; j < 3; ++j)
+		{
+			node.min = Min(node.min, m_verts[tri.v[j]]);
+			node.max = Max(node.max, m_verts[tri.v[j]]);
+		}
+		cMin = Min(cMin, centroids[order[i]]);
+		cMax = Max(cMax, centroids[order[i]]);
+	}
+
+	if (n <= TRIANGLEMESH_BVH_LEAF_SIZE)
+	{
+		node.index = iFirst;
+		node.nTriangles = n;
+		m_nodes[iNode] = node;
+		return iNode;
+	}
+
+	// Split in half along the longest axis of the centroids, which keeps the tree balanced
+	const fVec3 span = cMax - cMin;
+	int axis = 0;
+	if (span.y > span[axis]) { axis = 1; }
+	if (span.z > span[axis]) { axis = 2; }
+
+	const int half = n / 2;
+	std::nth_element(order.begin() + iFirst, order.begin() + iFirst + half, order.begin() + iFirst + n,
+		[&](int a, int b) { return centroids[a][axis] < centroids[b][axis]; });
+
+	BuildNode(iFirst, half, order, centroids);
+	node.index = BuildNode(iFirst + half, n - half, order, centroids);
+	node.nTriangles = 0;
+	m_nodes[iNode] = node;
+	return iNode;
+}
+
+int TriangleMesh::GetNTriangles() const
+{
+	return (int)m_triangles.size();
+}
+
+void TriangleMesh::GetTriangle(int i, Triangle& tri) const
+{
+	const Tri& t = m_triangles[i];
+	tri.SetVertices(dVec3(m_verts[t.v[0]]), dVec3(m_verts[t.v[1]]), dVec3(m_verts[t.v[2]]), t.internalEdges);
+}
+
+template <class Visitor>
+void TriangleMesh::VisitTriangles(const BoundingBox& box, const Visitor& visit) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	int stack[TRIANGLEMESH_BVH_MAX_DEPTH];
+	int nStack = 0;
+	int iNode = 0;
+	while (true)
+	{
+		const BVHNode& node = m_nodes[iNode];
+		if (Overlaps(node.min, node.max, box))
+		{
+			if (node.nTriangles == 0)
+			{
+				assert(nStack < TRIANGLEMESH_BVH_MAX_DEPTH);
+				stack[nStack++] = node.index;
+				iNode++;
+				continue;
+			}
+			for (int i = node.index; i < node.index + node.nTriangles; ++i)
+			{
+				const Tri& tri = m_triangles[i];
+				const fVec3& a = m_verts[tri.v[0]];
+				const fVec3& b = m_verts[tri.v[1]];
+				const fVec3& c = m_verts[tri.v[2]];
+				if (Overlaps(Min(a, Min(b, c)), Max(a, Max(b, c)), box))
+				{
+					visit(i);
+				}
+			}
+		}
+		if (nStack == 0)
+		{
+			break;
+		}
+		iNode = stack[--nStack];
+	}
+}
+
+void TriangleMesh::QueryTriangles(const BoundingBox& box, std::vector<int>& triangles) const
+{
+	VisitTriangles(box, [&](int i) { triangles.push_back(i); });
+}
+
+void TriangleMesh::ForEachPart(const BoundingBox& localBounds, const PartCallback& f) const
+{
+	Triangle tri;
+	VisitTriangles(localBounds, [&](int i)
+	{
+		GetTriangle(i, tri);
+		f(i, &tri, dVec3(0.0, 0.0, 0.0), dQuat::Identity());
+	});
+}
+
+dVec3 TriangleMesh::SupportLocal(const dVec3& v) const
+{
+	assert(!m_verts.empty());
+	const fVec3 vf(v);
+	int iBest = 0;
+	float dBest = m_verts[0].Dot(vf);
+	for (int i = 1; i < (int)m_verts.size(); ++i)
+	{
+		const float d = m_verts[i].Dot(vf);
+		if (d > dBest)
+		{
+			iBest = i;
+			dBest = d;
+		}
+	}
+	return dVec3(m_verts[iBest]);
+}
+
+bool TriangleMesh::RayIntersect(const dVec3& pos, const dQuat& rot, const Ray& ray, dVec3& hit) const
+{
+	if (m_nodes.empty())
+	{
+		return false;
+	}
+
+	Ray r;
+	r.SetOrigin((-rot).Transform(ray.GetOrigin() - pos));
+	r.SetDirection((-rot).Transform(ray.GetDirection()));
+	r.SetLength(ray.GetLength());
+
+	const dVec3 o = r.GetOrigin();
+	const dVec3 dir = r.GetDirection();
+	double tBest = DBL_MAX;
+
+	Triangle tri;
+	int stack[TRIANGLEMESH_BVH_MAX_DEPTH];
+	int nStack = 0;
+	int iNode = 0;
+	while (true)
+	{
+		const BVHNode& node = m_nodes[iNode];
+		AABB aabb;
+		aabb.min = dVec3(node.min) - dVec3(1.0, 1.0, 1.0).Scale(TRIANGLEMESH_RAY_PADDING);
+		aabb.max = dVec3(node.max) + dVec3(1.0, 1.0, 1.0).Scale(TRIANGLEMESH_RAY_PADDING);
+		double tIn, tOut;
+		if (r.IntersectAABB(aabb, tIn, tOut) && tOut >= 0.0 && tIn < tBest)
+		{
+			if (node.nTriangles == 0)
+			{
+				assert(nStack < TRIANGLEMESH_BVH_MAX_DEPTH);
+				stack[nStack++] = node.index;
+				iNode++;
+				continue;
+			}
+			for (int i = node.index; i < node.index + node.nTriangles; ++i)
+			{
+				GetTriangle(i, tri);
+				dVec3 x;
+				if (tri.RayIntersect(dVec3(0.0, 0.0, 0.0), dQuat::Identity(), r, x))
+				{
+					tBest = std::min(tBest, (x - o).Dot(dir) / dir.Dot(dir));
+				}
+			}
+		}
+		if (nStack == 0)
+		{
+			break;
+		}
+		iNode = stack[--nStack];
+	}
+
+	if (tBest == DBL_MAX)
+	{
+		return false;
+	}
+	hit = ray.GetOrigin() + ray.GetDirection().Scale(tBest);
+	return true;
+}
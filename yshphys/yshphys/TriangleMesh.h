@@ -0,0 +1,75 @@
+#pragma once
+#include "Geometry.h"
+#include "Triangle.h"
+
+#define TRIANGLEMESH_BVH_LEAF_SIZE 4
+#define TRIANGLEMESH_BVH_MAX_DEPTH 64
+// Rays are tested against the BVH nodes padded by this distance, since the nodes of flat regions have no thickness
+#define TRIANGLEMESH_RAY_PADDING 0.0001
+
+// A concave (static) mesh of triangles, e.g. the level geometry, which is a single broadphase leaf no matter how many
+// triangles it has. Internally, the triangles are sorted into a BVH, and the narrowphase collides convex geometries
+// with the triangles near them one at a time (see Geometry::ForEachPart).
+//
+// The BVH is compact: a flat array of 32 byte nodes in depth first order, so the first child of an internal node is the
+// node right after it, and each leaf holds a run of up to TRIANGLEMESH_BVH_LEAF_SIZE triangles (sorted into BVH order).
+//
+// The edges that are internal to the surface (shared by two triangles, and flat or concave) are flagged, so the contact
+// normals found against them can be corrected (see Triangle::CorrectInternalNormal). For this, the triangles must be
+// wound counterclockwise as seen from the front, the side that shapes are meant to rest on.
+
+class TriangleMesh :
+	public Geometry
+{
+public:
+	TriangleMesh();
+	virtual ~TriangleMesh();
+
+	// Copies the vertices and the triangles (3 vertex indices each), finds the internal edges, and builds the BVH.
+	// Degenerate triangles are dropped.
+	void Create(const fVec3* verts, int nVerts, const int* indices, int nTriangles);
+
+	int GetNTriangles() const;
+	// Sets tri to triangle i (in BVH order) and its internal edges
+	void GetTriangle(int i, Triangle& tri) const;
+
+	// Appends the triangles (in BVH order) whose bounds overlap box (local frame)
+	void QueryTriangles(const BoundingBox& box, std::vector<int>& triangles) const;
+
+	// The support of the whole mesh. Nothing should run GJK on the mesh itself, so this is just brute force.
+	virtual dVec3 SupportLocal(const dVec3& v) const;
+
+	virtual bool RayIntersect(const dVec3& pos, const dQuat& rot, const Ray& ray, dVec3& hitPt) const;
+
+	virtual bool IsConcave() const { return true; }
+	virtual void ForEachPart(const BoundingBox& localBounds, const PartCallback& f) const;
+
+	virtual EGeomType GetType() const { return EGeomType::TRIANGLEMESH; }
+
+private:
+	struct Tri
+	{
+		int v[3];
+		unsigned int internalEdges; // bit i is set if the edge from v[i] to v[i+1] is internal
+	};
+
+	struct BVHNode
+	{
+		fVec3 min;
+		fVec3 max;
+		int index; // a leaf's first triangle, or an internal node's second child
+		int nTriangles; // zero for internal nodes
+	};
+
+	// Builds the subtree over the triangles [iFirst, iFirst + n) and returns the index of its root
+	int BuildNode(int iFirst, int n, std::vector<int>& order, const std::vector<fVec3>& centroids);
+
+	void FindInternalEdges();
+
+	template <class Visitor>
+	void VisitTriangles(const BoundingBox& box, const Visitor& visit) const;
+
+	std::vector<fVec3> m_verts;
+	std::vector<Tri> m_triangles;
+	std::vector<BVHNode> m_nodes;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+// Hands the latest of a stream of values from one producer thread to one consumer thread without locking.
+// Each side owns one of three buffers, and the third holds the latest published value. Publish swaps the producer's
+// buffer with it, and Acquire swaps it with the consumer's buffer if it's newer, so neither side ever waits on the other.
+// Values that are published faster than they're acquired are skipped.
+
+template <class T>
+class TripleBuffer
+{
+public:
+	TripleBuffer() : m_back(0), m_ready(1), m_front(2) {}
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator = (const TripleBuffer&) = delete;
+
+	// Producer. The back buffer holds whatever was published three values ago, so it has to be overwritten in full.
+	T& Back() { return m_buffers[m_back]; }
+	void Publish()
+	{
+		m_back = m_ready.exchange(m_back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+	}
+
+	// Consumer. Returns false (and keeps the current front buffer) if nothing was published since the last call.
+	bool Acquire()
+	{
+		if ((m_ready.load(std::memory_order_relaxed) & FRESH) == 0)
+		{
+			return false;
+		}
+		m_front = m_ready.exchange(m_front, std::memory_order_acq_rel) & ~FRESH;
+		return true;
+	}
+	const T& Front() const { return m_buffers[m_front]; }
+
+private:
+	enum { FRESH = 4 }; // flags the ready buffer as not yet acquired
+
+	T m_buffers[3];
+	int m_back;
+	std::atomic<int> m_ready;
+	int m_front;
+};
@@ -8,23 +8,22 @@ public:
 	// FUNCTIONS //
 	///////////////
 
-	Vec2_t();
-	Vec2_t(T x_, T y_);
-	template <class S> Vec2_t(const Vec2_t<S>& v);
-	virtual ~Vec2_t();
+	Vec2_t() = default; // Leave unitialized for efficiency
+	constexpr Vec2_t(T x_, T y_) : x(x_), y(y_) {}
+	template <class S> constexpr Vec2_t(const Vec2_t<S>& v) : x((T)v.x), y((T)v.y) {}
 
 	void GetData(T* const components) const;
 	void SetData(const T* const components);
 
-	T Dot(const Vec2_t<T>& v) const;
-	Vec2_t<T> Scale(T x) const;
-	Vec2_t<T> Times(const Vec2_t<T>& v) const; // Componentwise multiplication
+	constexpr T Dot(const Vec2_t<T>& v) const { return x*v.x + y*v.y; }
+	constexpr Vec2_t<T> Scale(T k) const { return Vec2_t<T>(k*x, k*y); }
+	constexpr Vec2_t<T> Times(const Vec2_t<T>& v) const { return Vec2_t<T>(x*v.x, y*v.y); } // Componentwise multiplication
 
-	Vec2_t<T> operator + (const Vec2_t<T>& v) const;
-	Vec2_t<T> operator - (const Vec2_t<T>& v) const;
-	Vec2_t<T> operator - () const;
-	bool operator == (const Vec2_t<T>& v) const;
-	bool operator != (const Vec2_t<T>& v) const;
+	constexpr Vec2_t<T> operator + (const Vec2_t<T>& v) const { return Vec2_t<T>(x + v.x, y + v.y); }
+	constexpr Vec2_t<T> operator - (const Vec2_t<T>& v) const { return Vec2_t<T>(x - v.x, y - v.y); }
+	constexpr Vec2_t<T> operator - () const { return Vec2_t<T>(-x, -y); }
+	constexpr bool operator == (const Vec2_t<T>& v) const { return x == v.x && y == v.y; }
+	constexpr bool operator != (const Vec2_t<T>& v) const { return x != v.x || y != v.y; }
 
 	T operator [] (int i) const;
 	T& operator [] (int i);
@@ -35,3 +34,47 @@ public:
 
 	T x, y;
 };
+
+template <class T>
+inline void Vec2_t<T>::GetData(T* const components) const
+{
+	components[0] = x;
+	components[1] = y;
+}
+
+template <class T>
+inline void Vec2_t<T>::SetData(const T* const components)
+{
+	x = components[0];
+	y = components[1];
+}
+
+template <class T>
+inline T Vec2_t<T>::operator [] (int i) const
+{
+	switch (i)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	default:
+		assert(false);
+		return x;
+	}
+}
+
+template <class T>
+inline T& Vec2_t<T>::operator [] (int i)
+{
+	switch (i)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	default:
+		assert(false);
+		return x;
+	}
+}
@@ -1,6 +1,9 @@
 #pragma once
 #include "YshMath.h"
 
+// Vec3_t is a plain aggregate of three scalars: no vtable, trivially copyable, and sized exactly 3*sizeof(T).
+// Everything that sits on the hot path is defined inline below so that the compiler can see through it.
+
 template<class T> class Vec3_t
 {
 public:
@@ -8,25 +11,24 @@ public:
 	// FUNCTIONS //
 	///////////////
 
-	Vec3_t();
-	Vec3_t(T x_, T y_, T z_);
+	Vec3_t() = default; // Leave unitialized for efficiency
+	constexpr Vec3_t(T x_, T y_, T z_) : x(x_), y(y_), z(z_) {}
 	Vec3_t(const Vec4_t<T>& v4);
-	template <class S> Vec3_t(const Vec3_t<S>& v);
-	virtual ~Vec3_t();
+	template <class S> constexpr Vec3_t(const Vec3_t<S>& v) : x((T)v.x), y((T)v.y), z((T)v.z) {}
 
 	void GetData(T* const components) const;
 	void SetData(const T* const components);
 
-	T Dot(const Vec3_t<T>& v) const;
-	Vec3_t<T> Cross(const Vec3_t<T>& v) const;
-	Vec3_t<T> Scale(T x) const;
-	Vec3_t<T> Times(const Vec3_t<T>& v) const; // Componentwise multiplication
+	constexpr T Dot(const Vec3_t<T>& v) const { return x*v.x + y*v.y + z*v.z; }
+	constexpr Vec3_t<T> Cross(const Vec3_t<T>& v) const { return Vec3_t<T>(y*v.z - z*v.y, z*v.x - x*v.z, x*v.y - y*v.x); }
+	constexpr Vec3_t<T> Scale(T k) const { return Vec3_t<T>(k*x, k*y, k*z); }
+	constexpr Vec3_t<T> Times(const Vec3_t<T>& v) const { return Vec3_t<T>(x*v.x, y*v.y, z*v.z); } // Componentwise multiplication
 
-	Vec3_t<T> operator + (const Vec3_t<T>& v) const;
-	Vec3_t<T> operator - (const Vec3_t<T>& v) const;
-	Vec3_t<T> operator - () const;
-	bool operator == (const Vec3_t<T>& v) const;
-	bool operator != (const Vec3_t<T>& v) const;
+	constexpr Vec3_t<T> operator + (const Vec3_t<T>& v) const { return Vec3_t<T>(x + v.x, y + v.y, z + v.z); }
+	constexpr Vec3_t<T> operator - (const Vec3_t<T>& v) const { return Vec3_t<T>(x - v.x, y - v.y, z - v.z); }
+	constexpr Vec3_t<T> operator - () const { return Vec3_t<T>(-x, -y, -z); }
+	constexpr bool operator == (const Vec3_t<T>& v) const { return x == v.x && y == v.y && z == v.z; }
+	constexpr bool operator != (const Vec3_t<T>& v) const { return x != v.x || y != v.y || z != v.z; }
 
 	T operator [] (int i) const;
 	T& operator [] (int i);
@@ -37,3 +39,53 @@ public:
 
 	T x, y, z;
 };
+
+template <class T>
+inline void Vec3_t<T>::GetData(T* const components) const
+{
+	components[0] = x;
+	components[1] = y;
+	components[2] = z;
+}
+
+template <class T>
+inline void Vec3_t<T>::SetData(const T* const components)
+{
+	x = components[0];
+	y = components[1];
+	z = components[2];
+}
+
+template <class T>
+inline T Vec3_t<T>::operator [] (int i) const
+{
+	switch (i)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	case 2:
+		return z;
+	default:
+		assert(false);
+		return x;
+	}
+}
+
+template <class T>
+inline T& Vec3_t<T>::operator [] (int i)
+{
+	switch (i)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	case 2:
+		return z;
+	default:
+		assert(false);
+		return x;
+	}
+}
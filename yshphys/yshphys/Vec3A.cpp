@@ -0,0 +1,9 @@
+#include "stdafx.h"
+#include "Vec3A.h"
+
+template class Vec3A_t<float>;
+template class Vec3A_t<double>;
+
+static_assert(sizeof(fVec3A) == 4 * sizeof(float), "fVec3A must fill exactly one SSE register");
+static_assert(alignof(fVec3A) == 16, "fVec3A must be 16-byte aligned");
+static_assert(std::is_trivially_copyable<dVec3A>::value, "dVec3A must be trivially copyable");
@@ -0,0 +1,81 @@
+#pragma once
+#include "YshMath.h"
+
+// Vec3A_t is a Vec3_t padded out to four lanes and aligned to a full SSE register, so that arrays of them can be
+// streamed through SIMD code without any shuffling on load or store. The padding lane is kept at zero by every
+// operation; use it for tight inner loops and convert back to Vec3_t at the boundaries.
+
+template<class T> class alignas(16) Vec3A_t
+{
+public:
+	///////////////
+	// FUNCTIONS //
+	///////////////
+
+	Vec3A_t() = default; // Leave unitialized for efficiency
+	constexpr Vec3A_t(T x_, T y_, T z_) : x(x_), y(y_), z(z_), pad(T(0.0)) {}
+	constexpr Vec3A_t(const Vec3_t<T>& v) : x(v.x), y(v.y), z(v.z), pad(T(0.0)) {}
+
+	constexpr Vec3_t<T> ToVec3() const { return Vec3_t<T>(x, y, z); }
+
+	constexpr T Dot(const Vec3A_t<T>& v) const { return x*v.x + y*v.y + z*v.z; }
+	constexpr Vec3A_t<T> Cross(const Vec3A_t<T>& v) const { return Vec3A_t<T>(y*v.z - z*v.y, z*v.x - x*v.z, x*v.y - y*v.x); }
+	constexpr Vec3A_t<T> Scale(T k) const { return Vec3A_t<T>(k*x, k*y, k*z); }
+
+	constexpr Vec3A_t<T> operator + (const Vec3A_t<T>& v) const { return Vec3A_t<T>(x + v.x, y + v.y, z + v.z); }
+	constexpr Vec3A_t<T> operator - (const Vec3A_t<T>& v) const { return Vec3A_t<T>(x - v.x, y - v.y, z - v.z); }
+	constexpr Vec3A_t<T> operator - () const { return Vec3A_t<T>(-x, -y, -z); }
+
+	///////////////
+	// VARIABLES //
+	///////////////
+
+	T x, y, z;
+	T pad;
+};
+
+#if YSH_SIMD_SSE
+
+template <>
+inline float Vec3A_t<float>::Dot(const Vec3A_t<float>& v) const
+{
+	return _mm_cvtss_f32(Simd::HorizontalSum(_mm_mul_ps(_mm_load_ps(&x), _mm_load_ps(&v.x))));
+}
+
+template <>
+inline Vec3A_t<float> Vec3A_t<float>::Cross(const Vec3A_t<float>& v) const
+{
+	// a x b = (a * b.yzx - a.yzx * b).yzx; the padding lane stays at zero
+	const __m128 a = _mm_load_ps(&x);
+	const __m128 b = _mm_load_ps(&v.x);
+	const __m128 c = _mm_sub_ps(_mm_mul_ps(a, YSH_SWIZZLE(b, 1, 2, 0, 3)), _mm_mul_ps(YSH_SWIZZLE(a, 1, 2, 0, 3), b));
+	Vec3A_t<float> product;
+	_mm_store_ps(&product.x, YSH_SWIZZLE(c, 1, 2, 0, 3));
+	return product;
+}
+
+template <>
+inline Vec3A_t<float> Vec3A_t<float>::Scale(float k) const
+{
+	Vec3A_t<float> product;
+	_mm_store_ps(&product.x, _mm_mul_ps(_mm_load_ps(&x), _mm_set1_ps(k)));
+	return product;
+}
+
+template <>
+inline Vec3A_t<float> Vec3A_t<float>::operator + (const Vec3A_t<float>& v) const
+{
+	Vec3A_t<float> sum;
+	_mm_store_ps(&sum.x, _mm_add_ps(_mm_load_ps(&x), _mm_load_ps(&v.x)));
+	return sum;
+}
+
+template <>
+inline Vec3A_t<float> Vec3A_t<float>::operator - (const Vec3A_t<float>& v) const
+{
+	Vec3A_t<float> difference;
+	_mm_store_ps(&difference.x, _mm_sub_ps(_mm_load_ps(&x), _mm_load_ps(&v.x)));
+	return difference;
+}
+
+#endif
@@ -8,20 +8,19 @@ public:
 	// FUNCTIONS //
 	///////////////
 
-	Vec4_t();
-	Vec4_t(T x_, T y_, T z_, T w_);
-	Vec4_t(const Vec3_t<T>& v3);
-	virtual ~Vec4_t();
+	Vec4_t() = default; // Leave unitialized for efficiency
+	constexpr Vec4_t(T x_, T y_, T z_, T w_) : x(x_), y(y_), z(z_), w(w_) {}
+	constexpr Vec4_t(const Vec3_t<T>& v3) : x(v3.x), y(v3.y), z(v3.z), w(T(1.0)) {}
 
-	T Dot(const Vec4_t<T>& v) const;
-	Vec4_t<T> Scale(T x) const;
-	Vec4_t<T> Times(const Vec4_t<T>& v) const; // Componentwise multiplication
+	constexpr T Dot(const Vec4_t<T>& v) const { return x*v.x + y*v.y + z*v.z + w*v.w; }
+	constexpr Vec4_t<T> Scale(T k) const { return Vec4_t<T>(k*x, k*y, k*z, k*w); }
+	constexpr Vec4_t<T> Times(const Vec4_t<T>& v) const { return Vec4_t<T>(x*v.x, y*v.y, z*v.z, w*v.w); } // Componentwise multiplication
 
-	Vec4_t<T> operator + (const Vec4_t<T>& v) const;
-	Vec4_t<T> operator - (const Vec4_t<T>& v) const;
-	Vec4_t<T> operator - () const;
-	bool operator == (const Vec4_t<T>& v) const;
-	bool operator != (const Vec4_t<T>& v) const;
+	constexpr Vec4_t<T> operator + (const Vec4_t<T>& v) const { return Vec4_t<T>(x + v.x, y + v.y, z + v.z, w + v.w); }
+	constexpr Vec4_t<T> operator - (const Vec4_t<T>& v) const { return Vec4_t<T>(x - v.x, y - v.y, z - v.z, w - v.w); }
+	constexpr Vec4_t<T> operator - () const { return Vec4_t<T>(-x, -y, -z, -w); }
+	constexpr bool operator == (const Vec4_t<T>& v) const { return x == v.x && y == v.y && z == v.z && w == v.w; }
+	constexpr bool operator != (const Vec4_t<T>& v) const { return x != v.x || y != v.y || z != v.z || w != v.w; }
 
 	T operator [] (int i) const;
 	T& operator [] (int i);
@@ -32,3 +31,83 @@ public:
 
 	T x, y, z, w;
 };
+
+template <class T>
+inline T Vec4_t<T>::operator [] (int i) const
+{
+	switch (i)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	case 2:
+		return z;
+	case 3:
+		return w;
+	default:
+		assert(false);
+		return x;
+	}
+}
+
+template <class T>
+inline T& Vec4_t<T>::operator [] (int i)
+{
+	switch (i)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	case 2:
+		return z;
+	case 3:
+		return w;
+	default:
+		assert(false);
+		return x;
+	}
+}
+
+#if YSH_SIMD_SSE
+
+template <>
+inline float Vec4_t<float>::Dot(const Vec4_t<float>& v) const
+{
+	return _mm_cvtss_f32(Simd::HorizontalSum(_mm_mul_ps(Simd::Load(&x), Simd::Load(&v.x))));
+}
+
+template <>
+inline Vec4_t<float> Vec4_t<float>::Scale(float k) const
+{
+	Vec4_t<float> product;
+	Simd::Store(&product.x, _mm_mul_ps(Simd::Load(&x), _mm_set1_ps(k)));
+	return product;
+}
+
+template <>
+inline Vec4_t<float> Vec4_t<float>::Times(const Vec4_t<float>& v) const
+{
+	Vec4_t<float> product;
+	Simd::Store(&product.x, _mm_mul_ps(Simd::Load(&x), Simd::Load(&v.x)));
+	return product;
+}
+
+template <>
+inline Vec4_t<float> Vec4_t<float>::operator + (const Vec4_t<float>& v) const
+{
+	Vec4_t<float> sum;
+	Simd::Store(&sum.x, _mm_add_ps(Simd::Load(&x), Simd::Load(&v.x)));
+	return sum;
+}
+
+template <>
+inline Vec4_t<float> Vec4_t<float>::operator - (const Vec4_t<float>& v) const
+{
+	Vec4_t<float> difference;
+	Simd::Store(&difference.x, _mm_sub_ps(Simd::Load(&x), Simd::Load(&v.x)));
+	return difference;
+}
+
+#endif
@@ -22,9 +22,8 @@ void Viewport::SetPos(const fVec3& pos)
 
 fMat44 Viewport::CreateViewMatrix() const
 {
-	const fMat44 R_inv(fHomogeneousTransformation::CreateRotation(-m_rot));
-	const fMat44 T_inv(fHomogeneousTransformation::CreateTranslation(-m_pos));
-	return R_inv*T_inv;
+	const fQuat q_inv(-m_rot);
+	return fHomogeneousTransformation::CreateRigidTransform(q_inv, -q_inv.Transform(m_pos));
 }
 
 fMat44 Viewport::CreateProjectionMatrix() const
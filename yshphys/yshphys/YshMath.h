@@ -14,6 +14,10 @@ template <typename> class Vec4_t;
 typedef Vec4_t<float> fVec4;
 typedef Vec4_t<double> dVec4;
 
+template <typename> class Vec3A_t;
+typedef Vec3A_t<float> fVec3A;
+typedef Vec3A_t<double> dVec3A;
+
 template <typename> class Quat_t;
 typedef Quat_t<float> fQuat;
 typedef Quat_t<double> dQuat;
@@ -41,9 +45,11 @@ typedef HomogeneousTransformation_t<double> dHomogeneousTransformation;
 // relevant template data-types (specifically <float> and <double>). Anything that wishes to use the math library
 // merely needs to include this file YshPhys.h
 
+#include "Simd.h"
 #include "Vec2.h"
 #include "Vec3.h"
 #include "Vec4.h"
+#include "Vec3A.h"
 #include "Quat.h"
 #include "Mat22.h"
 #include "Mat33.h"
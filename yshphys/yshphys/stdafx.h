@@ -24,6 +24,14 @@
 #include <set>
 
 #include <limits>
+#include <type_traits>
+#include <cstring>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 
 // TODO: reference additional headers your program requires here
@@ -15,11 +15,19 @@
 #include "Game.h"
 #include "Capsule.h"
 #include "Tests.h"
+#include "Benchmarks.h"
 #include "Picker.h"
 #include "CameraPickerToggle.h"
 
 int main(int argc, char *args[])
 {
+	if (argc > 1 && std::strcmp(args[1], "-bench") == 0)
+	{
+		Benchmarks::RunMathBenchmarks();
+		Benchmarks::RunPhysicsBenchmarks();
+		return 0;
+	}
+
 	Window window;
 	window.CreateWindow(88, 88, 1200, 900);
 
@@ -37,6 +45,7 @@ int main(int argc, char *args[])
 	game.m_inputManager.AddInputHandler(&toggle);
 	game.m_renderScene.AttachCamera(&camera);
 	game.m_window = &window;
+	game.SetPipelined(argc > 1 && std::strcmp(args[1], "-pipelined") == 0);
 
 	PointLight pl;
 	pl.intensity = fVec3(1.0f, 1.0f, 1.0f).Scale(2.0f);